@@ -32,8 +32,19 @@ class PDB
   //! @param PDB file name.
   //! @return A PDB object.
   PDB(const std::string& s);
+  PDB(const PDB&) = default;
+  PDB(PDB&&) = default;
   virtual ~PDB() {v_models_.clear();}
 
+  //! @brief Read a PDB file through its binary cache (see PDBCache).
+  //!
+  //! If the ".pdbcache" file of the PDB file is up to date, the models are
+  //! loaded from it without parsing; otherwise the PDB file is parsed and the
+  //! cache is (re-)written.  The result is the same as PDB(s).
+  //! @param PDB file name.
+  //! @return A PDB object.
+  static PDB load_cached(const std::string&);
+
   //! @brief Get PDB file name.
   //! @return PDB file name.
   std::string get_pdb_name() const { return PDB_file_name_; }
@@ -42,11 +53,23 @@ class PDB
   //! @param Index of the model.
   //! @return A Model object.
   Model& get_model(unsigned int);
+  //! @brief Get access to a model in a PDB structure (read only).
+  //! @param Index of the model.
+  //! @return A Model object.
+  const Model& get_model(unsigned int) const;
+  //! @brief Get all the models in PDB.
+  const std::vector<Model>& get_models() const { return v_models_; }
 
   //! @brief Get the number of models in PDB.
   //! @return Number of models.
   int get_size() const { return n_model_; }
 
+  //! @brief Iterators over the models, e.g. for (const Model& m : pdb).
+  std::vector<Model>::iterator begin() { return v_models_.begin(); }
+  std::vector<Model>::iterator end() { return v_models_.end(); }
+  std::vector<Model>::const_iterator begin() const { return v_models_.begin(); }
+  std::vector<Model>::const_iterator end() const { return v_models_.end(); }
+
   //! @brief Print sequence of whole PDB.
   //! @param Option to output short style (1) or full name (3).
   void output_sequence(int) const;
@@ -56,8 +79,12 @@ class PDB
 
   //! @brief Output PDB format information to ostream.
   friend std::ostream& operator<<(std::ostream&, PDB&);
+  friend class PDBCache;
 
  protected:
+  //! @brief Create an "empty" PDB object, to be filled by PDBCache.
+  PDB(): n_model_(0) {}
+
   std::string PDB_file_name_;  //!< PDB flie name.
   std::vector<Model> v_models_;  //!< A collection of model objects in PDB file.
   int n_model_;                //!< Number of models in PDB flie.
@@ -0,0 +1,183 @@
+/*!
+  @file analysis_stage.hpp
+  @brief Analysis stages of the single-pass trajectory pipeline.
+
+  In this file class AnalysisStage and its derived classes are defined.  Each
+  stage does the same analysis as one of the cafedcd_* tools (with the same
+  per-frame functions, see frame_analysis.hpp), but frames are fed to it one
+  by one, so that several stages can share one pass over the trajectory.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 12:53
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_ANALYSIS_STAGE_H_
+#define PINANG_ANALYSIS_STAGE_H_
+
+#include <map>
+#include <memory>
+#include "dcd_reader.hpp"
+#include "topology.hpp"
+#include "frame_analysis.hpp"
+#include "ff_protein_DNA_specific.hpp"
+
+namespace pinang {
+
+/*!
+  @brief Base class of analysis stages.
+
+  A stage is set up from the Selection keywords in an input file and a set of
+  key=value options.  If option "prefix" is given, the keywords are prefixed
+  with it (e.g. "A_TRAN_REF"), so that several stages of the same type can
+  share one input file.  Each stage writes its own output file.
+*/
+class AnalysisStage
+{
+ public:
+  AnalysisStage() {}
+  virtual ~AnalysisStage() { out_file_.close(); }
+
+  //! @brief Set up the stage.
+  //! @param Input file with Selection keywords.
+  //! @param Options (key=value).
+  //! @param Topology of the system.
+  //! @return Status of setting up the stage.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  virtual int setup(const std::string&, const std::map<std::string, std::string>&, Topology&) = 0;
+  //! @brief Open the output file.
+  //! @param Output file name.
+  //! @return Status of opening output file.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int open_output(const std::string&);
+
+  //! @brief Check if the stage needs all atoms of each frame.
+  virtual bool needs_all_atoms() const { return false; }
+  //! @brief Get Selections of atoms read from the dcd frames.
+  virtual std::vector<Selection> get_selections() const = 0;
+  //! @brief Translate Selections to indices in frames decoded by a DcdReader.
+  virtual void map_selections(const DcdReader&) = 0;
+  //! @brief Analyse a frame and write the result.
+  //! @param Frame index.
+  //! @param Conformation of the frame.
+  //! @return Status of analysing the frame.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  virtual int analyze(int, Conformation&) = 0;
+
+ protected:
+  std::ofstream out_file_;  //!< Output file.
+};
+
+//! @brief RMSD after superimposition (see cafedcd_rmsd).
+//!
+//! Keywords: TRAN_REF, TRAN_OBJ, RMSD_REF, RMSD_OBJ.  Option "ref" gives a
+//! reference structure (crd); by default the first frame is the reference.
+class RmsdStage : public AnalysisStage
+{
+ public:
+  int setup(const std::string&, const std::map<std::string, std::string>&, Topology&);
+  std::vector<Selection> get_selections() const;
+  void map_selections(const DcdReader&);
+  int analyze(int, Conformation&);
+
+ protected:
+  Selection sel_tran_ref_;   //!< Superimposition group of reference.
+  Selection sel_tran_obj_;   //!< Superimposition group of object.
+  Selection sel_rmsd_ref_;   //!< RMSD group of reference.
+  Selection sel_rmsd_obj_;   //!< RMSD group of object.
+  Conformation conf_ref_;    //!< Reference structure.
+  bool ref_flag_;            //!< Reference structure is read from file.
+  bool ref_set_;             //!< Reference structure is set up in superposer_.
+  Superposer superposer_;    //!< Superimposition onto the reference.
+  CoordinateArray<double> rmsd_ref_;  //!< RMSD group of reference.
+  RmsdScratch scratch_;      //!< Scratch objects.
+};
+
+//! @brief Angle between two COM vectors (see cafedcd_angle).
+//!
+//! Keywords: VA1, VA2, VB1, VB2.
+class AngleStage : public AnalysisStage
+{
+ public:
+  int setup(const std::string&, const std::map<std::string, std::string>&, Topology&);
+  std::vector<Selection> get_selections() const;
+  void map_selections(const DcdReader&);
+  int analyze(int, Conformation&);
+
+ protected:
+  Selection sel_[4];                //!< Groups of VA1, VA2, VB1, VB2.
+  std::vector<double> masses_[4];   //!< Masses of the groups.
+};
+
+//! @brief Minimum distance from LIG (COM) to REC (see cafedcd_distance_lig_rec).
+//!
+//! Keywords: LIG, REC.
+class DistanceStage : public AnalysisStage
+{
+ public:
+  int setup(const std::string&, const std::map<std::string, std::string>&, Topology&);
+  std::vector<Selection> get_selections() const;
+  void map_selections(const DcdReader&);
+  int analyze(int, Conformation&);
+
+ protected:
+  Selection sel_lig_;               //!< Ligand.
+  Selection sel_rec_;               //!< Receptor.
+  std::vector<double> masses_lig_;  //!< Masses of ligand.
+};
+
+//! @brief Interface residues between LIG and REC (see cafedcd_interface_lig_rec).
+//!
+//! Keywords: LIG, REC.  Option "cutoff" gives the contact cutoff (10.0).
+class InterfaceStage : public AnalysisStage
+{
+ public:
+  int setup(const std::string&, const std::map<std::string, std::string>&, Topology&);
+  std::vector<Selection> get_selections() const;
+  void map_selections(const DcdReader&);
+  int analyze(int, Conformation&);
+
+ protected:
+  Selection sel_lig_;       //!< Ligand (indices in the system).
+  Selection sel_rec_;       //!< Receptor (indices in the system).
+  Selection sel_lig_dcd_;   //!< Ligand (indices in decoded frames).
+  Selection sel_rec_dcd_;   //!< Receptor (indices in decoded frames).
+  double contact_cutoff_;   //!< Contact distance cutoff.
+  double com_cutoff_;       //!< Cutoff of COM distance; estimated from the first frame.
+  VerletList pair_list_;    //!< Receptor-ligand pairs, reused across frames.
+};
+
+//! @brief Protein-DNA sequence specific energy (see cafedcd_Ep).
+//!
+//! Options: "ffp" (force field file, required), "shift", "scale".
+class EnergyStage : public AnalysisStage
+{
+ public:
+  int setup(const std::string&, const std::map<std::string, std::string>&, Topology&);
+  bool needs_all_atoms() const { return true; }
+  std::vector<Selection> get_selections() const { return std::vector<Selection>(); }
+  void map_selections(const DcdReader&) {}
+  int analyze(int, Conformation&);
+
+ protected:
+  FFProteinDNASpecific ff_ss_;  //!< Force field parameters.
+  VerletList pair_list_;        //!< Protein-DNA pairs, reused across frames.
+  Topology* top_;               //!< Topology of the system.
+};
+
+//! @brief Create an analysis stage from a line of pipeline configuration.
+//!
+//! The line has the form "<type> <output> [key=value ...]", where type is one of
+//! rmsd, angle, distance, interface and Ep.
+//! @param Configuration line (after "ANALYSIS:").
+//! @param Input file with Selection keywords.
+//! @param Topology of the system.
+//! @return Pointer to the stage; empty if failed.
+std::unique_ptr<AnalysisStage> create_analysis_stage(const std::string&, const std::string&, Topology&);
+
+}
+
+#endif
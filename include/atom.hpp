@@ -14,11 +14,14 @@
 #define PINANG_ATOM_H_
 
 #include "vec3d.hpp"
+#include "fixed_name.hpp"
 
 #include <string>
 
 namespace pinang {
 
+class PDBCache;
+
 /*!
   @brief Physical atomistic type, with properties in the PDB format.
 
@@ -37,10 +40,10 @@ class Atom
 
   //! @brief Get the "ATOM  " record keyword in PDB.
   //! @return Record word.
-  std::string get_record_name() const { return record_name_; }
+  RecordName get_record_name() const { return record_name_; }
   //! @brief Set the "ATOM  " record keyword of atom.
   //! @param Record word.
-  void set_record_name(const std::string& s) { record_name_ = s; }
+  void set_record_name(RecordName s) { record_name_ = s; }
 
   //! @brief Get serial number of atom.
   //! @return Serial number of atom.
@@ -51,10 +54,10 @@ class Atom
 
   //! @brief Get atom name.
   //! @return Atom name.
-  std::string get_atom_name() const { return atom_name_; }
-  //! @brief Set atom name.
+  AtomName get_atom_name() const { return atom_name_; }
+  //! @brief Set atom name (padded with spaces to 4 characters).
   //! @param Atom name.
-  void set_atom_name(const std::string&);
+  void set_atom_name(AtomName s) { atom_name_ = s.padded(); }
 
   //! @brief Get alternate location indicator.
   //! @return Alternate location indicator.
@@ -65,10 +68,10 @@ class Atom
 
   //! @brief Get residue name.
   //! @return Residue name.
-  std::string get_residue_name() const { return residue_name_; }
-  //! @brief Set residue name.
+  ResidueName get_residue_name() const { return residue_name_; }
+  //! @brief Set residue name (padded with spaces to 3 characters).
   //! @param Residue name.
-  void set_residue_name(const std::string&);
+  void set_residue_name(ResidueName s) { residue_name_ = s.padded(); }
 
   //! @brief Get chain identifier.
   //! @return Chain identifier.
@@ -117,45 +120,46 @@ class Atom
 
   //! @brief Get segment identifier.
   //! @return Segment identifier.
-  std::string get_segment_ID() const { return seg_ID_; }
+  SegmentName get_segment_ID() const { return seg_ID_; }
   //! @brief Set segment identifier.
   //! @param Segment identifier.
-  void set_segment_ID(const std::string& s) { seg_ID_ = s; }
+  void set_segment_ID(SegmentName s) { seg_ID_ = s; }
 
   //! @brief Get element symbol.
   //! @return Element symbol.
-  std::string get_element() const { return element_; }
+  ElementName get_element() const { return element_; }
   //! @brief Set element symbol.
   //! @param Element symbol.
-  void set_element(const std::string& s) { element_ = s; }
+  void set_element(ElementName s) { element_ = s; }
 
   //! @brief Get atom charge.
   //! @return Atom charge.
-  std::string get_charge() const { return charge_; }
+  ChargeName get_charge() const { return charge_; }
   //! @brief Set atom charge.
   //! @param Atom charge.
-  void set_charge(const std::string& s) { charge_ = s; }
+  void set_charge(ChargeName s) { charge_ = s; }
 
   //! @brief Output PDB format information of Atom.
   friend std::ostream& operator<<(std::ostream&, const Atom&);
   //! @brief Read in PDB information to Atom.
   friend std::istream& operator>>(std::istream&, Atom&);
   friend double atom_distance (const Atom&, const Atom&);
+  friend class PDBCache;
  protected:
-  std::string record_name_;  //!< Atom flag from PDB.
+  RecordName record_name_;  //!< Atom flag from PDB.
   int atom_serial_;             //!< Atom serial number in PDB.
-  std::string atom_name_;  //!< Atom name in PDB.
+  AtomName atom_name_;     //!< Atom name in PDB.
   char alt_loc_;           //!< Alternate location indicator from PDB.
-  std::string residue_name_; //!< Residue name of the atom in PDB.
+  ResidueName residue_name_; //!< Residue name of the atom in PDB.
   char chain_ID_;          //!< Chain identifier in PDB.
   int residue_serial_;        //!< Residue sequence number in PDB.
   char insert_code_;       //!< Code for insertion of residues from PDB.
   Vec3d coordinate_;       //!< Orthogonal coordinates (x, y, z).
   double occupancy_;       //!< Occupancy from PDB.
   double temperature_factor_;     //!< Temperature factor in PDB.
-  std::string seg_ID_;     //!< Segment identifier in PDB.
-  std::string element_;    //!< Element symbol in PDB.
-  std::string charge_;     //!< Charge on the atom.
+  SegmentName seg_ID_;     //!< Segment identifier in PDB.
+  ElementName element_;    //!< Element symbol in PDB.
+  ChargeName charge_;      //!< Charge on the atom.
 };
 
 //! @brief Compute distance between two Atoms.
@@ -52,16 +52,33 @@ class Chain
   //! @param Serial number of the Residue.
   //! @return Residue.
   Residue& get_residue(int);
+  //! @brief Get a Residue object from Chain (read only).
+  //! @param Serial number of the Residue.
+  //! @return Residue.
+  const Residue& get_residue(int) const;
+  //! @brief Get all the Residue objects of Chain.
+  const std::vector<Residue>& get_residues() const { return v_residues_; }
   //! @brief Add a Residue object to Chain.
   //! @param Residue.
   //! @return Status of adding residues to chain.
   //! @retval 0: Success.
   int add_residue(const Residue&);
+  //! @brief Add a Residue object to Chain, moving it into Chain.
+  //! @param Residue.
+  //! @return Status of adding residues to chain.
+  //! @retval 0: Success.
+  int add_residue(Residue&&);
 
   //! @brief Get chain length (number of residues included).
   //! @return Chain length.
   int get_size() const { return n_residue_; }
 
+  //! @brief Iterators over the residues, e.g. for (const Residue& r : chain).
+  std::vector<Residue>::iterator begin() { return v_residues_.begin(); }
+  std::vector<Residue>::iterator end() { return v_residues_.end(); }
+  std::vector<Residue>::const_iterator begin() const { return v_residues_.begin(); }
+  std::vector<Residue>::const_iterator end() const { return v_residues_.end(); }
+
   //! @brief Print sequence of the Chain.
   //! @param Option to output short style (1) or full name (3).
   void output_sequence(int) const;
@@ -91,6 +108,12 @@ class Chain
   //! @brief Output dihedral angle interactions to forcefield parm file.
   void output_ffparm_dihedral(std::ostream&, int&);
 
+  //! @brief Get protein native contacts intra-chain.
+  //!
+  //! Residues i, j >= i + 4 are in contact if their minimal (heavy atom)
+  //! distance is below g_pro_pro_aa_cutoff.
+  //! @return Residue index pairs (i, j), sorted.
+  std::vector<std::pair<int, int> > get_protein_native_contacts();
   //! @brief Get protein native contact number intra-chain.
   //! @return Native contact number.
   int get_protein_native_contact_number();
@@ -102,6 +125,7 @@ class Chain
 
   //! @brief Output PDB format information of Chain.
   friend std::ostream& operator<<(std::ostream&, Chain&);
+  friend class PDBCache;
 
  protected:
   char chain_ID_;                  //!< Chain identifier in PDB.
@@ -0,0 +1,109 @@
+/*!
+  @file clustering.hpp
+  @brief Conformational clustering of trajectory frames.
+
+  In this file class ClusterResult is defined, together with GROMOS (cutoff)
+  clustering and k-medoids (PAM / CLARA) clustering.  Distances between frames
+  are given by a function, e.g. reading a cached RmsdMatrix or computing the
+  RMSD of CenteredFrames on demand.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:12
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_CLUSTERING_H_
+#define PINANG_CLUSTERING_H_
+
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace pinang {
+
+/*!
+  @brief Clusters of frames: label of each frame, medoid and population of each cluster.
+
+  Clusters are numbered from 0, in descending order of population.
+*/
+class ClusterResult
+{
+ public:
+  //! @brief Create an "empty" ClusterResult object.
+  //! @return A ClusterResult object.
+  ClusterResult() {}
+  virtual ~ClusterResult() {}
+
+  //! @brief Reset ClusterResult.
+  void reset();
+  //! @brief Set clusters from medoids and labels, and sort them by population.
+  //! @param Medoid (frame) of each cluster.
+  //! @param Cluster of each frame.
+  void set(const std::vector<int>&, const std::vector<int>&);
+
+  //! @brief Get number of clusters.
+  int get_cluster_number() const { return medoids_.size(); }
+  //! @brief Get number of frames.
+  int get_size() const { return labels_.size(); }
+  //! @brief Get cluster of frame k.
+  int get_label(int k) const { return labels_[k]; }
+  //! @brief Get medoid (frame) of cluster c.
+  int get_medoid(int c) const { return medoids_[c]; }
+  //! @brief Get number of frames in cluster c.
+  int get_population(int c) const { return populations_[c]; }
+
+  //! @brief Output clusters: index, medoid frame and population of each cluster.
+  //! @param Output stream.
+  //! @param Function translating frame k to the index in dcd file.
+  void write_clusters(std::ostream&, const std::function<int(int)>&) const;
+  //! @brief Output cluster of each frame.
+  //! @param Output stream.
+  //! @param Function translating frame k to the index in dcd file.
+  void write_labels(std::ostream&, const std::function<int(int)>&) const;
+
+ protected:
+  std::vector<int> labels_;       //!< Cluster of each frame.
+  std::vector<int> medoids_;      //!< Medoid of each cluster.
+  std::vector<int> populations_;  //!< Number of frames in each cluster.
+};
+
+//! @brief GROMOS clustering (Daura et al., 1999).
+//!
+//! Frames closer than the cutoff are neighbours.  The frame with the largest
+//! number of neighbours becomes a cluster center; it and its neighbours form a
+//! cluster and are removed from the pool.  This is repeated until all frames
+//! belong to a cluster.  All N (N - 1) / 2 distances are computed (in
+//! parallel), so the method is meant for moderate N.
+//! @param Number of frames.
+//! @param Distance between two frames, called from several threads.
+//! @param Cutoff distance.
+//! @param Number of threads.  Non-positive value means all cores.
+//! @param ClusterResult to be calculated.
+//! @return Status of clustering.
+//! @retval 1: Failure.
+//! @retval 0: Success.
+int cluster_gromos(int, const std::function<double(int, int)>&, double, int, ClusterResult&);
+
+//! @brief k-medoids clustering with PAM (BUILD + SWAP) on samples of frames (CLARA).
+//!
+//! For each of the repeats, a random sample of frames (including the best
+//! medoids so far) is clustered with PAM, and then all frames are assigned to
+//! the nearest medoid.  The medoids with the lowest total distance are kept.
+//! If the sample size is not smaller than N, PAM is run on all the frames.
+//! @param Number of frames.
+//! @param Distance between two frames, called from several threads.
+//! @param Number of clusters k.
+//! @param Number of threads.  Non-positive value means all cores.
+//! @param ClusterResult to be calculated.
+//! @param Sample size (non-positive: 40 + 2 k).
+//! @param Number of samples.
+//! @param Seed of random numbers.
+//! @return Status of clustering.
+//! @retval 1: Failure.
+//! @retval 0: Success.
+int cluster_kmedoids(int, const std::function<double(int, int)>&, int, int, ClusterResult&,
+                     int = 0, int = 5, unsigned = 0);
+
+}
+
+#endif
@@ -14,9 +14,13 @@
 #define PINANG_CONFORMATION_H
 
 #include "PDB.hpp"
+#include "coordinate_array.hpp"
 
 namespace pinang {
 
+class DcdReader;
+class DcdMappedReader;
+
 /*!
   @brief A certain configuration of a biomolecule.
 
@@ -43,6 +47,9 @@ class Conformation
 
   //! @brief Reset properties of Conformation.
   void reset();
+  //! @brief Exchange coordinates with another Conformation without copying.
+  //! @param The other Conformation.
+  void swap(Conformation&);
 
   //! @brief Get number of coordinates in Conformation.
   //! @return Number of coordinates in Conformation.
@@ -67,6 +74,15 @@ class Conformation
   //! @return Vec3d type coordinate.
   Vec3d& get_coordinate(int);
 
+  //! @brief Get a view of all the coordinates, without copying.
+  //!
+  //! The view has stride 3 and points into the storage of the Conformation, so
+  //! it is invalidated when the Conformation is resized.
+  //! @return CoordinateView of the coordinates.
+  CoordinateView<double> get_view() const;
+
+  friend class DcdReader;
+  friend class DcdMappedReader;
  protected:
   std::vector<Vec3d> coordinates_;  //!< A set of coordinate objects in a certain conformation.
   int n_atom_;                      //!< Number of coordinates in a conformation.
@@ -13,7 +13,6 @@
 #ifndef PINANG_CONSTANTS_H_
 #define PINANG_CONSTANTS_H_
 
-#include <map>
 #include <string>
 #include <iostream>
 
@@ -43,41 +42,63 @@ enum ChainType {none=0, protein=1, DNA=2, RNA=3, water=4, ion=5, other=6, na=7};
 //! @return Name of chain type
 std::string chainType_2_string(ChainType);
 
+//! @brief Pack a 3-character residue name into an integer.
+constexpr unsigned int residue_code(char a, char b, char c)
+{
+  return (unsigned int)(unsigned char)a << 16 | (unsigned int)(unsigned char)b << 8
+      | (unsigned int)(unsigned char)c;
+}
+//! @brief Pack a 3-character residue name literal (e.g. "DA ") into an integer.
+constexpr unsigned int residue_code(const char* s) { return residue_code(s[0], s[1], s[2]); }
+//! @brief Pack a 4-character atom name into an integer.
+constexpr unsigned int atom_code(char a, char b, char c, char d)
+{
+  return (unsigned int)(unsigned char)a << 24 | residue_code(b, c, d);
+}
+//! @brief Pack a 4-character atom name literal (e.g. "CA  ") into an integer.
+constexpr unsigned int atom_code(const char* s) { return atom_code(s[0], s[1], s[2], s[3]); }
+
+//! @brief Physical properties of a residue type.
+struct ResidueProperty
+{
+  unsigned int code;     //!< Packed residue name (see residue_code()).
+  char short_name[3];    //!< Short name, e.g. "aA", "dA".
+  ChainType chain_type;  //!< Chain type.
+  double mass;           //!< Mass.
+  double charge;         //!< Charge.
+};
+
+//! @brief Find properties of a residue.
+//! @param Residue name (3 characters, e.g. "ALA", "DA ").
+//! @return Properties, or nullptr if the residue is unknown.
+const ResidueProperty* get_residue_property(const std::string&);
+
 /*!
   @brief Some of the physical properties of biomolecules.
 
-  A collection of maps that can translate residue name into charges, masses and
-  chemical chain types.
+  Translate residue name into charges, masses and chemical chain types.  The
+  functions only look up the static residue table (get_residue_property()),
+  so creating a PhysicalProperty object costs nothing.
 */
 class PhysicalProperty
 {
  public:
-  //! @brief Create an "empty" PhysicalProperty object.
-  PhysicalProperty();
-  ~PhysicalProperty();
-
   //! @brief Translate residue name into short name.
   //! @param Residue name.
   //! @return Short name.
-  std::string get_short_name(const std::string&);
+  static std::string get_short_name(const std::string&);
   //! @brief Translate residue name into charge.
   //! @param Residue name.
   //! @return Charge.
-  double get_charge(const std::string&);
+  static double get_charge(const std::string&);
   //! @brief Translate residue name into mass.
   //! @param Residue name.
   //! @return Mass.
-  double get_mass(const std::string&);
+  static double get_mass(const std::string&);
   //! @brief Translate residue name into chain type.
   //! @param Residue name.
   //! @return Chain type.
-  ChainType get_chain_type(const std::string&);
-
- private:
-  std::map<std::string, std::string> map_resName_shortName;  //!< Mapping of residue name to short name.
-  std::map<std::string, double> map_resName_charge;          //!< Mapping of residue name to residue charge.
-  std::map<std::string, double> map_resName_mass;            //!< Mapping of residue name to residue mass.
-  std::map<std::string, ChainType> map_resName_chainType;    //!< Mapping of residue name to chain type.
+  static ChainType get_chain_type(const std::string&);
 };
 
 //! @brief Get classification of DNA atom position from residue name and atom name.
@@ -0,0 +1,235 @@
+/*!
+  @file coordinate_array.hpp
+  @brief Structure-of-arrays coordinate storage and geometric kernels.
+
+  In this file class templates CoordinateView and CoordinateArray are defined,
+  together with kernels computing centroid, center of mass, radius of gyration
+  and RMSD, and applying translation / rotation.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 12:58
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_COORDINATE_ARRAY_H_
+#define PINANG_COORDINATE_ARRAY_H_
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include "vec3d.hpp"
+#include "selection.hpp"
+
+namespace pinang {
+
+class Transform;
+
+/*!
+  @brief Allocator returning memory aligned to cache lines (64 bytes).
+*/
+template <typename T>
+class AlignedAllocator
+{
+ public:
+  typedef T value_type;
+  static const std::size_t alignment = 64;  //!< Alignment in bytes.
+
+  AlignedAllocator() {}
+  template <typename U> AlignedAllocator(const AlignedAllocator<U>&) {}
+
+  T* allocate(std::size_t n)
+  {
+    void* p = 0;
+    if (posix_memalign(&p, alignment, n * sizeof(T)) != 0)
+      throw std::bad_alloc();
+    return static_cast<T*>(p);
+  }
+  void deallocate(T* p, std::size_t) { free(p); }
+
+  template <typename U> struct rebind { typedef AlignedAllocator<U> other; };
+  bool operator==(const AlignedAllocator&) const { return true; }
+  bool operator!=(const AlignedAllocator&) const { return false; }
+};
+
+/*!
+  @brief Non-owning view of n coordinates stored as x[], y[], z[].
+
+  Element i is (x[i * stride], y[i * stride], z[i * stride]).  A
+  CoordinateArray is viewed with stride 1; a Conformation (array of Vec3d) is
+  viewed with stride 3, without copying.
+*/
+template <typename T>
+class CoordinateView
+{
+ public:
+  //! @brief Create an "empty" CoordinateView object.
+  CoordinateView(): x_(0), y_(0), z_(0), n_(0), stride_(1) {}
+  //! @brief Create a CoordinateView object.
+  //! @param Pointers to the first x, y, z components.
+  //! @param Number of coordinates.
+  //! @param Distance (in elements) between two coordinates.
+  CoordinateView(const T* x, const T* y, const T* z, int n, int stride = 1):
+      x_(x), y_(y), z_(z), n_(n), stride_(stride) {}
+
+  //! @brief Get number of coordinates.
+  int get_size() const { return n_; }
+  //! @brief Get distance (in elements) between two coordinates.
+  int get_stride() const { return stride_; }
+  //! @brief Get pointer to the x components.
+  const T* x() const { return x_; }
+  //! @brief Get pointer to the y components.
+  const T* y() const { return y_; }
+  //! @brief Get pointer to the z components.
+  const T* z() const { return z_; }
+  //! @brief Get a coordinate.
+  //! @param Index of the coordinate.
+  Vec3d get_coordinate(int i) const
+  {
+    return Vec3d(x_[i * stride_], y_[i * stride_], z_[i * stride_]);
+  }
+
+ protected:
+  const T* x_;  //!< x components.
+  const T* y_;  //!< y components.
+  const T* z_;  //!< z components.
+  int n_;       //!< Number of coordinates.
+  int stride_;  //!< Distance between two coordinates.
+};
+
+/*!
+  @brief Coordinates stored as three contiguous, aligned arrays x[], y[], z[].
+*/
+template <typename T>
+class CoordinateArray
+{
+ public:
+  //! @brief Create an "empty" CoordinateArray object.
+  CoordinateArray() {}
+  //! @brief Create a CoordinateArray object of n coordinates (all zero).
+  explicit CoordinateArray(int n): x_(n), y_(n), z_(n) {}
+  //! @brief Create a CoordinateArray object by copying a view.
+  template <typename U>
+  explicit CoordinateArray(const CoordinateView<U>& v) { assign(v); }
+
+  //! @brief Get number of coordinates.
+  int get_size() const { return x_.size(); }
+  //! @brief Change number of coordinates.
+  void resize(int n) { x_.resize(n); y_.resize(n); z_.resize(n); }
+
+  //! @brief Get pointer to the x components.
+  T* x() { return x_.data(); }
+  //! @brief Get pointer to the y components.
+  T* y() { return y_.data(); }
+  //! @brief Get pointer to the z components.
+  T* z() { return z_.data(); }
+  //! @brief Get pointer to the x components.
+  const T* x() const { return x_.data(); }
+  //! @brief Get pointer to the y components.
+  const T* y() const { return y_.data(); }
+  //! @brief Get pointer to the z components.
+  const T* z() const { return z_.data(); }
+
+  //! @brief Get a coordinate.
+  Vec3d get_coordinate(int i) const { return Vec3d(x_[i], y_[i], z_[i]); }
+  //! @brief Set a coordinate.
+  void set_coordinate(int i, const Vec3d& v) { x_[i] = v.x(); y_[i] = v.y(); z_[i] = v.z(); }
+
+  //! @brief Get a view of all the coordinates.
+  CoordinateView<T> get_view() const
+  {
+    return CoordinateView<T>(x_.data(), y_.data(), z_.data(), x_.size());
+  }
+
+  //! @brief Copy coordinates from a view.
+  template <typename U>
+  void assign(const CoordinateView<U>& v)
+  {
+    const int n = v.get_size();
+    const int s = v.get_stride();
+    resize(n);
+    for (int i = 0; i < n; ++i) {
+      x_[i] = v.x()[i * s];
+      y_[i] = v.y()[i * s];
+      z_[i] = v.z()[i * s];
+    }
+  }
+  //! @brief Copy selected coordinates from a view.
+  template <typename U>
+  void assign(const CoordinateView<U>& v, const Selection& sel)
+  {
+    const int n = sel.get_size();
+    const int s = v.get_stride();
+    resize(n);
+    for (int i = 0; i < n; ++i) {
+      int m = sel.get_selection(i) * s;
+      x_[i] = v.x()[m];
+      y_[i] = v.y()[m];
+      z_[i] = v.z()[m];
+    }
+  }
+
+ protected:
+  std::vector<T, AlignedAllocator<T> > x_;  //!< x components.
+  std::vector<T, AlignedAllocator<T> > y_;  //!< y components.
+  std::vector<T, AlignedAllocator<T> > z_;  //!< z components.
+};
+
+//! @brief Get the (geometric) centroid of coordinates.
+template <typename T>
+Vec3d get_centroid(const CoordinateView<T>&);
+//! @brief Get the center of mass of coordinates.
+//! @param Coordinates.
+//! @param A list of masses.
+template <typename T>
+Vec3d get_center_of_mass(const CoordinateView<T>&, const std::vector<double>&);
+//! @brief Get the radius of gyration of coordinates.
+template <typename T>
+double get_radius_of_gyration(const CoordinateView<T>&);
+//! @brief Get the RMSD between two sets of coordinates (without superimposition).
+template <typename T>
+double get_rmsd(const CoordinateView<T>&, const CoordinateView<T>&);
+//! @brief Get centroids and the inner product matrix of two sets of coordinates.
+//!
+//! All the sums are accumulated in a single pass.  With a and b centered at
+//! their centroids, M[3 * i + j] = sum(a_i * b_j) and G[0] = sum(|a|^2),
+//! G[1] = sum(|b|^2).
+//! @param Coordinates a.
+//! @param Coordinates b.
+//! @param Array of 9 real numbers to store M (row-major).
+//! @param Array of 2 real numbers to store G.
+//! @param Centroid of a (output).
+//! @param Centroid of b (output).
+template <typename T>
+void get_inner_product(const CoordinateView<T>&, const CoordinateView<T>&,
+                       double*, double*, Vec3d&, Vec3d&);
+//! @brief Get the inner product matrix of two sets of centered coordinates.
+//! @param Coordinates a, already centered at the origin.
+//! @param Coordinates b, already centered at the origin.
+//! @param Array of 9 real numbers to store M[3 * i + j] = sum(a_i * b_j).
+template <typename T>
+void get_inner_product(const CoordinateView<T>&, const CoordinateView<T>&, double*);
+//! @brief Get centroid of a, and the inner product matrix of a and centered coordinates b.
+//!
+//! With a centered at its centroid, M[3 * i + j] = sum(a_i * b_j) and
+//! G = sum(|a|^2).  b must already be centered at the origin (see Superposer).
+//! @param Coordinates a.
+//! @param Coordinates b, centered at the origin.
+//! @param Array of 9 real numbers to store M (row-major).
+//! @param G of a (output).
+//! @param Centroid of a (output).
+template <typename T>
+void get_inner_product(const CoordinateView<T>&, const CoordinateView<double>&,
+                       double*, double&, Vec3d&);
+//! @brief Translate all coordinates by a vector.
+template <typename T>
+void translate(CoordinateArray<T>&, const Vec3d&);
+//! @brief Rotate all coordinates with the rotation part of a Transform.
+template <typename T>
+void rotate(CoordinateArray<T>&, const Transform&);
+//! @brief Apply a Transform (rotation, then translation) to all coordinates.
+template <typename T>
+void apply_transform(CoordinateArray<T>&, const Transform&);
+
+}
+
+#endif
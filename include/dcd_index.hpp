@@ -0,0 +1,110 @@
+/*!
+  @file dcd_index.hpp
+  @brief Frame index of CafeMol style dcd files.
+
+  In this file class DcdIndex is defined.  A frame index records the byte offset
+  of every complete frame in a dcd file, and can be saved into a ".dcdidx"
+  sidecar file so that large trajectories are not scanned again.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 12:46
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_DCD_INDEX_H_
+#define PINANG_DCD_INDEX_H_
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace pinang {
+
+class DcdHeader;
+
+/*!
+  @brief Byte offsets of the frames in a dcd file.
+
+  The index is built by checking the record markers of each frame, so that a
+  truncated last frame is excluded.  The sidecar file stores frame count,
+  offsets, natom, nsavc and delta, together with the size and modification time
+  (in nanoseconds) of the dcd file, which are used to check whether the sidecar
+  is up to date.  Frame counts and offsets not fitting in the dcd file are
+  rejected.
+  All the offsets are 64-bit, so trajectories larger than 2 GiB are supported.
+*/
+class DcdIndex
+{
+ public:
+  //! @brief Create an "empty" DcdIndex object.
+  //! @return A DcdIndex object.
+  DcdIndex();
+  virtual ~DcdIndex() {};
+
+  //! @brief Reset properties of DcdIndex.
+  void reset();
+
+  //! @brief Scan a dcd stream for complete frames.
+  //! @param Input stream of dcd file.
+  //! @param Header of the dcd file.
+  //! @return Status of scanning.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int build(std::istream&, const DcdHeader&);
+  //! @brief Read index of a dcd file from its sidecar file.
+  //! @param DCD file name.
+  //! @param Header of the dcd file.
+  //! @return Status of reading index.
+  //! @retval 1: Failure (no sidecar, sidecar out of date or damaged).
+  //! @retval 0: Success.
+  int read(const std::string&, const DcdHeader&);
+  //! @brief Write index of a dcd file to its sidecar file.
+  //! @param DCD file name.
+  //! @return Status of writing index.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int write(const std::string&) const;
+  //! @brief Read index from sidecar file, or build it and write the sidecar.
+  //! @param DCD file name.
+  //! @param Input stream of dcd file.
+  //! @param Header of the dcd file.
+  //! @return Status of loading index.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int load(const std::string&, std::istream&, const DcdHeader&);
+
+  //! @brief Check if the index is empty.
+  bool is_empty() const { return frame_offsets_.empty(); }
+  //! @brief Get number of complete frames.
+  int get_frame_count() const { return frame_offsets_.size(); }
+  //! @brief Get byte offset of a frame.
+  //! @param Frame index.
+  std::int64_t get_frame_offset(int n) const { return frame_offsets_[n]; }
+  //! @brief Get number of atoms.
+  int get_natom() const { return natom_; }
+  //! @brief Get number of time steps between two frames.
+  int get_nsavc() const { return nsavc_; }
+  //! @brief Get time step.
+  float get_delta() const { return delta_; }
+
+  //! @brief Get name of the sidecar file of a dcd file.
+  //! @param DCD file name.
+  //! @return "xxx.dcdidx" for "xxx.dcd"; otherwise the name followed by ".dcdidx".
+  static std::string get_sidecar_name(const std::string&);
+
+ protected:
+  //! @brief Get size and modification time of a file.
+  static int stat_file(const std::string&, std::int64_t&, std::int64_t&);
+
+  std::int64_t file_size_;                  //!< Size of the dcd file.
+  std::int64_t file_mtime_;                 //!< Modification time of the dcd file (ns).
+  int natom_;                               //!< Number of atoms.
+  int nsavc_;                               //!< Number of timesteps between frames.
+  float delta_;                             //!< Time step.
+  std::vector<std::int64_t> frame_offsets_; //!< Byte offset of each frame.
+};
+
+}
+
+#endif
@@ -0,0 +1,171 @@
+/*!
+  @file dcd_mapped_reader.hpp
+  @brief Memory-mapped reader of CafeMol style dcd files.
+
+  In this file class DcdFrameView and class DcdMappedReader are defined.  The
+  whole dcd file is mapped into memory, and the X, Y, Z blocks of any frame can
+  be accessed directly without reading the frames before it.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 12:40
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_DCD_MAPPED_READER_H_
+#define PINANG_DCD_MAPPED_READER_H_
+
+#include "dcd_reader.hpp"
+
+namespace pinang {
+
+/*!
+  @brief Zero-copy view of the coordinates of one dcd frame.
+
+  The three pointers point directly into the mapped dcd file, to the X, Y and Z
+  blocks (single precision) of a frame.  The view is valid as long as the
+  DcdMappedReader is open.
+*/
+class DcdFrameView
+{
+ public:
+  //! @brief Create an "empty" DcdFrameView object.
+  DcdFrameView(): x_(0), y_(0), z_(0), natom_(0) {}
+  //! @brief Create a DcdFrameView object from X, Y, Z blocks.
+  DcdFrameView(const float* x, const float* y, const float* z, int n):
+      x_(x), y_(y), z_(z), natom_(n) {}
+
+  //! @brief Get the X block.
+  const float* x() const { return x_; }
+  //! @brief Get the Y block.
+  const float* y() const { return y_; }
+  //! @brief Get the Z block.
+  const float* z() const { return z_; }
+  //! @brief Get number of atoms in the frame.
+  int get_size() const { return natom_; }
+  //! @brief Check if the view points to a valid frame.
+  bool is_valid() const { return x_ != 0; }
+
+  //! @brief Get a coordinate from the frame.
+  //! @param Atom index.
+  //! @return Vec3d type coordinate.
+  Vec3d get_coordinate(int i) const { return Vec3d(x_[i], y_[i], z_[i]); }
+  //! @brief Get the frame as a CoordinateView, for the kernels in coordinate_array.hpp.
+  CoordinateView<float> get_view() const { return CoordinateView<float>(x_, y_, z_, natom_); }
+
+ protected:
+  const float* x_;  //!< X block of the frame.
+  const float* y_;  //!< Y block of the frame.
+  const float* z_;  //!< Z block of the frame.
+  int natom_;       //!< Number of atoms.
+};
+
+/*!
+  @brief Random access reader of CafeMol dcd files based on mmap.
+
+  Since all the frames in a dcd file have the same size, the offset of each
+  frame is computed from the header.  Accessing frame i only touches the pages of
+  frame i, so that jobs analysing a part of the trajectory (e.g. the last 10% or
+  every 100th frame) never read the skipped frames from disk.
+
+  A DcdMappedReader is not modified by frame(), read_frame(), so one object can
+  be shared by several threads.
+*/
+class DcdMappedReader
+{
+ public:
+  //! @brief Create an "empty" DcdMappedReader object.
+  //! @return A DcdMappedReader object.
+  DcdMappedReader();
+  //! @brief Create a DcdMappedReader object and map a dcd file.
+  //! @param DCD file name.
+  //! @param Build frame index sidecar file if needed (see DcdIndex).
+  //! @return A DcdMappedReader object.
+  DcdMappedReader(const std::string&, bool = false);
+  virtual ~DcdMappedReader() { close(); }
+
+  //! @brief Map a dcd file into memory and read in the header.
+  //!
+  //! As in DcdReader::open(), an up-to-date ".dcdidx" sidecar file is always
+  //! used, and it is built only when the second parameter is true.
+  //! @param DCD file name.
+  //! @param Build frame index sidecar file if needed.
+  //! @return Status of opening dcd file.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int open(const std::string&, bool = false);
+  //! @brief Unmap the dcd file.
+  void close();
+  //! @brief Check if a dcd file is mapped successfully.
+  bool is_open() const { return map_addr_ != 0; }
+  //! @brief Tell the kernel how the frames will be visited.
+  //!
+  //! Frames are expected in order after open(), so the kernel reads ahead.
+  //! Readahead only wastes I/O if frames are visited in random order.
+  //! @param True for random order, false for sequential order.
+  void set_random_access(bool);
+
+  //! @brief Select frames first, first + stride, ..., (< last) for analysis.
+  //! @param Index of the first frame.  Negative index counts from the end.
+  //! @param Index after the last frame.  Non-positive index counts from the end.
+  //! @param Stride between two frames.
+  //! @return Status of setting frame range.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int set_frame_range(int, int, int);
+  //! @brief Get number of frames in the selected frame range.
+  int get_range_size() const;
+  //! @brief Get index of the k-th frame in the selected frame range.
+  int get_range_frame(int k) const { return range_first_ + k * range_stride_; }
+  //! @brief Decode only the atoms in a union of Selections in read_frame().
+  //! @param Selections of atoms to be decoded.
+  //! @return Status of setting atom subset.
+  //! @retval 1: Failure (atom index out of range).
+  //! @retval 0: Success.
+  int set_atom_subset(const std::vector<Selection>&);
+  //! @brief Decode all the atoms again.
+  void clear_atom_subset() { subset_.reset(); }
+  //! @brief Translate a Selection to indices in frames decoded with atom subset.
+  //! @param Selection of atoms in the full system.
+  //! @return Selection of the same atoms in decoded frames.
+  Selection get_subset_selection(const Selection& s) const { return subset_.map_selection(s); }
+
+  //! @brief Get number of (complete) frames in the dcd file.
+  int frame_count() const { return n_frame_; }
+  //! @brief Get number of atoms (particles) in each frame.
+  int get_natom() const { return header_.get_natom(); }
+  //! @brief Get number of atoms in each decoded frame.
+  int get_subset_size() const { return subset_.is_empty() ? get_natom() : subset_.get_size(); }
+  //! @brief Get header information of the dcd file.
+  const DcdHeader& get_header() const { return header_; }
+  //! @brief Get the byte offset of a frame in the dcd file.
+  //! @param Frame index.
+  std::int64_t get_frame_offset(int) const;
+
+  //! @brief Get zero-copy view of a frame.
+  //! @param Frame index.  Negative index counts from the end of trajectory.
+  //! @return DcdFrameView of the frame; invalid view if failed.
+  DcdFrameView frame(int) const;
+  //! @brief Decode a frame (or its atom subset) into a Conformation.
+  //! @param Frame index.  Negative index counts from the end of trajectory.
+  //! @param Conformation, whose storage is reused if the size is unchanged.
+  //! @return Status of reading the frame.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int read_frame(int, Conformation&) const;
+
+ protected:
+  std::string dcd_name_;  //!< DCD file name.
+  DcdHeader header_;      //!< Header information.
+  DcdIndex index_;        //!< Frame index (empty if not used).
+  DcdAtomSubset subset_;  //!< Decoded atoms (empty: all).
+  int n_frame_;           //!< Number of frames.
+  int range_first_;       //!< First frame of the frame range.
+  int range_last_;        //!< Frame index after the frame range.
+  int range_stride_;      //!< Stride of the frame range.
+  const char* map_addr_;  //!< Address of the mapped file.
+  std::size_t map_size_;  //!< Size of the mapped file.
+};
+
+}
+
+#endif
@@ -0,0 +1,108 @@
+/*!
+  @file dcd_prefetcher.hpp
+  @brief Background prefetching of dcd frames.
+
+  In this file class DcdPrefetcher is defined.  A worker thread keeps decoding
+  the next frames of a DcdReader (or of the frame range of a DcdMappedReader)
+  while the main thread analyses the current one.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 12:43
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_DCD_PREFETCHER_H_
+#define PINANG_DCD_PREFETCHER_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "dcd_reader.hpp"
+#include "dcd_mapped_reader.hpp"
+
+namespace pinang {
+
+/*!
+  @brief Asynchronous frame reader on top of DcdReader.
+
+  Frames are decoded by a background thread into a ring of preallocated
+  Conformation buffers.  When the ring is full the thread waits until the
+  consumer takes a frame, so at most K frames are kept in memory.  Frames are
+  handed over by swapping storage with the Conformation of the consumer, so no
+  coordinates are copied.
+
+  The prefetcher starts from the current position of the reader, i.e. after
+  set_frame_range() or set_atom_subset().  The reader should not be used
+  directly while the prefetcher is alive.  A DcdMappedReader is read through
+  its frame range (and atom subset) from the beginning; it is not modified,
+  so other threads may keep calling its read_frame().
+
+  @code
+  pinang::DcdReader dcd(dcd_name);
+  pinang::DcdPrefetcher prefetcher(dcd);
+  pinang::Conformation conf;
+  while (prefetcher.next_frame(conf) == 0) {
+    // ... prefetcher.get_frame_index() is the index of conf ...
+  }
+  @endcode
+*/
+class DcdPrefetcher
+{
+ public:
+  //! @brief Create a DcdPrefetcher object and start the worker thread.
+  //! @param DcdReader to read frames from.
+  //! @param Number of frame buffers (K >= 1).
+  //! @return A DcdPrefetcher object.
+  DcdPrefetcher(DcdReader&, int = 2);
+  //! @brief Create a DcdPrefetcher object for the frame range of a mapped dcd file.
+  //! @param DcdMappedReader to read frames from.
+  //! @param Number of frame buffers (K >= 1).
+  //! @return A DcdPrefetcher object.
+  DcdPrefetcher(const DcdMappedReader&, int = 2);
+  virtual ~DcdPrefetcher() { stop(); }
+
+  //! @brief Take the next frame.
+  //! @param Conformation to receive the frame.  Its old storage is reused.
+  //! @return Status of reading the frame.
+  //! @retval 1: Failure or end of file.
+  //! @retval 0: Success.
+  int next_frame(Conformation&);
+  //! @brief Get index of the frame taken by the last call of next_frame().
+  int get_frame_index() const { return last_frame_; }
+
+  //! @brief Stop the worker thread.  Frames not taken yet are discarded.
+  void stop();
+
+ protected:
+  //! @brief Allocate the ring and start the worker thread.
+  //! @param Number of frame buffers.
+  void start(int);
+  //! @brief Main loop of the worker thread.
+  void run();
+  //! @brief Decode the next frame into a buffer (called by the worker).
+  //! @param Buffer to receive the frame.
+  //! @param Index of the frame.
+  //! @return Status of reading the frame.
+  //! @retval 1: Failure or end of file.
+  //! @retval 0: Success.
+  int read_next(Conformation&, int&);
+
+  DcdReader* reader_;                 //!< The reader (0 if mapped_ is used).
+  const DcdMappedReader* mapped_;     //!< The mapped reader (0 if reader_ is used).
+  int next_range_;                    //!< Next position in the frame range of mapped_.
+  std::vector<Conformation> buffers_; //!< Ring of frame buffers.
+  std::vector<int> frame_index_;      //!< Frame index of each buffer.
+  int head_;                          //!< Position of the oldest ready buffer.
+  int n_ready_;                       //!< Number of ready buffers.
+  int last_frame_;                    //!< Index of the last frame taken.
+  bool done_;                         //!< The reader reached the end.
+  bool stop_;                         //!< The worker is requested to stop.
+  std::mutex mutex_;                  //!< Mutex protecting the ring.
+  std::condition_variable not_full_;  //!< Signalled when a buffer is freed.
+  std::condition_variable not_empty_; //!< Signalled when a frame is ready.
+  std::thread worker_;                //!< The worker thread.
+};
+
+}
+
+#endif
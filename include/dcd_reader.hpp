@@ -0,0 +1,297 @@
+/*!
+  @file dcd_reader.hpp
+  @brief Frame-by-frame reader of CafeMol style dcd files.
+
+  In this file class DcdHeader and class DcdReader are defined.  Instead of
+  loading the whole trajectory into memory, DcdReader decodes one frame at a time
+  into a reusable Conformation buffer.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 12:36
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_DCD_READER_H_
+#define PINANG_DCD_READER_H_
+
+#include "conformation.hpp"
+#include "dcd_index.hpp"
+#include "selection.hpp"
+#include <fstream>
+
+namespace pinang {
+
+/*!
+  @brief Header information of a CafeMol dcd file.
+
+  The three header blocks of a dcd file (control information, title and number
+  of atoms) are read and stored in this class.  The size of the header and the
+  size of each frame are derived from them.
+*/
+class DcdHeader
+{
+ public:
+  //! @brief Create an "empty" DcdHeader object.
+  //! @return A DcdHeader object.
+  DcdHeader();
+  virtual ~DcdHeader() {};
+
+  //! @brief Reset properties of DcdHeader.
+  void reset();
+
+  //! @brief Read header blocks from the beginning of a dcd stream.
+  //! @param Input stream of dcd file.
+  //! @return Status of reading header.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int read(std::istream&);
+
+  //! @brief Get number of atoms (particles) in each frame.
+  int get_natom() const { return natom_; }
+  //! @brief Get number of frames recorded in the header (NSET).
+  int get_nset() const { return nset_; }
+  //! @brief Get the starting time step (ISTART).
+  int get_istart() const { return istart_; }
+  //! @brief Get number of time steps between two frames (NSAVC).
+  int get_nsavc() const { return nsavc_; }
+  //! @brief Get total number of time steps (NSTEP).
+  int get_nstep() const { return nstep_; }
+  //! @brief Get number of free atoms (NFREAT).
+  int get_nfreat() const { return nfreat_; }
+  //! @brief Get time step (DELTA).
+  float get_delta() const { return delta_; }
+  //! @brief Get unit-cell flag.  If not zero, each frame has a unit-cell block.
+  int get_unit_cell_flag() const { return unit_cell_flag_; }
+
+  //! @brief Get size (in bytes) of the header, i.e. offset of the first frame.
+  std::int64_t get_header_size() const { return header_size_; }
+  //! @brief Get size (in bytes) of one frame, including record markers.
+  std::int64_t get_frame_size() const { return frame_size_; }
+  //! @brief Get size (in bytes) of the unit-cell block of one frame.
+  std::int64_t get_unit_cell_size() const { return unit_cell_flag_ ? 56 : 0; }
+
+ protected:
+  int nset_;                     //!< Number of sets of coordinates (NSET).
+  int istart_;                   //!< The starting timestep (ISTART).
+  int nsavc_;                    //!< Number of timesteps between dcd saves (NSAVC).
+  int nstep_;                    //!< Number of steps (NSTEP).
+  int nunit_;                    //!< Number of unit (NUNIT).
+  int nfreat_;                   //!< Number of free atoms (NFREAT).
+  float delta_;                  //!< Time step (DELTA).
+  int unit_cell_flag_;           //!< Unit-cell information flag.
+  int nver_;                     //!< Version of CHARMM (NVER).
+  int ntitle_;                   //!< Number of title lines.
+  int natom_;                    //!< Number of atoms.
+  std::int64_t header_size_;   //!< Size of header blocks in bytes.
+  std::int64_t frame_size_;    //!< Size of one frame in bytes.
+};
+
+/*!
+  @brief Sorted set of atoms to be decoded from dcd frames.
+
+  A union of Selections is stored as sorted, unique atom indices, grouped into
+  runs of contiguous indices so that each run is copied in one tight loop.
+  Decoded frames contain only these atoms, in ascending order of index.
+*/
+class DcdAtomSubset
+{
+ public:
+  //! @brief Create an "empty" DcdAtomSubset object (all atoms are decoded).
+  //! @return A DcdAtomSubset object.
+  DcdAtomSubset() {}
+  virtual ~DcdAtomSubset() {};
+
+  //! @brief Reset DcdAtomSubset, so that all atoms are decoded.
+  void reset();
+  //! @brief Set atom subset to a union of Selections.
+  //! @param Selections of atoms.
+  //! @param Number of atoms in each dcd frame.
+  //! @return Status of setting atom subset.
+  //! @retval 1: Failure (atom index out of range).
+  //! @retval 0: Success.
+  int set(const std::vector<Selection>&, int);
+
+  //! @brief Check if the subset is empty, i.e. all atoms are decoded.
+  bool is_empty() const { return atoms_.empty(); }
+  //! @brief Get number of atoms in the subset.
+  int get_size() const { return atoms_.size(); }
+  //! @brief Get contiguous runs (first atom, length) of the subset.
+  const std::vector<std::pair<int, int> >& get_runs() const { return runs_; }
+  //! @brief Translate a Selection to indices in frames decoded with this subset.
+  //! @param Selection of atoms in the full system.
+  //! @return Selection of the same atoms in decoded frames.
+  Selection map_selection(const Selection&) const;
+
+ protected:
+  std::vector<int> atoms_;                  //!< Sorted indices of atoms.
+  std::vector<std::pair<int, int> > runs_;  //!< Contiguous runs (first, length) in atoms_.
+};
+
+/*!
+  @brief Streaming reader of CafeMol dcd files.
+
+  Frames are decoded one by one into a Conformation, so that the memory usage
+  stays flat no matter how long the trajectory is.  The reader can be used
+  either by calling next_frame() repeatedly, or in a range-for loop:
+
+  @code
+  pinang::DcdReader dcd(dcd_name);
+  for (pinang::Conformation& conf : dcd) {
+    // ... dcd.get_frame_index() is the index of conf ...
+  }
+  @endcode
+*/
+class DcdReader
+{
+ public:
+  class iterator;
+
+  //! @brief Create an "empty" DcdReader object.
+  //! @return A DcdReader object.
+  DcdReader();
+  //! @brief Create a DcdReader object and open a dcd file.
+  //! @param DCD file name.
+  //! @param Build frame index sidecar file if needed (see DcdIndex).
+  //! @return A DcdReader object.
+  DcdReader(const std::string&, bool = false);
+  virtual ~DcdReader() { close(); }
+
+  //! @brief Open a dcd file and read in the header.
+  //!
+  //! An up-to-date ".dcdidx" sidecar file is always used.  If there is none,
+  //! the frames are scanned and the sidecar is written when the second
+  //! parameter is true; otherwise frame offsets are computed from the header.
+  //! @param DCD file name.
+  //! @param Build frame index sidecar file if needed.
+  //! @return Status of opening dcd file.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int open(const std::string&, bool = false);
+  //! @brief Close the dcd file.
+  void close();
+  //! @brief Check if a dcd file is opened successfully.
+  bool is_open() const { return dcd_file_.is_open(); }
+  //! @brief Go back to the first frame.
+  //! @return Status of rewinding.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int rewind();
+  //! @brief Jump to a frame, so that it is read by the next call of next_frame().
+  //! @param Frame index.  Negative index counts from the end of trajectory.
+  //! @return Status of seeking.
+  //! @retval 1: Failure (frame index out of range).
+  //! @retval 0: Success.
+  int seek_frame(int);
+  //! @brief Restrict reading to frames first, first + stride, ..., (< last).
+  //! @param Index of the first frame.  Negative index counts from the end.
+  //! @param Index after the last frame.  Non-positive index counts from the end.
+  //! @param Stride between two frames.
+  //! @return Status of setting frame range.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int set_frame_range(int, int, int);
+  //! @brief Decode only the atoms in a union of Selections.
+  //!
+  //! Frames read afterwards contain only the selected atoms, in ascending order
+  //! of their index.  Use get_subset_selection() to translate a Selection to
+  //! the indices in such a frame.
+  //! @param Selections of atoms to be decoded.
+  //! @return Status of setting atom subset.
+  //! @retval 1: Failure (atom index out of range).
+  //! @retval 0: Success.
+  int set_atom_subset(const std::vector<Selection>&);
+  //! @brief Decode all the atoms again.
+  void clear_atom_subset();
+
+  //! @brief Read the next frame into a Conformation.
+  //! @param Conformation, whose storage is reused if the size is unchanged.
+  //! @return Status of reading the frame.
+  //! @retval 1: Failure or end of file.
+  //! @retval 0: Success.
+  int next_frame(Conformation&);
+
+  //! @brief Get number of (complete) frames in the dcd file.
+  int frame_count() const { return n_frame_; }
+  //! @brief Get byte offset of a frame in the dcd file.
+  //! @param Frame index.
+  std::int64_t get_frame_offset(int) const;
+  //! @brief Get number of frames in the selected frame range.
+  int get_range_size() const;
+  //! @brief Get index of the frame read by the last call of next_frame().
+  int get_frame_index() const { return last_frame_; }
+  //! @brief Get number of atoms (particles) in each frame.
+  int get_natom() const { return header_.get_natom(); }
+  //! @brief Get number of atoms in each decoded frame.
+  int get_subset_size() const;
+  //! @brief Translate a Selection to indices in frames decoded with atom subset.
+  //! @param Selection of atoms in the full system.
+  //! @return Selection of the same atoms in decoded frames.
+  Selection get_subset_selection(const Selection&) const;
+  //! @brief Get header information of the dcd file.
+  const DcdHeader& get_header() const { return header_; }
+
+  //! @brief Get iterator pointing to the first frame.  The file is rewound.
+  iterator begin();
+  //! @brief Get iterator pointing to the end of the trajectory.
+  iterator end();
+
+ protected:
+  //! @brief Decode a frame stored in frame_buffer_ into a Conformation.
+  int decode_frame(Conformation&);
+  //! @brief Read the selected atoms of frame i_frame_ into frame_buffer_.
+  int read_subset_frame();
+  //! @brief Decode atom subset stored in frame_buffer_ into a Conformation.
+  int decode_subset_frame(Conformation&);
+
+  std::ifstream dcd_file_;          //!< DCD file stream.
+  std::string dcd_name_;            //!< DCD file name.
+  DcdHeader header_;                //!< Header information.
+  DcdIndex index_;                  //!< Frame index (empty if not used).
+  int n_frame_;                     //!< Number of frames.
+  int i_frame_;                     //!< Index of the next frame to be read.
+  int last_frame_;                  //!< Index of the last frame read.
+  int range_first_;                 //!< First frame of the frame range.
+  int range_last_;                  //!< Frame index after the frame range.
+  int range_stride_;                //!< Stride of the frame range.
+  std::vector<char> frame_buffer_;  //!< Raw bytes of one frame.
+  DcdAtomSubset subset_;            //!< Decoded atoms (empty: all).
+  std::vector<int> subset_run_pos_;                 //!< Position of each run in a buffered block.
+  std::vector<std::pair<int, int> > subset_reads_;  //!< Ranges (first, length) read from each block.
+  int subset_block_size_;           //!< Number of floats buffered per block.
+  Conformation frame_;              //!< Conformation buffer used by iterator.
+};
+
+/*!
+  @brief Input iterator over frames of a DcdReader.
+
+  All iterators of the same reader share one Conformation buffer, which is
+  overwritten each time the iterator is incremented.
+*/
+class DcdReader::iterator
+{
+ public:
+  //! @brief Create an iterator of a DcdReader at a certain frame.
+  //! @param Pointer to DcdReader.
+  //! @param Frame index (-1 for the end).
+  iterator(DcdReader* r, int i): reader_(r), i_frame_(i) {}
+
+  //! @brief Access the current frame.
+  Conformation& operator*() const { return reader_->frame_; }
+  //! @brief Access the current frame.
+  Conformation* operator->() const { return &reader_->frame_; }
+  //! @brief Read in the next frame.
+  iterator& operator++();
+
+  //! @brief Compare two iterators.
+  bool operator==(const iterator& o) const { return i_frame_ == o.i_frame_; }
+  //! @brief Compare two iterators.
+  bool operator!=(const iterator& o) const { return i_frame_ != o.i_frame_; }
+
+ protected:
+  DcdReader* reader_;  //!< The reader.
+  int i_frame_;        //!< Index of current frame, -1 for the end.
+};
+
+}
+
+#endif
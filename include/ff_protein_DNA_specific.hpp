@@ -11,6 +11,7 @@
 */
 
 #include "geometry.hpp"
+#include "neighbor_search.hpp"
 #include "topology.hpp"
 
 #ifndef PINANG_FF_PROTEIN_DNA_SPECIFIC_H
@@ -50,6 +51,15 @@ class FFProteinDNASpecific
   //! @param Topology and conformation.
   //! @retval Energy.
   double compute_energy_protein_DNA_specific(Topology&, Conformation&);
+  //! @brief Compute protein-DNA sequence specific interaction energy.
+  //!
+  //! Protein-DNA pairs are taken from a Verlet list, which is updated with the
+  //! current frame and only rebuilt when particles have moved beyond half of its
+  //! skin.  Use one list per thread when analysing frames in parallel.
+  //! @param Topology and conformation.
+  //! @param Verlet list reused across frames.
+  //! @retval Energy.
+  double compute_energy_protein_DNA_specific(Topology&, Conformation&, VerletList&);
  protected:
   int n_protein_particle_;
   double energy_scaling_;
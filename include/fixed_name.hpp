@@ -0,0 +1,141 @@
+/*!
+  @file fixed_name.hpp
+  @brief Fixed-width names packed into integers.
+
+  In this file class template FixedName is defined.  Atom names, residue names,
+  element symbols... have a fixed maximum width in PDB and PSF files, so they
+  are stored as packed integers (one byte per character, the first character
+  in the highest byte) instead of std::string.  Comparing two names is then one
+  integer comparison, and names written as literals (e.g. AtomName("CA  ")) are
+  packed at compile time.  The packing is the same as that of atom_code() and
+  residue_code(), so AtomName("CA  ").code() == atom_code("CA  ").
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 14:07
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_FIXED_NAME_H_
+#define PINANG_FIXED_NAME_H_
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+namespace pinang {
+
+/*!
+  @brief Name of at most N characters, stored as an integer.
+
+  Names shorter than N are padded with '\0' (not shown by str()); longer names
+  are truncated to N characters, so readers of free-format files should check
+  the length against max_size() first.  A FixedName converts implicitly to
+  std::string; the conversion from std::string is explicit.
+
+  @code
+  pinang::AtomName an = atom.get_atom_name();
+  if (an == "CA  ") { ... }                  // one integer comparison;
+  switch (an.code()) {
+    case pinang::atom_code("P   "): ...
+  }
+  @endcode
+*/
+template <int N>
+class FixedName
+{
+  static_assert(N > 0 && N <= 8, "FixedName: width must be 1 to 8 characters.");
+
+ public:
+  //! Integer type holding the packed characters.
+  typedef typename std::conditional<(N <= 4), std::uint32_t, std::uint64_t>::type code_type;
+
+  //! @brief Create an empty name.
+  constexpr FixedName(): code_(0) {}
+  //! @brief Create a name from a C string (e.g. a literal).
+  constexpr FixedName(const char* s): code_(pack(s, 0, 0)) {}
+  //! @brief Create a name from the first n characters of s.
+  FixedName(const char* s, int n): code_(0)
+  {
+    for (int i = 0; i < N; ++i)
+      code_ = code_type(code_ << 8 | (i < n ? (unsigned char)s[i] : 0));
+  }
+  //! @brief Create a name from a std::string (truncated to N characters).
+  explicit FixedName(const std::string& s): FixedName(s.data(), int(s.size())) {}
+
+  //! @brief Create a name from packed characters, e.g. read from a binary file.
+  static FixedName from_code(code_type c)
+  {
+    FixedName f;
+    f.code_ = c;
+    return f;
+  }
+
+  //! @brief Get maximum number of characters.
+  static constexpr int max_size() { return N; }
+  //! @brief Get the packed characters.
+  constexpr code_type code() const { return code_; }
+  //! @brief Get a character (i < N).
+  constexpr char operator[](int i) const { return char(code_ >> (8 * (N - 1 - i))); }
+  //! @brief Get number of characters (before the first '\0').
+  int size() const
+  {
+    int n = 0;
+    while (n < N && (*this)[n] != '\0')
+      ++n;
+    return n;
+  }
+  //! @brief Whether the name is empty.
+  constexpr bool empty() const { return code_ == 0; }
+  //! @brief Whether the name contains character c.
+  bool contains(char c) const
+  {
+    for (int i = 0; i < size(); ++i)
+      if ((*this)[i] == c)
+        return true;
+    return false;
+  }
+  //! @brief Get the name padded with spaces to n (n <= N) characters.
+  FixedName padded(int n = N) const
+  {
+    FixedName p(*this);
+    for (int i = size(); i < n; ++i)
+      p.code_ |= code_type(' ') << (8 * (N - 1 - i));
+    return p;
+  }
+
+  //! @brief Get the name as std::string.
+  std::string str() const
+  {
+    char s[N];
+    for (int i = 0; i < N; ++i)
+      s[i] = (*this)[i];
+    return std::string(s, size());
+  }
+  operator std::string() const { return str(); }
+
+  friend constexpr bool operator==(FixedName a, FixedName b) { return a.code_ == b.code_; }
+  friend constexpr bool operator!=(FixedName a, FixedName b) { return a.code_ != b.code_; }
+  friend constexpr bool operator<(FixedName a, FixedName b) { return a.code_ < b.code_; }
+  friend std::ostream& operator<<(std::ostream& o, FixedName a) { return o << a.str(); }
+
+ protected:
+  code_type code_;  //!< Packed characters.
+
+  static constexpr code_type pack(const char* s, int i, code_type c)
+  {
+    return i == N ? c : pack(*s ? s + 1 : s, i + 1, code_type(c << 8 | (unsigned char)*s));
+  }
+};
+
+typedef FixedName<6> RecordName;   //!< PDB record name, e.g. "ATOM  ", "HETATM".
+typedef FixedName<4> AtomName;     //!< Atom name, e.g. "CA  ", "O3' ".
+typedef FixedName<3> ResidueName;  //!< Residue name, e.g. "ALA", "DA ".
+typedef FixedName<4> SegmentName;  //!< Segment identifier.
+typedef FixedName<2> ElementName;  //!< Element symbol, e.g. "C", "FE".
+typedef FixedName<2> ChargeName;   //!< Atom charge in PDB, e.g. "2+".
+typedef FixedName<4> PsfResidueName;  //!< Residue name in PSF, e.g. "ALA", "TIP3".
+
+}
+
+#endif
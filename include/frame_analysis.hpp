@@ -0,0 +1,92 @@
+/*!
+  @file frame_analysis.hpp
+  @brief Per-frame analysis functions shared by cafedcd_* tools and pipeline stages.
+
+  In this file the functions computing the result of one trajectory frame for
+  rmsd, angle, distance and interface analyses are defined.  The standalone
+  tools call them from parallel_for_frames(), the analysis stages of
+  cafedcd_pipeline call them frame by frame.  The energy analysis (Ep) uses
+  FFProteinDNASpecific::compute_energy_protein_DNA_specific() directly.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 15:28
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_FRAME_ANALYSIS_H_
+#define PINANG_FRAME_ANALYSIS_H_
+
+#include <ostream>
+#include "geometry.hpp"
+#include "neighbor_search.hpp"
+
+namespace pinang {
+
+//! @brief Scratch objects of get_superimposed_rmsd(), one set per thread.
+struct RmsdScratch
+{
+  CoordinateArray<double> tran;  //!< Superimposition group of the frame.
+  CoordinateArray<double> rmsd;  //!< RMSD group of the frame.
+  Transform t;                   //!< Superimposing transform.
+};
+
+//! @brief Get RMSD of a frame after superimposition onto a reference.
+//! @param Superposer set up with the superimposition group of the reference.
+//! @param RMSD group of the reference.
+//! @param Conformation of the frame.
+//! @param Superimposition group of the frame.
+//! @param RMSD group of the frame.
+//! @param Scratch objects.
+//! @return RMSD.
+double get_superimposed_rmsd(const Superposer&, const CoordinateView<double>&,
+                             Conformation&, const Selection&, const Selection&,
+                             RmsdScratch&);
+
+//! @brief Get angle between the COM vectors 0->1 and 2->3 of four groups.
+//! @param Conformation of the frame.
+//! @param Selections of the four groups.
+//! @param Masses of the four groups.
+//! @return Angle in degrees.
+double get_com_vector_angle(Conformation&, const Selection*, const std::vector<double>*);
+
+//! @brief Get minimum distance from the COM of a ligand to the particles of a receptor.
+//! @param Conformation of the frame.
+//! @param Ligand.
+//! @param Masses of ligand.
+//! @param Receptor.
+//! @return Minimum distance (-1 if the receptor is empty).
+double get_min_com_distance(Conformation&, const Selection&, const std::vector<double>&,
+                            const Selection&);
+
+//! @brief Estimate cutoff of the ligand-receptor centroid distance for interfaces.
+//! @param Conformation of a frame.
+//! @param Ligand.
+//! @param Receptor.
+//! @return Twice the sum of the radii of gyration.
+double get_interface_com_cutoff(Conformation&, const Selection&, const Selection&);
+
+//! @brief Write the interface particles of a ligand and a receptor in a frame.
+//!
+//! Nothing is written if the centroids are farther than the COM cutoff.
+//! Particles are written by their serial (index + 1) in the system.
+//! @param Output stream.
+//! @param Frame index.
+//! @param Conformation of the frame.
+//! @param Ligand (indices in the frame).
+//! @param Receptor (indices in the frame).
+//! @param Ligand (indices in the system).
+//! @param Receptor (indices in the system).
+//! @param Contact distance cutoff.
+//! @param Cutoff of centroid distance.
+//! @param Verlet list of receptor-ligand pairs, reused across frames.
+//! @return Status of finding the interface.
+//! @retval 1: Failure.
+//! @retval 0: Success.
+int write_interface(std::ostream&, int, Conformation&,
+                    const Selection&, const Selection&,
+                    const Selection&, const Selection&,
+                    double, double, VerletList&);
+
+}
+
+#endif
@@ -73,10 +73,13 @@ class Transform
 
   //! @brief Get the rotation part of the Quaternion.
   //! @return The rotation part of the Quaternion.
-  Quaternion rotation() { return rotation_; }
+  Quaternion rotation() const { return rotation_; }
   //! @brief Get the translation part of the Quaternion.
   //! @return The translation part of the Quaternion.
-  Vec3d translation() { return translation_; }
+  Vec3d translation() const { return translation_; }
+  //! @brief Get the rotation matrix (row-major) converted from the quaternion.
+  //! @param Array of 9 real numbers to store the matrix.
+  void get_rotation_matrix(double*) const;
   //! @brief Set the rotation part of Transform object base on a quaternion.
   void set_rotation(const Quaternion&);
   //! @brief Set the translation part of Transform object base on a vector.
@@ -97,6 +100,70 @@ class Transform
   Vec3d rotv2_;  //!< The second row of rotation matrix converted from quaternion.
   Vec3d rotv3_;  //!< The third row of rotation matrix converted from quaternion.
 };
+/*!
+  @brief Superimposition onto a fixed reference structure.
+
+  The reference is centered once, and its centroid and squared norm are
+  stored, so that superimposing a frame only needs one pass over the frame
+  coordinates (see get_inner_product) and the QCP method.  superimpose() does
+  not allocate memory, and can be called by several threads at the same time.
+
+  @code
+  pinang::Superposer sp(grp_ref);
+  for (...) {
+    sp.superimpose(frame.get_view(), t, rmsd);
+  }
+  @endcode
+*/
+class Superposer
+{
+ public:
+  //! @brief Create an "empty" Superposer object.
+  //! @return A Superposer object.
+  Superposer(): g_(0) {}
+  //! @brief Create a Superposer object with a reference Group.
+  //! @param Reference Group.
+  //! @return A Superposer object.
+  explicit Superposer(const Group& g) { set_reference(g.get_view()); }
+  virtual ~Superposer() {}
+
+  //! @brief Set the reference coordinates.
+  //! @param Reference coordinates.
+  void set_reference(const CoordinateView<double>&);
+  //! @brief Get number of reference coordinates.
+  int get_size() const { return ref_.get_size(); }
+  //! @brief Get centroid of the reference.
+  const Vec3d& get_reference_centroid() const { return ctr_; }
+
+  //! @brief Superimpose coordinates onto the reference.
+  //! @param Coordinates to be moved (same number as the reference).
+  //! @param A Transform object moving the coordinates onto the reference.
+  //! @param Minimal RMSD (output).
+  //! @return Status of finding the proper transform.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  template <typename T>
+  int superimpose(const CoordinateView<T>&, Transform&, double&) const;
+  //! @brief Superimpose a Group onto the reference.
+  int superimpose(const Group& g, Transform& t, double& rmsd) const
+  {
+    return superimpose(g.get_view(), t, rmsd);
+  }
+  //! @brief Superimpose a batch of frames onto the reference.
+  //! @param Number of frames.
+  //! @param Array of coordinates of the frames.
+  //! @param Array of Transform objects to be calculated.
+  //! @param Array of minimal RMSD (output).
+  //! @return Number of frames which failed.
+  template <typename T>
+  int superimpose(int, const CoordinateView<T>*, Transform*, double*) const;
+
+ protected:
+  CoordinateArray<double> ref_;  //!< Centered reference coordinates.
+  Vec3d ctr_;                    //!< Centroid of the reference.
+  double g_;                     //!< Sum of squared norms of the centered reference.
+};
+
 //! @brief Get the transform matrix from one Group to another.
 //! @param Two Group's.
 //! @param A Transform object to be calculated.
@@ -104,6 +171,48 @@ class Transform
 //! @retval 1: Failure.
 //! @retval 0: Success.
 int find_transform(const Group&, const Group&, Transform&);
+//! @brief Get the transform matrix from one Group to another, and the RMSD after superimposition.
+//! @param Two Group's.
+//! @param A Transform object to be calculated.
+//! @param Minimal RMSD (output).
+//! @return Status of finding the proper transform.
+//! @retval 1: Failure.
+//! @retval 0: Success.
+int find_transform(const Group&, const Group&, Transform&, double&);
+//! @brief Superimpose coordinates with the QCP method, without SVD or memory allocation.
+//!
+//! The RMSD is derived from the largest eigenvalue of the key matrix, so for
+//! (almost) perfectly superimposable structures it is only accurate to ~1e-6.
+//! @param Coordinates to be moved.
+//! @param Reference coordinates.
+//! @param A Transform object moving the first coordinates onto the reference.
+//! @param Minimal RMSD (output).
+//! @return Status of finding the proper transform.
+//! @retval 1: Failure.
+//! @retval 0: Success.
+template <typename T>
+int find_transform(const CoordinateView<T>&, const CoordinateView<T>&, Transform&, double&);
+//! @brief Get the superimposition transform and minimal RMSD from the inner product matrix (QCP).
+//! @param Inner product matrix of centered coordinates (see get_inner_product).
+//! @param Sum of squared norms of the centered coordinates to be moved.
+//! @param Sum of squared norms of the centered reference coordinates.
+//! @param Number of coordinates.
+//! @param Centroid of the coordinates to be moved.
+//! @param Centroid of the reference coordinates.
+//! @param A Transform object to be calculated.
+//! @param Minimal RMSD (output).
+//! @return Status of finding the proper transform.
+//! @retval 1: Failure.
+//! @retval 0: Success.
+int get_qcp_transform(const double*, double, double, int, const Vec3d&, const Vec3d&,
+                      Transform&, double&);
+//! @brief Get the minimal RMSD from the inner product matrix (QCP), without the rotation.
+//! @param Inner product matrix of centered coordinates (see get_inner_product).
+//! @param Sum of squared norms of the first centered coordinates.
+//! @param Sum of squared norms of the second centered coordinates.
+//! @param Number of coordinates.
+//! @return Minimal RMSD.
+double get_qcp_rmsd(const double*, double, double, int);
 }
 
 #endif
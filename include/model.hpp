@@ -14,6 +14,7 @@
 #define PINANG_MODEL_H_
 
 #include "chain.hpp"
+#include "sasa.hpp"
 
 namespace pinang {
 
@@ -46,11 +47,20 @@ class Model
   //! @param Serial number of the Chain.
   //! @return Chain.
   Chain& get_chain(unsigned int);
+  //! @brief Get a Chain object from Model (read only).
+  //! @param Serial number of the Chain.
+  //! @return Chain.
+  const Chain& get_chain(unsigned int) const;
+  //! @brief Get all the Chain objects of Model.
+  const std::vector<Chain>& get_chains() const { return v_chains_; }
   //! @brief Add a Chain object to Model.
   //! @param Chain.
   //! @return Status of adding Chain to Model.
   //! @retval 0: Success.
   void add_chain(Chain&);
+  //! @brief Add a Chain object to Model, moving it into Model.
+  //! @param Chain.
+  void add_chain(Chain&&);
 
   //! @brief Print sequence of the Model.
   //! @param Option to output short style (1) or full name (3).
@@ -62,6 +72,12 @@ class Model
   //! @return Number of chains in the Model.
   int get_size() const { return n_chain_; }
 
+  //! @brief Iterators over the chains, e.g. for (const Chain& c : model).
+  std::vector<Chain>::iterator begin() { return v_chains_.begin(); }
+  std::vector<Chain>::iterator end() { return v_chains_.end(); }
+  std::vector<Chain>::const_iterator begin() const { return v_chains_.begin(); }
+  std::vector<Chain>::const_iterator end() const { return v_chains_.end(); }
+
   //! @brief Output PDB of CG beads.
   void output_cg_pdb(std::ostream&);
   //! @brief Output coordinates of CG beads.
@@ -85,11 +101,40 @@ class Model
   //! @brief Output non-bonded interactions to forcefield parm file.
   void output_ffparm_nonbonded(std::ostream&);
 
+  //! @brief Get CG particles of proteins and DNA, with the atoms they represent.
+  //!
+  //! Particles are numbered and named (chain ID 'a', 'b'...) as in the CG
+  //! topology.  Every DNA nucleotide is split into residues of P, S and B.
+  //! @param CG @f$C_\alpha@f$ particles.
+  //! @param Residues of the @f$C_\alpha@f$ particles.
+  //! @param CG DNA particles.
+  //! @param Residues (groups of atoms) of the DNA particles.
+  //! @return Status of getting CG groups.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int get_cg_groups(std::vector<Atom>&, std::vector<Residue>&, std::vector<Atom>&,
+                    std::vector<Residue>&);
+
   //! @brief Output statistics of protein-DNA pairwise interaction quantities.
   void output_statistics_pro_DNA_contact_pairs(std::ostream&);
 
+  //! @brief Compute solvent accessible surface area of atoms and residues.
+  //!
+  //! Water and (in all-atom models) hydrogen atoms get zero area and do not
+  //! bury other atoms.  The SASA of every Residue is set as the sum of its
+  //! atoms.
+  //! @param Shrake-Rupley calculator (points, probe radius).
+  //! @param Area of every atom, in the order of chains, residues and atoms.
+  //! @param Flag of CG model (radii by bead name instead of element).
+  //! @param Number of threads.
+  //! @return Status of computing SASA.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int compute_sasa(const ShrakeRupley&, std::vector<double>&, int, int);
+
   //! @brief Output PDB format information of Chain.
   friend std::ostream& operator<<(std::ostream&, Model&);
+  friend class PDBCache;
 
  protected:
   int model_serial_;               //!< Model serial number.
@@ -97,6 +142,16 @@ class Model
   int n_chain_;                //!< Number of chains in Model.
 };
 
+//! @brief Get protein-protein native contacts of the CG model.
+//!
+//! Residues closer than g_pro_pro_aa_cutoff (heavy atoms) are in contact,
+//! unless they are in the same chain and separated by 3 or less in sequence.
+//! @param CG @f$C_\alpha@f$ particles (from Model::get_cg_groups()).
+//! @param Residues of the @f$C_\alpha@f$ particles.
+//! @return Contacts (i, j), i < j, as indices of the particles.
+std::vector<std::pair<int, int> > get_native_contacts(const std::vector<Atom>&,
+                                                      const std::vector<Residue>&);
+
 }
 
 #endif
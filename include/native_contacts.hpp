@@ -0,0 +1,128 @@
+/*!
+  @file native_contacts.hpp
+  @brief Native contacts and fraction of native contacts (Q).
+
+  In this file class NativeContacts is defined.  Native contact pairs are read
+  from the [ native ] block of a CG force field file, derived from an
+  atomistic reference PDB (as in pdb_cg_top), or derived from CG reference
+  coordinates.  The pairs are stored as structure of arrays, so that Q, Q_intra
+  and Q_inter of a frame are counted in one branch-free loop.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:32
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_NATIVE_CONTACTS_H_
+#define PINANG_NATIVE_CONTACTS_H_
+
+#include "conformation.hpp"
+#include "model.hpp"
+#include "topology.hpp"
+#include "selection.hpp"
+
+namespace pinang {
+
+/*!
+  @brief List of native contacts of a structure.
+
+  A contact (i, j) with native distance r0 is formed in a frame if the distance
+  between particles i and j is smaller than tolerance * r0 (1.2 by default).
+  Contacts between particles of the same chain are "intra", the others
+  "inter".
+*/
+class NativeContacts
+{
+ public:
+  //! @brief Create an "empty" NativeContacts object.
+  //! @return A NativeContacts object.
+  NativeContacts();
+  virtual ~NativeContacts() {}
+
+  //! @brief Remove all the contacts.
+  void reset();
+
+  //! @brief Read contacts from the [ native ] block of a CG force field file.
+  //! @param Force field file name (e.g. xxx_cg.ffp from pdb_cg_top -P).
+  //! @return Status of reading contacts.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int read_ffp(const std::string&);
+  //! @brief Read contacts from the [ native ] block of a CG force field stream.
+  //! @param Input stream.
+  //! @return Status of reading contacts.
+  //! @retval 1: Failure (no [ native ] block).
+  //! @retval 0: Success.
+  int read_ffp(std::istream&);
+  //! @brief Derive contacts of the CG model from an atomistic reference.
+  //!
+  //! Residues closer than g_pro_pro_aa_cutoff (heavy atoms) and separated by
+  //! more than 3 in sequence are in contact, the same as the [ native ] block
+  //! written by pdb_cg_top.
+  //! @param Atomistic Model.
+  //! @return Status of deriving contacts.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int set_contacts(Model&);
+  //! @brief Derive contacts from CG reference coordinates.
+  //!
+  //! Particles closer than the cutoff are in contact, unless they are in the
+  //! same chain and closer than min_sep in sequence.
+  //! @param Reference coordinates.
+  //! @param Topology (for chain IDs).
+  //! @param Cutoff distance.
+  //! @param Minimum sequence separation in the same chain.
+  //! @return Status of deriving contacts.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int set_contacts(const Conformation&, Topology&, double, int);
+  //! @brief Add a native contact.
+  //! @param Particle indices i, j.
+  //! @param Native distance.
+  //! @param Whether i and j belong to different chains.
+  void add_contact(int, int, double, bool);
+
+  //! @brief Set tolerance factor of formed contacts (r < tolerance * r0).
+  void set_tolerance(double);
+  //! @brief Get tolerance factor of formed contacts.
+  double get_tolerance() const { return tolerance_; }
+
+  //! @brief Get number of contacts.
+  int get_size() const { return int(i_.size()); }
+  //! @brief Get number of intra-chain contacts.
+  int get_intra_number() const { return get_size() - n_inter_; }
+  //! @brief Get number of inter-chain contacts.
+  int get_inter_number() const { return n_inter_; }
+  //! @brief Get sorted indices of all particles in contacts.
+  std::vector<int> get_atoms() const;
+  //! @brief Translate particle indices, e.g. to the atom subset of a DcdReader.
+  //! @param Particles (sorted, e.g. from get_atoms()).
+  //! @param New indices of the same particles.
+  //! @return Status of translating indices.
+  //! @retval 1: Failure (particle not found).
+  //! @retval 0: Success.
+  int renumber(const Selection&, const Selection&);
+
+  //! @brief Compute fraction of native contacts in a frame.
+  //!
+  //! Q_intra (Q_inter) is 0 if there are no intra (inter) contacts.
+  //! @param Coordinates of the frame.
+  //! @param Q of all contacts.
+  //! @param Q of intra-chain contacts.
+  //! @param Q of inter-chain contacts.
+  //! @return Number of formed contacts.
+  int compute_q(const Conformation&, double&, double&, double&) const;
+
+ protected:
+  std::vector<int> i_;          //!< Index of the first particle.
+  std::vector<int> j_;          //!< Index of the second particle.
+  std::vector<double> r0_;      //!< Native distance.
+  std::vector<double> r2_max_;  //!< Squared distance threshold, (tolerance * r0)^2.
+  std::vector<int> inter_;      //!< Inter-chain flag (0 or 1).
+  int n_inter_;                 //!< Number of inter-chain contacts.
+  double tolerance_;            //!< Tolerance factor of formed contacts.
+};
+
+}
+
+#endif
@@ -0,0 +1,327 @@
+/*!
+  @file neighbor_search.hpp
+  @brief Cell-list search of particle pairs within a cutoff.
+
+  In this file class CellList and class VerletList are defined, together with
+  functions finding all pairs of particles closer than a cutoff, either between
+  two groups (A vs B) or within one group (with exclusion of neighbours in
+  sequence).  Particles are sorted into cubic cells not smaller than the
+  cutoff, so that only the 27 cells around a particle are searched, instead of
+  all the particles.  The same cells serve nearest-particle queries.  A Verlet
+  list keeps the pairs within cutoff + skin for the following frames.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:24
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_NEIGHBOR_SEARCH_H_
+#define PINANG_NEIGHBOR_SEARCH_H_
+
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "vec3d.hpp"
+
+namespace pinang {
+
+/*!
+  @brief Linked-cell grid of a set of coordinates.
+
+  The coordinates are copied in the order of cells, so that particles in the
+  same cell are contiguous in memory.  Indices passed to the callbacks are the
+  indices in the original coordinate list.
+
+  @code
+  pinang::CellList cells;
+  cells.build(coors_rec, 10.0);
+  for (const pinang::Vec3d& p : coors_lig)
+    cells.for_each_neighbor(p, [&](int j, double d2) { ... });
+  @endcode
+*/
+class CellList
+{
+ public:
+  //! @brief Create an "empty" CellList object.
+  //! @return A CellList object.
+  CellList();
+  virtual ~CellList() {}
+
+  //! @brief Sort coordinates into cells.
+  //! @param Coordinates.
+  //! @param Cutoff distance.
+  //! @return Status of building the cell list.
+  //! @retval 1: Failure (non-positive cutoff).
+  //! @retval 0: Success.
+  int build(const std::vector<Vec3d>&, double);
+
+  //! @brief Get number of coordinates in the cell list.
+  int get_size() const { return int(index_.size()); }
+  //! @brief Get cutoff distance.
+  double get_cutoff() const { return cutoff_; }
+
+  //! @brief Call f(j, d2) for every particle j within the cutoff from a point.
+  //! @param Coordinate of the point (need not be inside the grid).
+  //! @param Function called with index j and squared distance d2.
+  template <typename F>
+  void for_each_neighbor(const Vec3d&, F) const;
+  //! @brief Call f(i, j, d2) for every pair i < j within the cutoff.
+  //! @param Function called with indices i, j and squared distance d2.
+  template <typename F>
+  void for_each_pair(F) const;
+  //! @brief Check if any particle is within the cutoff from a point.
+  //! @param Coordinate of the point.
+  //! @return True if some particle is within the cutoff.
+  bool has_neighbor(const Vec3d&) const;
+  //! @brief Find the particle nearest to a point (at any distance).
+  //!
+  //! Cells are searched in shells around the point, until no unvisited cell
+  //! can be closer than the nearest particle found.  Among equally near
+  //! particles the one with the smallest index is returned.
+  //! @param Coordinate of the point.
+  //! @param Squared distance to the nearest particle.
+  //! @return Index of the nearest particle (-1 if there is no particle).
+  int find_nearest(const Vec3d&, double&) const;
+
+ protected:
+  //! @brief Get cell index along one dimension, clamped to [-2, n_cell_[d] + 1].
+  int get_cell_index(double x, int d) const
+  {
+    double c = std::floor((x - origin_[d]) / cell_size_);
+    if (!(c > -2)) return -2;
+    if (c > n_cell_[d] + 1) return n_cell_[d] + 1;
+    return int(c);
+  }
+  //! @brief Get linear index of cell (i, j, k).
+  int get_cell(int i, int j, int k) const { return (i * n_cell_[1] + j) * n_cell_[2] + k; }
+
+  double cutoff_;                //!< Cutoff distance.
+  double cutoff_2_;              //!< Squared cutoff distance.
+  double cell_size_;             //!< Edge length of cells (>= cutoff).
+  double origin_[3];             //!< Lower corner of the grid.
+  int n_cell_[3];                //!< Number of cells along x, y, z.
+  std::vector<int> cell_start_;  //!< First position of each cell in x_, y_, z_ (plus end).
+  std::vector<double> x_;        //!< X components, sorted by cell.
+  std::vector<double> y_;        //!< Y components, sorted by cell.
+  std::vector<double> z_;        //!< Z components, sorted by cell.
+  std::vector<int> index_;       //!< Original index of each sorted coordinate.
+};
+
+template <typename F>
+void CellList::for_each_neighbor(const Vec3d& p, F f) const
+{
+  if (index_.empty())
+    return;
+  int c[3];
+  for (int d = 0; d < 3; ++d)
+    c[d] = get_cell_index(p[d], d);
+  int lo[3], hi[3];
+  for (int d = 0; d < 3; ++d) {
+    lo[d] = c[d] > 0 ? c[d] - 1 : 0;
+    hi[d] = c[d] < n_cell_[d] - 1 ? c[d] + 1 : n_cell_[d] - 1;
+    if (lo[d] > hi[d])
+      return;
+  }
+  const double px = p.x(), py = p.y(), pz = p.z();
+  for (int i = lo[0]; i <= hi[0]; ++i) {
+    for (int j = lo[1]; j <= hi[1]; ++j) {
+      // cells (i, j, lo[2] .. hi[2]) are contiguous in memory;
+      int m_end = cell_start_[get_cell(i, j, hi[2]) + 1];
+      for (int m = cell_start_[get_cell(i, j, lo[2])]; m < m_end; ++m) {
+        double dx = x_[m] - px;
+        double dy = y_[m] - py;
+        double dz = z_[m] - pz;
+        double d2 = dx * dx + dy * dy + dz * dz;
+        if (d2 <= cutoff_2_)
+          f(index_[m], d2);
+      }
+    }
+  }
+}
+
+template <typename F>
+void CellList::for_each_pair(F f) const
+{
+  for (int ci = 0; ci < n_cell_[0]; ++ci) {
+    for (int cj = 0; cj < n_cell_[1]; ++cj) {
+      for (int ck = 0; ck < n_cell_[2]; ++ck) {
+        int c = get_cell(ci, cj, ck);
+        for (int m = cell_start_[c]; m < cell_start_[c + 1]; ++m) {
+          // half stencil: the same cell (after m), and cells with larger
+          // linear index among the 26 neighbours;
+          for (int di = 0; di <= 1; ++di) {
+            int i = ci + di;
+            if (i >= n_cell_[0])
+              break;
+            for (int dj = (di == 0 ? 0 : -1); dj <= 1; ++dj) {
+              int j = cj + dj;
+              if (j < 0 || j >= n_cell_[1])
+                continue;
+              int k_lo = (di == 0 && dj == 0) ? ck : ck - 1;
+              int k_hi = ck + 1;
+              if (k_lo < 0) k_lo = 0;
+              if (k_hi >= n_cell_[2]) k_hi = n_cell_[2] - 1;
+              int n_begin = (di == 0 && dj == 0) ? m + 1 : cell_start_[get_cell(i, j, k_lo)];
+              int n_end = cell_start_[get_cell(i, j, k_hi) + 1];
+              for (int n = n_begin; n < n_end; ++n) {
+                double dx = x_[n] - x_[m];
+                double dy = y_[n] - y_[m];
+                double dz = z_[n] - z_[m];
+                double d2 = dx * dx + dy * dy + dz * dz;
+                if (d2 > cutoff_2_)
+                  continue;
+                if (index_[m] < index_[n])
+                  f(index_[m], index_[n], d2);
+                else
+                  f(index_[n], index_[m], d2);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+/*!
+  @brief Verlet neighbour list reused across trajectory frames.
+
+  The list stores, for each particle i of group A, the particles j of group B
+  (or j > i of the same group, in self mode) within cutoff + skin at the time
+  of building.  update() rebuilds it (with a CellList) only if a particle has
+  moved more than skin / 2 since, so that the list still contains all the pairs
+  within the cutoff.  Each thread analysing frames should keep its own list.
+
+  @code
+  pinang::VerletList list(10.0, 2.0);
+  for (...each frame...) {
+    list.update(coors_rec, coors_lig);
+    list.for_each_pair(coors_rec, coors_lig, [&](int i, int j, double d2) { ... });
+  }
+  @endcode
+*/
+class VerletList
+{
+ public:
+  //! @brief Create an "empty" VerletList object.
+  //! @return A VerletList object.
+  VerletList();
+  //! @brief Create a VerletList object with cutoff and skin.
+  //! @param Cutoff distance.
+  //! @param Skin distance.
+  //! @return A VerletList object.
+  VerletList(double, double);
+  virtual ~VerletList() {}
+
+  //! @brief Set cutoff and skin.  The list is rebuilt at the next update().
+  //! @param Cutoff distance.
+  //! @param Skin distance.
+  void set_cutoff(double, double);
+  //! @brief Get cutoff distance.
+  double get_cutoff() const { return cutoff_; }
+  //! @brief Get skin distance.
+  double get_skin() const { return skin_; }
+
+  //! @brief Update the list of pairs between group A and group B.
+  //! @param Coordinates of group A.
+  //! @param Coordinates of group B.
+  //! @return Status of updating the list.
+  //! @retval 1: Failure (non-positive cutoff).
+  //! @retval 0: Success.
+  int update(const std::vector<Vec3d>&, const std::vector<Vec3d>&);
+  //! @brief Update the list of pairs within one group.
+  //! @param Coordinates.
+  //! @param Sequence number of each coordinate (see find_pairs()).
+  //! @param Minimum sequence separation.
+  //! @return Status of updating the list.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int update(const std::vector<Vec3d>&, const std::vector<int>&, int);
+
+  //! @brief Get number of particles i in the list.
+  int get_size() const { return int(start_.size()) - 1; }
+  //! @brief Get the candidate neighbours j (ascending) of particle i.
+  const int* neighbors_begin(int i) const { return list_.data() + start_[i]; }
+  //! @brief Get end of the candidate neighbours of particle i.
+  const int* neighbors_end(int i) const { return list_.data() + start_[i + 1]; }
+  //! @brief Get number of times the list has been built.
+  int get_build_number() const { return n_build_; }
+
+  //! @brief Call f(i, j, d2) for every pair (i in A, j in B) within the cutoff.
+  //! @param Coordinates of group A, as in the last update().
+  //! @param Coordinates of group B, as in the last update().
+  //! @param Function called with indices i, j and squared distance d2.
+  template <typename F>
+  void for_each_pair(const std::vector<Vec3d>&, const std::vector<Vec3d>&, F) const;
+  //! @brief Call f(i, j, d2) for every pair i < j within the cutoff (self mode).
+  //! @param Coordinates, as in the last update().
+  //! @param Function called with indices i, j and squared distance d2.
+  template <typename F>
+  void for_each_pair(const std::vector<Vec3d>& x, F f) const { for_each_pair(x, x, f); }
+
+ protected:
+  //! @brief Check if all the particles stay within skin / 2 since the last build.
+  bool is_valid(const std::vector<Vec3d>&, const std::vector<Vec3d>&) const;
+  //! @brief Fill start_ and list_ from per-particle neighbour lists.
+  void set_list(std::vector<std::vector<int> >&);
+
+  double cutoff_;              //!< Cutoff distance.
+  double skin_;                //!< Skin distance.
+  bool self_;                  //!< The list is built in self mode.
+  int min_sep_;                //!< Minimum sequence separation (self mode).
+  std::vector<int> seq_;       //!< Sequence numbers (self mode).
+  std::vector<Vec3d> ref_a_;   //!< Coordinates of group A at the last build.
+  std::vector<Vec3d> ref_b_;   //!< Coordinates of group B at the last build.
+  std::vector<int> start_;     //!< First position of the neighbours of each i in list_ (plus end).
+  std::vector<int> list_;      //!< Neighbours of all particles.
+  CellList cells_;             //!< Cell list used for building.
+  int n_build_;                //!< Number of builds.
+};
+
+template <typename F>
+void VerletList::for_each_pair(const std::vector<Vec3d>& a, const std::vector<Vec3d>& b,
+                               F f) const
+{
+  const double cutoff_2 = cutoff_ * cutoff_;
+  for (int i = 0; i < get_size(); ++i) {
+    const Vec3d& p = a[i];
+    for (int m = start_[i]; m < start_[i + 1]; ++m) {
+      int j = list_[m];
+      double dx = b[j].x() - p.x();
+      double dy = b[j].y() - p.y();
+      double dz = b[j].z() - p.z();
+      double d2 = dx * dx + dy * dy + dz * dz;
+      if (d2 <= cutoff_2)
+        f(i, j, d2);
+    }
+  }
+}
+
+//! @brief Find all pairs (i, j) with |a[i] - b[j]| <= cutoff.
+//! @param Coordinates of group A.
+//! @param Coordinates of group B.
+//! @param Cutoff distance.
+//! @param Pairs (i, j), sorted by i then j.
+//! @return Status of searching pairs.
+//! @retval 1: Failure (non-positive cutoff).
+//! @retval 0: Success.
+int find_pairs(const std::vector<Vec3d>&, const std::vector<Vec3d>&, double,
+               std::vector<std::pair<int, int> >&);
+//! @brief Find all pairs (i, j), i < j, with |x[i] - x[j]| <= cutoff.
+//!
+//! Pairs close in sequence, i.e. |seq[i] - seq[j]| < min_sep, are excluded.
+//! With an empty seq list nothing is excluded.
+//! @param Coordinates.
+//! @param Cutoff distance.
+//! @param Sequence number (e.g. residue index) of each coordinate.
+//! @param Minimum sequence separation.
+//! @param Pairs (i, j), sorted by i then j.
+//! @return Status of searching pairs.
+//! @retval 1: Failure (non-positive cutoff or wrong size of seq).
+//! @retval 0: Success.
+int find_pairs(const std::vector<Vec3d>&, double, const std::vector<int>&, int,
+               std::vector<std::pair<int, int> >&);
+
+}
+
+#endif
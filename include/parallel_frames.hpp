@@ -0,0 +1,59 @@
+/*!
+  @file parallel_frames.hpp
+  @brief Frame-parallel analysis of dcd trajectories.
+
+  In this file the functions parallel_for() and parallel_for_frames() are
+  defined.  Independent tasks (usually frames) are distributed over a pool of
+  threads with work stealing.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 12:51
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_PARALLEL_FRAMES_H_
+#define PINANG_PARALLEL_FRAMES_H_
+
+#include <functional>
+#include "dcd_mapped_reader.hpp"
+
+namespace pinang {
+
+//! @brief Get number of threads to be used.
+//! @param Requested number of threads.  Non-positive value means all cores.
+//! @return Number of threads (>= 1).
+int get_thread_number(int);
+
+//! @brief Call a function for every task index in [0, n) on a thread pool.
+//!
+//! Each thread starts from its own contiguous block of tasks, split in chunks.
+//! Threads which finish early steal chunks from the end of other blocks.  The
+//! calling thread works as thread 0.
+//! @param Number of tasks.
+//! @param Number of threads.  Non-positive value means all cores.
+//! @param Function called as f(thread_id, task_index).
+//! @return Status of running the tasks.
+//! @retval 0: Success.
+int parallel_for(int, int, const std::function<void(int, int)>&);
+
+//! @brief Analyse the frames in the frame range of a dcd file in parallel.
+//!
+//! Every thread decodes frames into its own Conformation buffer (with the atom
+//! subset of the reader, if set).  The function is called as f(thread_id, k,
+//! conf), where conf is frame dcd.get_range_frame(k).  Results should be
+//! stored in slot k of a preallocated array, so that they can be written in
+//! order afterwards; thread_id can be used to pick thread-local scratch
+//! objects.  With a single thread the frames are decoded ahead by a
+//! DcdPrefetcher, so reading overlaps with the analysis.
+//! @param Mapped dcd file.
+//! @param Number of threads.  Non-positive value means all cores.
+//! @param Function called for each frame.
+//! @return Status of analysing frames.
+//! @retval 1: Failure (some frames cannot be read).
+//! @retval 0: Success.
+int parallel_for_frames(const DcdMappedReader&, int,
+                        const std::function<void(int, int, Conformation&)>&);
+
+}
+
+#endif
@@ -15,6 +15,7 @@
 #define PINANG_PARTICLE_H_
 
 #include "vec3d.hpp"
+#include "fixed_name.hpp"
 
 #include <string>
 
@@ -40,17 +41,17 @@ class Particle
 
   //! @brief Get atom name.
   //! @return Atom name.
-  std::string get_atom_name() const { return atom_name_; }
-  //! @brief Set atom name.
+  AtomName get_atom_name() const { return atom_name_; }
+  //! @brief Set atom name (padded with spaces to 4 characters).
   //! @param Atom name.
-  void set_atom_name(const std::string&);
+  void set_atom_name(AtomName s) { atom_name_ = s.padded(); }
 
   //! @brief Get residue name.
   //! @return Residue name.
-  std::string get_residue_name() const { return residue_name_; }
-  //! @brief Set residue name.
-  //! @param Residue name.
-  void set_residue_name(const std::string&);
+  PsfResidueName get_residue_name() const { return residue_name_; }
+  //! @brief Set residue name (padded with spaces to 3 characters).
+  //! @param Residue name (at most 4 characters, e.g. "TIP3").
+  void set_residue_name(PsfResidueName s) { residue_name_ = s.padded(3); }
 
   //! @brief Get residue serial number.
   //! @return Residue serial number.
@@ -84,8 +85,8 @@ class Particle
   friend std::istream& operator>>(std::istream&, Particle&);
 
  protected:
-  std::string atom_name_;      //!< Atom name of particle.
-  std::string residue_name_;   //!< Residue name of particle.
+  AtomName atom_name_;         //!< Atom name of particle.
+  PsfResidueName residue_name_;  //!< Residue name of particle.
   int residue_serial_;         //!< Residue sequence number of particle.
   char chain_ID_;              //!< Chain ID.
   double charge_;              //!< Charge of particle.
@@ -0,0 +1,87 @@
+/*!
+  @file pdb_cache.hpp
+  @brief Binary cache of parsed PDB structures.
+
+  In this file class PDBCache is defined.  A parsed PDB (models, chains,
+  residues, atoms and the CG beads set up by Chain::self_check()) is saved into
+  a ".pdbcache" sidecar file of flat records, so that the same structure can be
+  loaded again by mapping the file, without parsing any PDB line.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 14:12
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_PDB_CACHE_H_
+#define PINANG_PDB_CACHE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "PDB.hpp"
+
+namespace pinang {
+
+/*!
+  @brief Read / write the binary cache of a PDB file.
+
+  The cache file starts with a header (magic, format version, size and
+  modification time in nanoseconds of the PDB file, record counts and a
+  checksum), followed by arrays of fixed-size records: models, chains,
+  residues, atoms, and five CG beads (@f$C_\alpha@f$, @f$C_\beta@f$, P, S,
+  B) per residue.  All names are stored as packed FixedName codes, so a record
+  is copied into an object field by field.  The checksum (64-bit FNV-1a)
+  covers the size and modification time of the PDB file and all the records;
+  a cache whose PDB file has been changed, or which has been damaged, is not
+  used.
+
+  The records are in native byte order; a cache is not meant to be moved to a
+  machine of different endianness.
+
+  @code
+  pinang::PDB pdb = pinang::PDB::load_cached("1aon.pdb");  // writes 1aon.pdbcache;
+  pinang::PDB pdb2 = pinang::PDB::load_cached("1aon.pdb"); // reads 1aon.pdbcache;
+  @endcode
+*/
+class PDBCache
+{
+ public:
+  //! @brief Read a PDB structure from the cache file of a PDB file.
+  //! @param PDB file name.
+  //! @param PDB object to be filled.
+  //! @return Status of reading cache.
+  //! @retval 1: Failure (no cache, or cache out of date / damaged).
+  //! @retval 0: Success.
+  static int read(const std::string&, PDB&);
+  //! @brief Write a PDB structure to the cache file of a PDB file.
+  //!
+  //! The size and modification time must be taken (get_stamp()) before the
+  //! PDB file is parsed, so that a PDB file changed while being parsed gives
+  //! a cache which is out of date, instead of one which looks up to date.
+  //! @param PDB file name.
+  //! @param PDB object read from the PDB file.
+  //! @param Size of the PDB file.
+  //! @param Modification time of the PDB file.
+  //! @return Status of writing cache.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  static int write(const std::string&, const PDB&, std::int64_t, std::int64_t);
+
+  //! @brief Get size and modification time (in nanoseconds) of a PDB file.
+  //! @param PDB file name.
+  //! @param Size of the file.
+  //! @param Modification time of the file.
+  //! @return Status of getting file status.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  static int get_stamp(const std::string&, std::int64_t&, std::int64_t&);
+
+  //! @brief Get name of the cache file of a PDB file.
+  //! @param PDB file name.
+  //! @return "xxx.pdbcache" for "xxx.pdb"; otherwise the name followed by ".pdbcache".
+  static std::string get_sidecar_name(const std::string&);
+};
+
+}
+
+#endif
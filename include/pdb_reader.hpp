@@ -0,0 +1,104 @@
+/*!
+  @file pdb_reader.hpp
+  @brief Fast reading of PDB records.
+
+  In this file class PDBReader is defined, together with the fixed-column
+  decoders used for PDB lines.  The file is read in large blocks and every
+  line is decoded in place: integers and fixed-point numbers are converted by
+  hand, and strings are only built for the fields stored in Atom.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:46
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_PDB_READER_H_
+#define PINANG_PDB_READER_H_
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "atom.hpp"
+
+namespace pinang {
+
+//! Types of PDB records handled by PDB.
+enum PDBRecord {pdb_other=0, pdb_atom=1, pdb_hetatm=2, pdb_model=3, pdb_ter=4,
+                pdb_endmdl=5, pdb_end=6};
+
+//! @brief Decode an integer field (leading spaces and sign allowed).
+//! @param First character of the field.
+//! @param Width of the field.
+//! @return Value of the field, 0 if there is no digit.
+int decode_pdb_int(const char*, int);
+//! @brief Decode a real number field (e.g. "  12.345").
+//!
+//! Plain decimal numbers are converted exactly (correctly rounded); other
+//! forms (exponents, very long mantissas) fall back to strtod.
+//! @param First character of the field.
+//! @param Width of the field.
+//! @return Value of the field, 0 if there is no digit.
+double decode_pdb_real(const char*, int);
+
+//! @brief Decode one PDB line into an Atom.
+//!
+//! The line is handled as if padded with spaces to 80 columns.  Fields are
+//! only set for ATOM / HETATM (all fields) and MODEL (serial number) records;
+//! the record name is always set.
+//! @param First character of the line.
+//! @param Length of the line (without newline).
+//! @param Atom.
+//! @return Type of the record.
+PDBRecord parse_pdb_line(const char*, int, Atom&);
+
+/*!
+  @brief Sequential reader of PDB records.
+
+  @code
+  pinang::PDBReader reader;
+  reader.open("some.pdb");
+  pinang::Atom a;
+  pinang::PDBRecord r;
+  while (reader.read(a, r)) { ... }
+  @endcode
+*/
+class PDBReader
+{
+ public:
+  //! @brief Create a PDBReader object.
+  //! @return A PDBReader object.
+  PDBReader();
+  virtual ~PDBReader() {}
+
+  //! @brief Open a PDB file.
+  //! @param PDB file name.
+  //! @return Status of opening file.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int open(const std::string&);
+  //! @brief Check if the file is open.
+  bool is_open() const { return file_.is_open(); }
+
+  //! @brief Read the next line.
+  //! @param Atom (fields set as in parse_pdb_line()).
+  //! @param Type of the record.
+  //! @return False at the end of file.
+  bool read(Atom&, PDBRecord&);
+
+ protected:
+  //! @brief Get the next line in the buffer, reading a new block if needed.
+  //! @param First character of the line.
+  //! @param Length of the line.
+  //! @return False at the end of file.
+  bool next_line(const char*&, int&);
+
+  std::ifstream file_;        //!< PDB file.
+  std::vector<char> buffer_;  //!< Block of the file.
+  std::size_t begin_;         //!< Start of the unread part of buffer_.
+  std::size_t end_;           //!< End of the valid part of buffer_.
+  bool eof_;                  //!< The whole file has been read into buffer_.
+};
+
+}
+
+#endif
@@ -44,6 +44,9 @@ class Residue
   //! @brief Get short residue name.
   //! @return Short residue name.
   std::string get_short_name() const { return short_name_; }
+  //! @brief Set short residue name.
+  //! @param Short residue name.
+  void set_short_name(const std::string& s) { short_name_ = s; }
   //! @brief Set residue name.
   //! @param Residue name.
   void set_residue_name(const std::string&);
@@ -98,6 +101,13 @@ class Residue
   //! @param Residue mass.
   void set_residue_mass(double m) { mass_ = m; }
 
+  //! @brief Get solvent accessible surface area (see Model::compute_sasa()).
+  //! @return SASA of Residue.
+  double get_sasa() const { return sasa_; }
+  //! @brief Set solvent accessible surface area.
+  //! @param SASA of Residue.
+  void set_sasa(double a) { sasa_ = a; }
+
   //! @brief Self check before additional operations.
   void self_check() const;
 
@@ -105,11 +115,22 @@ class Residue
   //! @param Serial number of the Atom.
   //! @return Atom.
   Atom& get_atom(int);
+  //! @brief Get a Atom object from Residue (read only).
+  //! @param Serial number of the Atom.
+  //! @return Atom.
+  const Atom& get_atom(int) const;
+  //! @brief Get all the Atom objects of Residue.
+  const std::vector<Atom>& get_atoms() const { return v_atoms_; }
   //! @brief Add an Atom object to Residue.
   //! @param Atom.
   //! @return Status of adding atom to residue.
   //! @retval 0: Success.
-  int add_atom(const Atom&);
+  int add_atom(const Atom& a) { return add_atom(Atom(a)); }
+  //! @brief Add an Atom object to Residue, moving it into Residue.
+  //! @param Atom.
+  //! @return Status of adding atom to residue.
+  //! @retval 0: Success.
+  int add_atom(Atom&&);
   //! @brief Deleting an Atom object from Residue.
   //! @param Serial number of Atom.
   //! @return Status of deleting atom from residue.
@@ -121,6 +142,12 @@ class Residue
   //! @return Residue size.
   int get_size() const { return n_atom_; }
 
+  //! @brief Iterators over the atoms, e.g. for (const Atom& a : residue).
+  std::vector<Atom>::iterator begin() { return v_atoms_.begin(); }
+  std::vector<Atom>::iterator end() { return v_atoms_.end(); }
+  std::vector<Atom>::const_iterator begin() const { return v_atoms_.begin(); }
+  std::vector<Atom>::const_iterator end() const { return v_atoms_.end(); }
+
   //! @brief Get CG particle @f$C_\alpha@f$.
   //! @return CG particle @f$C_\alpha@f$.
   Atom& get_cg_C_alpha();
@@ -151,10 +178,14 @@ class Residue
   void set_cg_B(const Atom& a) { cg_B_ = a; }
 
   //! @brief Output PDB format information of Atom.
-  friend std::ostream& operator<<(std::ostream&, Residue&);
+  friend std::ostream& operator<<(std::ostream&, const Residue&);
   friend double residue_min_distance(const Residue&, const Residue&);
   friend double residue_min_distance(const Residue&, const Residue&, Atom&, Atom&);
   friend double residue_ca_distance(const Residue&, const Residue&);
+  friend bool is_residue_contact(const Residue&, const Residue&, double);
+  friend void get_bounding_spheres(const std::vector<Residue>&, std::vector<Vec3d>&,
+                                   std::vector<double>&);
+  friend class PDBCache;
  protected:
   std::string residue_name_;   //!< Residue name from PDB.
   std::string short_name_;   //!< Short name of residue.
@@ -164,6 +195,7 @@ class Residue
   int n_atom_;               //!< Number of atoms in Residue.
   double charge_;            //!< Charge of Residue.
   double mass_;              //!< Mass of Residue.
+  double sasa_;              //!< Solvent accessible surface area of Residue.
 
   Atom cg_C_alpha_;             //!< CG particle @f$C_\alpha@f$.
   Atom cg_C_beta_;              //!< CG particle @f$C_\beta@f$.
@@ -188,6 +220,34 @@ double residue_min_distance(const Residue&, const Residue&, Atom&, Atom&);
 //! @param Two Residue objects.
 //! @return @f$C_\alpha@f$ Distance.
 double residue_ca_distance(const Residue&, const Residue&);
+//! @brief Check if two Residues are in contact.
+//!
+//! Same as 0 < residue_min_distance() < cutoff, but returns as soon as a pair
+//! of atoms within the cutoff is found.
+//! @param Two Residue objects.
+//! @param Cutoff distance.
+//! @return True if the Residues are in contact.
+bool is_residue_contact(const Residue&, const Residue&, double);
+//! @brief Get bounding spheres (centroid and radius) of Residues.
+//! @param List of Residues.
+//! @param Centers of the spheres.
+//! @param Radii of the spheres (-1 for Residues without atoms).
+void get_bounding_spheres(const std::vector<Residue>&, std::vector<Vec3d>&, std::vector<double>&);
+//! @brief Get the contact map of a list of Residues.
+//!
+//! Residue pairs are pruned by the distance of their bounding spheres through
+//! a cell grid, then checked atom by atom with is_residue_contact().
+//! @param List of Residues.
+//! @param Cutoff distance.
+//! @param Minimum separation of indices, i.e. only j >= i + min_sep are kept.
+//! @return Contacts (i, j), i < j, sorted by i then j.
+std::vector<std::pair<int, int> > get_residue_contacts(const std::vector<Residue>&, double, int);
+//! @brief Get the contact map between two lists of Residues.
+//! @param Two lists of Residues.
+//! @param Cutoff distance.
+//! @return Contacts (i, j) with i in the first and j in the second list, sorted.
+std::vector<std::pair<int, int> > get_residue_contacts(const std::vector<Residue>&,
+                                                      const std::vector<Residue>&, double);
 }
 
 #endif
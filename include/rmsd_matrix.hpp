@@ -0,0 +1,194 @@
+/*!
+  @file rmsd_matrix.hpp
+  @brief Pairwise RMSD matrix of trajectory frames.
+
+  In this file class RmsdMatrix is defined, together with a function computing
+  the all-vs-all RMSD (after superimposition) of the frames of a dcd file.  Only
+  the upper triangle of the matrix is stored, in single or half precision, in a
+  compact binary file.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:08
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_RMSD_MATRIX_H_
+#define PINANG_RMSD_MATRIX_H_
+
+#include <cstdint>
+#include "dcd_mapped_reader.hpp"
+
+namespace pinang {
+
+/*!
+  @brief Symmetric matrix of RMSD between N frames.
+
+  Elements (i, j) with i < j are stored row by row, as float (4 bytes) or IEEE
+  half precision (2 bytes) numbers.  The binary file consists of a 32-byte
+  header (magic "PNRMSDMX", version, value size, N, first frame and stride of
+  the frames) followed by the N (N - 1) / 2 values.
+
+  The matrix is either kept in memory and written by write(), or created
+  directly in a file mapped into memory (out-of-core), in which case the pages
+  are written back by the system and the matrix may be larger than the RAM.
+  Different elements can be set by different threads at the same time.
+*/
+class RmsdMatrix
+{
+ public:
+  //! @brief Create an "empty" RmsdMatrix object.
+  //! @return An RmsdMatrix object.
+  RmsdMatrix();
+  virtual ~RmsdMatrix() { close(); }
+  //! The matrix may point into a mapped file, so it is not copyable.
+  RmsdMatrix(const RmsdMatrix&) = delete;
+  RmsdMatrix& operator=(const RmsdMatrix&) = delete;
+
+  //! @brief Create a matrix in memory, with all elements equal to 0.
+  //! @param Number of frames.
+  //! @param Size of values in bytes (2: half precision; 4: single precision).
+  //! @return Status of creating the matrix.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int create(int, int);
+  //! @brief Create a matrix in a file mapped into memory (out-of-core).
+  //! @param File name.
+  //! @param Number of frames.
+  //! @param Size of values in bytes (2 or 4).
+  //! @return Status of creating the matrix.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int create(const std::string&, int, int);
+  //! @brief Map an existing matrix file into memory (read only).
+  //! @param File name.
+  //! @return Status of opening the matrix.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int open(const std::string&);
+  //! @brief Write the matrix to a file.
+  //! @param File name.
+  //! @return Status of writing the matrix.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int write(const std::string&) const;
+  //! @brief Release the matrix (a mapped file is written back and unmapped).
+  void close();
+
+  //! @brief Check if the matrix is created or opened.
+  bool is_open() const { return data_ != 0; }
+  //! @brief Get number of frames N.
+  int get_size() const { return n_; }
+  //! @brief Get size of values in bytes.
+  int get_value_size() const { return value_size_; }
+  //! @brief Record which dcd frames the rows correspond to.
+  //! @param Index of the first frame.
+  //! @param Stride between two frames.
+  void set_frame_info(int, int);
+  //! @brief Get index of the dcd frame of row k.
+  int get_frame(int k) const { return frame_first_ + k * frame_stride_; }
+
+  //! @brief Get element (i, j).  Diagonal elements are 0.
+  double get(int, int) const;
+  //! @brief Set element (i, j), i != j.
+  void set(int, int, double);
+
+ protected:
+  //! @brief Get position of element (i, j), i < j, in the value array.
+  std::int64_t get_index(int i, int j) const
+  {
+    return (std::int64_t)i * (2 * (std::int64_t)n_ - i - 1) / 2 + (j - i - 1);
+  }
+  //! @brief Get size of the matrix file in bytes.
+  std::int64_t get_file_size() const;
+  //! @brief Write the header into the first bytes of data_.
+  void write_header();
+
+  int n_;                     //!< Number of frames.
+  int value_size_;            //!< Size of values in bytes.
+  int frame_first_;           //!< Index of the first frame.
+  int frame_stride_;          //!< Stride between two frames.
+  std::vector<char> buffer_;  //!< File image of a matrix in memory.
+  char* data_;                //!< Start of the file image (header).
+  char* values_;              //!< Start of the values.
+  std::size_t map_size_;      //!< Size of the mapped file (0: not mapped).
+  bool read_only_;            //!< Whether the matrix is read only.
+};
+
+/*!
+  @brief Selected atoms of trajectory frames, centered at the origin.
+
+  Every frame is centered once and stored in single precision, the frames of a
+  tile of frames in one CoordinateArray.  The RMSD after optimal superimposition
+  of any two frames is then obtained with the QCP method, without computing the
+  rotation.  get_rmsd() can be called by several threads at the same time.
+*/
+class CenteredFrames
+{
+ public:
+  //! @brief Create an "empty" CenteredFrames object.
+  //! @return A CenteredFrames object.
+  CenteredFrames(): n_frame_(0), n_atom_(0), tile_(64) {}
+  virtual ~CenteredFrames() {}
+
+  //! @brief Read and center the frames in the frame range of a dcd file.
+  //! @param Mapped dcd file (with frame range and atom subset, if needed).
+  //! @param Selection of atoms, as indices in the decoded frames.
+  //! @param Number of threads.  Non-positive value means all cores.
+  //! @param Number of frames in a tile.
+  //! @return Status of reading the frames.
+  //! @retval 1: Failure.
+  //! @retval 0: Success.
+  int load(const DcdMappedReader&, const Selection&, int, int = 64);
+
+  //! @brief Get number of frames.
+  int get_size() const { return n_frame_; }
+  //! @brief Get number of selected atoms in each frame.
+  int get_atom_number() const { return n_atom_; }
+  //! @brief Get number of frames in a tile.
+  int get_tile_size() const { return tile_; }
+  //! @brief Get the centered coordinates of frame k.
+  CoordinateView<float> get_frame(int k) const
+  {
+    const CoordinateArray<float>& f = tiles_[k / tile_];
+    const int offset = (k % tile_) * n_atom_;
+    return CoordinateView<float>(f.x() + offset, f.y() + offset, f.z() + offset, n_atom_);
+  }
+  //! @brief Get the RMSD between frames i and j after superimposition.
+  double get_rmsd(int, int) const;
+
+ protected:
+  std::vector<CoordinateArray<float> > tiles_;  //!< Centered coordinates, by tile.
+  std::vector<double> g_;                       //!< Sum of squared norms of each frame.
+  int n_frame_;                                 //!< Number of frames.
+  int n_atom_;                                  //!< Number of atoms in each frame.
+  int tile_;                                    //!< Number of frames in a tile.
+};
+
+//! @brief Compute the RMSD matrix of centered frames.
+//!
+//! Pairs of frames are processed in tiles, row of tiles by row of tiles, each
+//! tile by one thread.  Only pairs (i < j) are computed.
+//! @param Centered frames.
+//! @param Number of threads.  Non-positive value means all cores.
+//! @param RmsdMatrix of the same size, already created.
+//! @return Status of computing the matrix.
+//! @retval 1: Failure.
+//! @retval 0: Success.
+int compute_rmsd_matrix(const CenteredFrames&, int, RmsdMatrix&);
+//! @brief Compute the RMSD matrix of the frames in the frame range of a dcd file.
+//!
+//! The frames are read into CenteredFrames first, and the frame range is
+//! recorded in the matrix.
+//! @param Mapped dcd file (with frame range and atom subset, if needed).
+//! @param Selection of atoms, as indices in the decoded frames.
+//! @param Number of threads.  Non-positive value means all cores.
+//! @param RmsdMatrix of size get_range_size(), already created.
+//! @param Number of frames in a tile.
+//! @return Status of computing the matrix.
+//! @retval 1: Failure.
+//! @retval 0: Success.
+int compute_rmsd_matrix(const DcdMappedReader&, const Selection&, int, RmsdMatrix&, int = 64);
+
+}
+
+#endif
@@ -0,0 +1,87 @@
+/*!
+  @file rmsf.hpp
+  @brief Root mean square fluctuation (RMSF) from trajectories.
+
+  In this file class PositionAccumulator is defined, which accumulates mean and
+  fluctuation of positions frame by frame, and a function computing RMSF with
+  iterative alignment to the average structure.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:14
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_RMSF_H_
+#define PINANG_RMSF_H_
+
+#include "dcd_mapped_reader.hpp"
+
+namespace pinang {
+
+/*!
+  @brief Streaming mean and fluctuation of the positions of a set of particles.
+
+  Welford's algorithm is used, so that no frames are stored and the result is
+  stable even for long trajectories.  Accumulators of separate parts of a
+  trajectory can be merged (Chan et al.).
+*/
+class PositionAccumulator
+{
+ public:
+  //! @brief Create an "empty" PositionAccumulator object.
+  //! @return A PositionAccumulator object.
+  PositionAccumulator(): n_frame_(0), n_atom_(0) {}
+  virtual ~PositionAccumulator() {}
+
+  //! @brief Reset to zero frames of a given number of particles.
+  //! @param Number of particles.
+  void reset(int);
+  //! @brief Add positions of one frame.
+  //! @param Coordinates of the particles.
+  void add(const CoordinateView<double>&);
+  //! @brief Merge another accumulator (of the same particles) into this one.
+  void merge(const PositionAccumulator&);
+
+  //! @brief Get number of frames added.
+  long get_frame_number() const { return n_frame_; }
+  //! @brief Get number of particles.
+  int get_size() const { return n_atom_; }
+  //! @brief Get mean position of particle i.
+  Vec3d get_mean(int i) const { return Vec3d(mean_[3 * i], mean_[3 * i + 1], mean_[3 * i + 2]); }
+  //! @brief Get mean positions of all the particles.
+  CoordinateArray<double> get_mean() const;
+  //! @brief Get RMSF of particle i: sqrt(<|r - <r>|^2>).
+  double get_rmsf(int i) const;
+
+ protected:
+  long n_frame_;             //!< Number of frames.
+  int n_atom_;               //!< Number of particles.
+  std::vector<double> mean_;  //!< Mean positions (x, y, z of each particle).
+  std::vector<double> m2_;    //!< Sum of squared deviations from the mean.
+};
+
+//! @brief Compute RMSF with iterative alignment to the average structure.
+//!
+//! In each iteration every frame is superimposed onto the reference by the
+//! fitting atoms, and the aligned positions are accumulated; the average of
+//! the fitting atoms becomes the reference of the next iteration.  The first
+//! reference is the first frame of the frame range.  Iterations stop when the
+//! reference moves less than the tolerance (RMSD), or after the maximum number
+//! of iterations (with a warning).  Each iteration is one pass over the
+//! trajectory, with frames split into contiguous chunks processed in parallel;
+//! chunk results are merged in order, so that the result does not depend on
+//! thread scheduling.
+//! @param Mapped dcd file (with frame range and atom subset, if needed).
+//! @param Selection of atoms used for fitting, as indices in decoded frames.
+//! @param Selection of atoms whose RMSF is computed.
+//! @param Number of threads.  Non-positive value means all cores.
+//! @param PositionAccumulator of the RMSF atoms in the last iteration (output).
+//! @param Maximum number of iterations (>= 1).
+//! @param Tolerance of the change of the reference (RMSD).
+//! @return Number of iterations, or -1 on failure.
+int compute_rmsf(const DcdMappedReader&, const Selection&, const Selection&, int,
+                 PositionAccumulator&, int = 20, double = 1e-4);
+
+}
+
+#endif
@@ -0,0 +1,95 @@
+/*!
+  @file sasa.hpp
+  @brief Solvent accessible surface area (Shrake-Rupley).
+
+  In this file class ShrakeRupley is defined, with functions giving atomic and
+  CG bead radii.  Each atom is covered by a fixed set of points, generated on
+  a golden spiral; the fraction of points not buried in any neighbouring
+  (probe-inflated) sphere gives the accessible area of the atom.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:42
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_SASA_H_
+#define PINANG_SASA_H_
+
+#include <string>
+#include <vector>
+#include "atom.hpp"
+
+namespace pinang {
+
+//! @brief Get van der Waals radius (Bondi) of an element.
+//! @param Element symbol (e.g. "C", "N", "FE").  Unknown elements get 1.8.
+//! @return Radius.
+double get_vdw_radius(const std::string&);
+//! @brief Get van der Waals radius of an atom.
+//!
+//! The element column is used if present, otherwise the element is guessed
+//! from the atom name.
+//! @param Atom.
+//! @return Radius.
+double get_atom_radius(const Atom&);
+//! @brief Get radius of a CG bead.
+//! @param Bead (atom) name: CA for amino acids, DP/DS/DB (P/S/B) for nucleotides.
+//! @return Radius.  Unknown beads get the radius of CA.
+double get_cg_radius(const std::string&);
+
+/*!
+  @brief Shrake-Rupley calculation of solvent accessible surface area.
+
+  Every atom i is inflated to R_i = r_i + probe.  Neighbours (overlapping
+  inflated spheres) are found with a cell list, and each sphere point is tested
+  against them, starting from the last neighbour which buried a point.
+
+  @code
+  pinang::ShrakeRupley sr(960, 1.4);
+  std::vector<double> area;
+  sr.compute(coors, radii, area, n_thread);
+  @endcode
+*/
+class ShrakeRupley
+{
+ public:
+  //! @brief Create a ShrakeRupley object (960 points, probe radius 1.4).
+  //! @return A ShrakeRupley object.
+  ShrakeRupley();
+  //! @brief Create a ShrakeRupley object.
+  //! @param Number of points on each sphere.
+  //! @param Probe radius.
+  //! @return A ShrakeRupley object.
+  ShrakeRupley(int, double);
+  virtual ~ShrakeRupley() {}
+
+  //! @brief Set number of points on each sphere.
+  void set_point_number(int);
+  //! @brief Get number of points on each sphere.
+  int get_point_number() const { return int(ux_.size()); }
+  //! @brief Set probe radius.
+  void set_probe(double r) { probe_ = r; }
+  //! @brief Get probe radius.
+  double get_probe() const { return probe_; }
+
+  //! @brief Compute accessible surface area of every atom.
+  //! @param Coordinates.
+  //! @param Radii.
+  //! @param Accessible area of every atom.
+  //! @param Number of threads (over atoms).  Non-positive value means all cores.
+  //! @return Status of computing areas.
+  //! @retval 1: Failure (sizes of coordinates and radii don't match).
+  //! @retval 0: Success.
+  int compute(const std::vector<Vec3d>&, const std::vector<double>&,
+              std::vector<double>&, int) const;
+
+ protected:
+  std::vector<double> ux_;  //!< X components of unit sphere points.
+  std::vector<double> uy_;  //!< Y components of unit sphere points.
+  std::vector<double> uz_;  //!< Z components of unit sphere points.
+  double probe_;            //!< Probe radius.
+};
+
+}
+
+#endif
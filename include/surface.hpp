@@ -0,0 +1,102 @@
+/*!
+  @file surface.hpp
+  @brief Grid-based detection of surface atoms.
+
+  In this file class SurfaceGrid is defined.  A rectangular grid is laid over
+  the structure; grid points farther than the probe (tip) size from all atoms
+  are "solvent" points, and the atom nearest to each solvent point is a
+  surface atom.  Atoms are binned into cells, so that each grid point only
+  checks the atoms nearby, and the grid is swept by several threads.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:39
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_SURFACE_H_
+#define PINANG_SURFACE_H_
+
+#include <vector>
+#include "neighbor_search.hpp"
+
+namespace pinang {
+
+/*!
+  @brief Solvent grid and surface atoms of a structure.
+
+  Two ways of assigning solvent points to atoms are provided:
+  - nearest atom (default): every solvent point is assigned to the atom
+    nearest to it, exactly as a full scan over all the atoms would do;
+  - distance transform: an exact Euclidean distance transform of the grid
+    finds, for every solvent point, the nearest non-solvent grid point, whose
+    nearest atom is taken.  The cost is linear in the number of grid points,
+    independent of how far the solvent points are from the structure.
+
+  @code
+  pinang::SurfaceGrid grid(2.0, 4.0, 8.0);
+  grid.compute(coors, n_thread);
+  const std::vector<int>& flags = grid.get_surface_flags();
+  @endcode
+*/
+class SurfaceGrid
+{
+ public:
+  //! @brief Create a SurfaceGrid object with default parameters.
+  //! @return A SurfaceGrid object.
+  SurfaceGrid();
+  //! @brief Create a SurfaceGrid object.
+  //! @param Grid spacing.
+  //! @param Probe (tip) size.
+  //! @param Padding of the grid around the structure.
+  //! @return A SurfaceGrid object.
+  SurfaceGrid(double, double, double);
+  virtual ~SurfaceGrid() {}
+
+  //! @brief Use the distance transform to assign solvent points to atoms.
+  void set_distance_transform(bool f) { use_edt_ = f; }
+
+  //! @brief Compute solvent grid points and surface atoms.
+  //! @param Coordinates of atoms.
+  //! @param Number of threads.  Non-positive value means all cores.
+  //! @return Status of computing surface.
+  //! @retval 1: Failure (no atoms or non-positive parameters).
+  //! @retval 0: Success.
+  int compute(const std::vector<Vec3d>&, int);
+
+  //! @brief Get number of grid points along dimension d.
+  int get_grid_number(int d) const { return int(grid_real_[d].size()); }
+  //! @brief Get total number of grid points.
+  int get_grid_number() const { return int(solvent_.size()); }
+  //! @brief Check if grid point (ix, iy, iz) is a solvent point.
+  bool is_solvent(int ix, int iy, int iz) const { return solvent_[get_point(ix, iy, iz)] != 0; }
+  //! @brief Get number of solvent grid points.
+  int get_solvent_number() const;
+  //! @brief Get surface flag (0 or 1) of every atom.
+  const std::vector<int>& get_surface_flags() const { return surface_flag_; }
+
+ protected:
+  //! @brief Get linear index of grid point (ix, iy, iz).
+  int get_point(int ix, int iy, int iz) const
+  {
+    return (ix * get_grid_number(1) + iy) * get_grid_number(2) + iz;
+  }
+  //! @brief Get coordinate of grid point.
+  Vec3d get_point_coordinate(int) const;
+  //! @brief Find the nearest non-solvent point of every solvent point.
+  //! @param Number of threads.
+  //! @param Linear index of the nearest non-solvent point (-1 if none).
+  void distance_transform(int, std::vector<int>&) const;
+
+  double grid_size_;                  //!< Grid spacing.
+  double tip_size_;                   //!< Probe size.
+  double padding_;                    //!< Padding around the structure.
+  bool use_edt_;                      //!< Assign solvent points by distance transform.
+  std::vector<double> grid_real_[3];  //!< Coordinates of grid planes along x, y, z.
+  std::vector<char> solvent_;         //!< Solvent flag of every grid point.
+  std::vector<int> surface_flag_;     //!< Surface flag of every atom.
+  CellList cells_;                    //!< Cell list of atoms.
+};
+
+}
+
+#endif
@@ -0,0 +1,359 @@
+/*!
+  @file system.hpp
+  @brief Flat (structure of arrays) representation of a molecular system.
+
+  In this file class System is defined.  All the atoms of a Model are stored in
+  one set of columns (coordinates, packed and interned names, residue and chain
+  indices); residues and chains are ranges given by offset arrays.  The
+  light-weight proxies AtomView, ResidueView and ChainView navigate a System in
+  the same way as Atom, Residue and Chain, without copying anything.  A System
+  is filled from a Model, or read directly from a PDB file.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:55
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_SYSTEM_H_
+#define PINANG_SYSTEM_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "model.hpp"
+#include "coordinate_array.hpp"
+
+namespace pinang {
+
+/*!
+  @brief Table of interned strings.
+
+  Each distinct string is stored once and referred to by a small integer id.
+*/
+class NameTable
+{
+ public:
+  //! @brief Create an "empty" NameTable object.
+  NameTable() {}
+
+  //! @brief Remove all the names.
+  void reset() { names_.clear(); ids_.clear(); }
+  //! @brief Get id of a name, adding it to the table if it is new.
+  //! @param Name.
+  //! @return Id of the name.
+  int intern(const std::string&);
+  //! @brief Get name by id.
+  //! @param Id of the name.
+  const std::string& get_name(int i) const { return names_[i]; }
+  //! @brief Get number of distinct names.
+  int get_size() const { return int(names_.size()); }
+
+ protected:
+  std::vector<std::string> names_;                //!< Distinct names.
+  std::unordered_map<std::string, int> ids_;      //!< Id of each name.
+};
+
+class System;
+class ResidueView;
+class ChainView;
+
+/*!
+  @brief Read-only proxy of an atom in a System.
+
+  The getters have the same names as those of Atom.
+*/
+class AtomView
+{
+ public:
+  AtomView(const System* s, int i): s_(s), i_(i) {}
+
+  //! @brief Get index of the atom in System.
+  int get_index() const { return i_; }
+
+  RecordName get_record_name() const;
+  int get_atom_serial() const;
+  AtomName get_atom_name() const;
+  char get_alt_loc() const;
+  ResidueName get_residue_name() const;
+  char get_chain_ID() const;
+  int get_residue_serial() const;
+  char get_icode() const;
+  Vec3d get_coordinate() const;
+  double get_occupancy() const;
+  double get_temperature_factor() const;
+  SegmentName get_segment_ID() const;
+  ElementName get_element() const;
+  ChargeName get_charge() const;
+
+  //! @brief Get the residue of the atom.
+  ResidueView get_residue() const;
+  //! @brief Get the chain of the atom.
+  ChainView get_chain() const;
+  //! @brief Make a copy of the atom as an Atom object.
+  Atom to_atom() const;
+
+ protected:
+  const System* s_;  //!< System of the atom.
+  int i_;            //!< Atom index.
+};
+
+/*!
+  @brief Read-only proxy of a residue in a System.
+
+  The getters have the same names as those of Residue.
+*/
+class ResidueView
+{
+ public:
+  ResidueView(const System* s, int i): s_(s), i_(i) {}
+
+  //! @brief Get index of the residue in System.
+  int get_index() const { return i_; }
+
+  const std::string& get_residue_name() const;
+  const std::string& get_short_name() const;
+  char get_chain_ID() const;
+  ChainType get_chain_type() const;
+  int get_residue_serial() const;
+  int get_terminus_flag() const;
+  double get_residue_charge() const;
+  double get_residue_mass() const;
+  double get_sasa() const;
+
+  //! @brief Get number of atoms in the residue.
+  int get_size() const;
+  //! @brief Get index (in System) of the first atom of the residue.
+  int get_atom_offset() const;
+  //! @brief Get an atom of the residue.
+  //! @param Index of the atom in the residue.
+  AtomView get_atom(int) const;
+  //! @brief Get the chain of the residue.
+  ChainView get_chain() const;
+
+ protected:
+  const System* s_;  //!< System of the residue.
+  int i_;            //!< Residue index.
+};
+
+/*!
+  @brief Read-only proxy of a chain in a System.
+
+  The getters have the same names as those of Chain.
+*/
+class ChainView
+{
+ public:
+  ChainView(const System* s, int i): s_(s), i_(i) {}
+
+  //! @brief Get index of the chain in System.
+  int get_index() const { return i_; }
+
+  char get_chain_ID() const;
+  ChainType get_chain_type() const;
+
+  //! @brief Get number of residues in the chain.
+  int get_size() const;
+  //! @brief Get index (in System) of the first residue of the chain.
+  int get_residue_offset() const;
+  //! @brief Get a residue of the chain.
+  //! @param Index of the residue in the chain.
+  ResidueView get_residue(int) const;
+  //! @brief Get number of atoms in the chain.
+  int get_atom_number() const;
+
+ protected:
+  const System* s_;  //!< System of the chain.
+  int i_;            //!< Chain index.
+};
+
+/*!
+  @brief Molecular system stored as flat columns.
+
+  Atom i belongs to residue get_atom_residue(i); the atoms of residue r are
+  [residue_start_[r], residue_start_[r + 1]), and the residues of chain c are
+  [chain_start_[c], chain_start_[c + 1]).  Coordinates are three contiguous
+  arrays, so get_view() can be passed to the analysis code directly.
+
+  @code
+  pinang::System sys(pdb.get_model(0));
+  for (int c = 0; c < sys.get_chain_number(); ++c) {
+    pinang::ChainView chain = sys.get_chain(c);
+    for (int r = 0; r < chain.get_size(); ++r)
+      std::cout << chain.get_residue(r).get_residue_name() << "\n";
+  }
+  pinang::Model mdl = sys.get_model();
+
+  pinang::System sys_1;
+  if (sys_1.read_pdb("some.pdb", 1) == 0) { ... }  // second model, no Model built
+  @endcode
+*/
+class System
+{
+ public:
+  //! @brief Create an "empty" System object.
+  //! @return A System object.
+  System();
+  //! @brief Create a System object from a Model.
+  //! @param Model.
+  //! @return A System object.
+  explicit System(const Model&);
+  virtual ~System() {}
+
+  //! @brief Remove all the atoms, residues and chains.
+  void reset();
+  //! @brief Fill the System with the atoms of a Model.
+  //! @param Model.
+  void set_model(const Model&);
+  //! @brief Fill the System with a model of a PDB file, without building a PDB or Model.
+  //!
+  //! Records are read with PDBReader and grouped into residues and chains by
+  //! the same rules as PDB::PDB(), so the System equals System(pdb.get_model(n)).
+  //! @param PDB file name.
+  //! @param Index of the model (0 for the first one).
+  //! @return Status of reading the model.
+  //! @retval 1: Failure (file not readable, inconsistent chain, or no such model).
+  //! @retval 0: Success.
+  int read_pdb(const std::string&, int = 0);
+  //! @brief Convert the System back to a Model.
+  //!
+  //! The CG beads and terminus flags are set up again by Residue and Chain.
+  //! @return A Model object.
+  Model get_model() const;
+
+  //! @brief Get model serial number.
+  int get_model_serial() const { return model_serial_; }
+
+  //! @brief Get number of atoms.
+  int get_atom_number() const { return int(x_.size()); }
+  //! @brief Get number of residues.
+  int get_residue_number() const { return int(residue_start_.size()) - 1; }
+  //! @brief Get number of chains.
+  int get_chain_number() const { return int(chain_start_.size()) - 1; }
+
+  //! @brief Get proxy of an atom.
+  AtomView get_atom(int i) const { return AtomView(this, i); }
+  //! @brief Get proxy of a residue.
+  ResidueView get_residue(int i) const { return ResidueView(this, i); }
+  //! @brief Get proxy of a chain.
+  ChainView get_chain(int i) const { return ChainView(this, i); }
+
+  //! @brief Get residue index of an atom.
+  int get_atom_residue(int i) const { return atom_residue_[i]; }
+  //! @brief Get chain index of an atom.
+  int get_atom_chain(int i) const { return atom_chain_[i]; }
+  //! @brief Get chain index of a residue.
+  int get_residue_chain(int r) const { return residue_chain_[r]; }
+  //! @brief Get index of the first atom of residue r (r == number of residues is allowed).
+  int get_residue_start(int r) const { return residue_start_[r]; }
+  //! @brief Get index of the first residue of chain c (c == number of chains is allowed).
+  int get_chain_start(int c) const { return chain_start_[c]; }
+
+  //! @brief Get coordinate of an atom.
+  Vec3d get_coordinate(int i) const { return Vec3d(x_[i], y_[i], z_[i]); }
+  //! @brief Set coordinate of an atom.
+  void set_coordinate(int i, const Vec3d& v) { x_[i] = v.x(); y_[i] = v.y(); z_[i] = v.z(); }
+  //! @brief Get view of all the coordinates (stride 1).
+  CoordinateView<double> get_view() const
+  {
+    return CoordinateView<double>(x_.data(), y_.data(), z_.data(), get_atom_number());
+  }
+  //! @brief Replace all the coordinates, e.g. with a frame of a trajectory.
+  //! @param Coordinates.
+  //! @return Status of setting coordinates.
+  //! @retval 1: Failure (wrong number of coordinates).
+  //! @retval 0: Success.
+  int set_coordinates(const CoordinateView<double>&);
+
+  //! @brief Get the table of interned (residue) names.
+  const NameTable& get_names() const { return names_; }
+
+  friend class AtomView;
+  friend class ResidueView;
+  friend class ChainView;
+
+ protected:
+  NameTable names_;          //!< Interned residue names.
+  int model_serial_;         //!< Model serial number.
+
+  // atoms;
+  std::vector<double> x_;             //!< x coordinates.
+  std::vector<double> y_;             //!< y coordinates.
+  std::vector<double> z_;             //!< z coordinates.
+  std::vector<int> atom_serial_;      //!< Atom serial numbers.
+  std::vector<AtomName> atom_name_;   //!< Atom names.
+  std::vector<RecordName> record_name_;  //!< Record names ("ATOM  ", "HETATM").
+  std::vector<char> alt_loc_;         //!< Alternate location indicators.
+  std::vector<char> icode_;           //!< Insertion codes.
+  std::vector<double> occupancy_;     //!< Occupancies.
+  std::vector<double> b_factor_;      //!< Temperature factors.
+  std::vector<SegmentName> seg_ID_;   //!< Segment identifiers.
+  std::vector<ElementName> element_;  //!< Element symbols.
+  std::vector<ChargeName> atom_charge_;  //!< Atom charges.
+  std::vector<int> atom_residue_;     //!< Residue index of each atom.
+  std::vector<int> atom_chain_;       //!< Chain index of each atom.
+
+  // residues;
+  std::vector<int> residue_start_;    //!< Atom offsets of residues (size: residues + 1).
+  std::vector<int> residue_name_;     //!< Residue name ids.
+  std::vector<int> short_name_;       //!< Short residue name ids.
+  std::vector<int> residue_serial_;   //!< Residue serial numbers.
+  std::vector<int> residue_chain_;    //!< Chain index of each residue.
+  std::vector<int> terminus_flag_;    //!< Terminus flags.
+  std::vector<double> residue_mass_;  //!< Residue masses.
+  std::vector<double> residue_charge_;  //!< Residue charges.
+  std::vector<double> sasa_;          //!< Residue SASA.
+
+  // chains;
+  std::vector<int> chain_start_;      //!< Residue offsets of chains (size: chains + 1).
+  std::vector<char> chain_ID_;        //!< Chain identifiers.
+  std::vector<ChainType> chain_type_;  //!< Chain types.
+};
+
+// AtomView ================================================================
+inline RecordName AtomView::get_record_name() const { return s_->record_name_[i_]; }
+inline int AtomView::get_atom_serial() const { return s_->atom_serial_[i_]; }
+inline AtomName AtomView::get_atom_name() const { return s_->atom_name_[i_]; }
+inline char AtomView::get_alt_loc() const { return s_->alt_loc_[i_]; }
+inline ResidueName AtomView::get_residue_name() const { return ResidueName(get_residue().get_residue_name()); }
+inline char AtomView::get_chain_ID() const { return s_->chain_ID_[s_->atom_chain_[i_]]; }
+inline int AtomView::get_residue_serial() const { return s_->residue_serial_[s_->atom_residue_[i_]]; }
+inline char AtomView::get_icode() const { return s_->icode_[i_]; }
+inline Vec3d AtomView::get_coordinate() const { return s_->get_coordinate(i_); }
+inline double AtomView::get_occupancy() const { return s_->occupancy_[i_]; }
+inline double AtomView::get_temperature_factor() const { return s_->b_factor_[i_]; }
+inline SegmentName AtomView::get_segment_ID() const { return s_->seg_ID_[i_]; }
+inline ElementName AtomView::get_element() const { return s_->element_[i_]; }
+inline ChargeName AtomView::get_charge() const { return s_->atom_charge_[i_]; }
+inline ResidueView AtomView::get_residue() const { return ResidueView(s_, s_->atom_residue_[i_]); }
+inline ChainView AtomView::get_chain() const { return ChainView(s_, s_->atom_chain_[i_]); }
+
+// ResidueView =============================================================
+inline const std::string& ResidueView::get_residue_name() const { return s_->names_.get_name(s_->residue_name_[i_]); }
+inline const std::string& ResidueView::get_short_name() const { return s_->names_.get_name(s_->short_name_[i_]); }
+inline char ResidueView::get_chain_ID() const { return s_->chain_ID_[s_->residue_chain_[i_]]; }
+inline ChainType ResidueView::get_chain_type() const { return s_->chain_type_[s_->residue_chain_[i_]]; }
+inline int ResidueView::get_residue_serial() const { return s_->residue_serial_[i_]; }
+inline int ResidueView::get_terminus_flag() const { return s_->terminus_flag_[i_]; }
+inline double ResidueView::get_residue_charge() const { return s_->residue_charge_[i_]; }
+inline double ResidueView::get_residue_mass() const { return s_->residue_mass_[i_]; }
+inline double ResidueView::get_sasa() const { return s_->sasa_[i_]; }
+inline int ResidueView::get_size() const { return s_->residue_start_[i_ + 1] - s_->residue_start_[i_]; }
+inline int ResidueView::get_atom_offset() const { return s_->residue_start_[i_]; }
+inline AtomView ResidueView::get_atom(int k) const { return AtomView(s_, s_->residue_start_[i_] + k); }
+inline ChainView ResidueView::get_chain() const { return ChainView(s_, s_->residue_chain_[i_]); }
+
+// ChainView ===============================================================
+inline char ChainView::get_chain_ID() const { return s_->chain_ID_[i_]; }
+inline ChainType ChainView::get_chain_type() const { return s_->chain_type_[i_]; }
+inline int ChainView::get_size() const { return s_->chain_start_[i_ + 1] - s_->chain_start_[i_]; }
+inline int ChainView::get_residue_offset() const { return s_->chain_start_[i_]; }
+inline ResidueView ChainView::get_residue(int k) const { return ResidueView(s_, s_->chain_start_[i_] + k); }
+inline int ChainView::get_atom_number() const
+{
+  return s_->residue_start_[s_->chain_start_[i_ + 1]] - s_->residue_start_[s_->chain_start_[i_]];
+}
+
+}
+
+#endif
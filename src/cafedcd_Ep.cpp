@@ -9,7 +9,7 @@
   @copyright GNU Public License V3.0
 */
 
-#include "read_cafemol_dcd.hpp"
+#include "parallel_frames.hpp"
 #include "ff_protein_DNA_specific.hpp"
 
 #include <iomanip>
@@ -25,9 +25,15 @@ void print_usage(char* s);
 int main(int argc, char *argv[])
 {
   int opt;
+  int frame_first = 0;
+  int frame_last = 0;
+  int frame_stride = 1;
+  bool use_index = false;
+  int n_thread = 1;
   int out_flag = 0;
   double ene_pdss_shift = 0.0;
   double ene_pdss_scale = 1.0;
+  double skin = 2.0;
 
   string dcd_name = "please_provide_name.dcd";
   string top_name = "please_provide_name.psf";
@@ -35,7 +41,7 @@ int main(int argc, char *argv[])
   string ene_name = "please_provide_name.dat";
   string basefilename = "";
 
-  while ((opt = getopt(argc, argv, "f:s:p:o:T:S:h")) != -1) {
+  while ((opt = getopt(argc, argv, "f:s:p:o:T:S:v:b:e:k:n:Ih")) != -1) {
     switch (opt) {
       case 'f':
         dcd_name = optarg;
@@ -57,6 +63,24 @@ int main(int argc, char *argv[])
       case 'T':
         ene_pdss_scale = atof(optarg);
         break;
+      case 'v':
+        skin = atof(optarg);
+        break;
+      case 'b':
+        frame_first = atoi(optarg);
+        break;
+      case 'e':
+        frame_last = atoi(optarg);
+        break;
+      case 'k':
+        frame_stride = atoi(optarg);
+        break;
+      case 'n':
+        n_thread = atoi(optarg);
+        break;
+      case 'I':
+        use_index = true;
+        break;
       case 'h':
         print_usage(argv[0]);
         break;
@@ -69,30 +93,29 @@ int main(int argc, char *argv[])
   if (out_flag == 0) {
     ene_name = basefilename + "_Ep.dat";
   }
-  ifstream dcd_file(dcd_name.c_str(), ifstream::binary);
   ofstream ene_file(ene_name.c_str());
   pinang::Topology top(top_name);
-  pinang::Conformation conf_tmp;
 
   // ------------------------------ Reading DCD --------------------------------
-  vector<pinang::Conformation> conformations;
-  pinang::read_cafemol_dcd(dcd_file, conformations);
-  int nframe = conformations.size();
-  if (nframe == 0)
+  pinang::DcdMappedReader dcd_map(dcd_name, use_index);
+  if (!dcd_map.is_open() || dcd_map.frame_count() == 0)
   {
     cout << " ERROR: Empty DCD file!  Please check! " << "\n";
     return 1;
   }
-  if (top.get_size() != conformations[0].get_size())
+  if (top.get_size() != dcd_map.get_natom())
   {
     cout << " ERROR: Particle number don't match in top and dcd! "
          << " Please check! " << "\n";
     return 1;
   }
+  if (dcd_map.set_frame_range(frame_first, frame_last, frame_stride))
+  {
+    print_usage(argv[0]);
+  }
 
   // ------------------------------ Calculating energies --------------------------
   double total_energy_0 = 0;
-  double ene_pdss = 0;
   double ene_ele = 0;
 
   pinang::FFProteinDNASpecific ff_ss(ffp_name);
@@ -100,16 +123,24 @@ int main(int argc, char *argv[])
   ff_ss.set_energy_scaling_factor(ene_pdss_scale);
 
   cout << " Calculating energies from dcd file : " << dcd_name << " ... " << endl;
-  for (int i= 0; i < nframe; ++i) {
-    conf_tmp = conformations[i];
-    // ------------------------------ PDSS ------------------------------
-    ene_pdss = ff_ss.compute_energy_protein_DNA_specific(top, conf_tmp);
-    ene_file << setw(6) << i
-             << "   " << setw(8) << ene_pdss
+  vector<double> ene_frames(dcd_map.get_range_size());
+  // each thread keeps its own Verlet list;
+  vector<pinang::VerletList> pair_lists(pinang::get_thread_number(n_thread),
+                                        pinang::VerletList(0.0, skin));
+  if (pinang::parallel_for_frames(dcd_map, n_thread, [&](int t, int k, pinang::Conformation& conf) {
+        // ------------------------------ PDSS ------------------------------
+        ene_frames[k] = ff_ss.compute_energy_protein_DNA_specific(top, conf, pair_lists[t]);
+      }))
+  {
+    cout << " ERROR: Cannot read all the frames from dcd file!  Please check! " << "\n";
+    return 1;
+  }
+  for (int k = 0; k < dcd_map.get_range_size(); ++k) {
+    ene_file << setw(6) << dcd_map.get_range_frame(k)
+             << "   " << setw(8) << ene_frames[k]
              << "\n";
   }
 
-  dcd_file.close();
   ene_file.close();
 
   return 0;
@@ -119,7 +150,8 @@ void print_usage(char* s)
 {
   cout << " Usage: "
        << s
-       << " -f xxx.dcd -s xxx.psf -p xxx.ffp [-S PDSS_energy_shift] [-T PDSS_energy_scale] [-o xxx_Ep.dat] [-h]"
+       << " -f xxx.dcd -s xxx.psf -p xxx.ffp [-S PDSS_energy_shift] [-T PDSS_energy_scale] [-v skin(real)] [-o xxx_Ep.dat] [-b first_frame] [-e last_frame] [-k stride] [-I] [-n threads] [-h]"
        << endl;
+  cout << " -I: build frame index file xxx.dcdidx (an up-to-date one is always used). \n";
   exit(EXIT_SUCCESS);
 }
@@ -0,0 +1,186 @@
+/*!
+  @file cafedcd_Q.cpp
+  @brief Calculate fraction of native contacts (Q) from MD trajectory (dcd file).
+
+  Read DCD (CafeMol) file, calculate Q, Q_intra and Q_inter of every frame.
+  Native contacts are read from a CG force field file, or derived from a
+  reference structure (atomistic PDB, or CG crd with a topology).
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:32
+  @copyright GNU Public License V3.0
+*/
+
+#include "native_contacts.hpp"
+#include "parallel_frames.hpp"
+#include "PDB.hpp"
+
+#include <iomanip>
+#include <fstream>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace std;
+
+void print_usage(char* s);
+
+int main(int argc, char *argv[])
+{
+  int opt;
+  int frame_first = 0;
+  int frame_last = 0;
+  int frame_stride = 1;
+  bool use_index = false;
+  int n_thread = 1;
+  int ffp_flag = 0;
+  int ref_flag = 0;
+  double tolerance = 1.2;
+  double cutoff = 8.0;
+  int min_sep = 4;
+
+  string dcd_name = "please_provide_name.dcd";
+  string top_name = "please_provide_name.psf";
+  string ffp_name = "please_provide_name.ffp";
+  string ref_name = "please_provide_name.pdb";
+  string q_name = "please_provide_name.dat";
+
+  while ((opt = getopt(argc, argv, "f:s:p:r:c:m:t:o:b:e:k:n:Ih")) != -1) {
+    switch (opt) {
+      case 'f':
+        dcd_name = optarg;
+        break;
+      case 's':
+        top_name = optarg;
+        break;
+      case 'p':
+        ffp_name = optarg;
+        ffp_flag = 1;
+        break;
+      case 'r':
+        ref_name = optarg;
+        ref_flag = 1;
+        break;
+      case 'c':
+        cutoff = atof(optarg);
+        break;
+      case 'm':
+        min_sep = atoi(optarg);
+        break;
+      case 't':
+        tolerance = atof(optarg);
+        break;
+      case 'o':
+        q_name = optarg;
+        break;
+      case 'b':
+        frame_first = atoi(optarg);
+        break;
+      case 'e':
+        frame_last = atoi(optarg);
+        break;
+      case 'k':
+        frame_stride = atoi(optarg);
+        break;
+      case 'n':
+        n_thread = atoi(optarg);
+        break;
+      case 'I':
+        use_index = true;
+        break;
+      case 'h':
+        print_usage(argv[0]);
+        break;
+      default: /* '?' */
+        print_usage(argv[0]);
+    }
+  }
+  if (ffp_flag + ref_flag != 1)
+  {
+    cout << " ERROR: Please provide either -p xxx.ffp or -r reference! " << "\n";
+    print_usage(argv[0]);
+  }
+
+  // ------------------------------ Native contacts ----------------------------
+  pinang::NativeContacts contacts;
+  contacts.set_tolerance(tolerance);
+  if (ffp_flag) {
+    if (contacts.read_ffp(ffp_name))
+      return 1;
+  } else if (ref_name.size() > 4 && ref_name.substr(ref_name.size() - 4) == ".pdb") {
+    pinang::PDB pdb_ref(ref_name);
+    if (contacts.set_contacts(pdb_ref.get_model(0)))
+      return 1;
+  } else {
+    pinang::Topology top(top_name);
+    pinang::Conformation conf_ref(ref_name);
+    if (contacts.set_contacts(conf_ref, top, cutoff, min_sep))
+      return 1;
+  }
+  cout << " Number of native contacts: " << contacts.get_size()
+       << " (intra: " << contacts.get_intra_number()
+       << ", inter: " << contacts.get_inter_number() << ")\n";
+  if (contacts.get_size() == 0)
+  {
+    cout << " ERROR: No native contacts found!  Please check! " << "\n";
+    return 1;
+  }
+
+  // ------------------------------ Reading DCD --------------------------------
+  pinang::DcdMappedReader dcd_map(dcd_name, use_index);
+  if (!dcd_map.is_open() || dcd_map.frame_count() == 0)
+  {
+    cout << " ERROR: Empty DCD file!  Please check! " << "\n";
+    return 1;
+  }
+  if (dcd_map.set_frame_range(frame_first, frame_last, frame_stride))
+  {
+    print_usage(argv[0]);
+  }
+  // only the particles in contacts are decoded;
+  pinang::Selection sel_atoms(contacts.get_atoms());
+  vector<pinang::Selection> sel_all = {sel_atoms};
+  if (dcd_map.set_atom_subset(sel_all))
+    return 1;
+  if (contacts.renumber(sel_atoms, dcd_map.get_subset_selection(sel_atoms)))
+    return 1;
+
+  // ------------------------------ Calculating Q ------------------------------
+  cout << " Calculating Q from dcd file : " << dcd_name << " ... " << endl;
+  int n_frame = dcd_map.get_range_size();
+  vector<double> q(n_frame), q_intra(n_frame), q_inter(n_frame);
+  if (pinang::parallel_for_frames(dcd_map, n_thread, [&](int, int k, pinang::Conformation& conf) {
+        contacts.compute_q(conf, q[k], q_intra[k], q_inter[k]);
+      }))
+  {
+    cout << " ERROR: Cannot read all the frames from dcd file!  Please check! " << "\n";
+    return 1;
+  }
+
+  ofstream q_file(q_name.c_str());
+  for (int k = 0; k < n_frame; ++k) {
+    q_file << setw(6) << dcd_map.get_range_frame(k)
+           << "   " << setw(8) << q[k]
+           << "   " << setw(8) << q_intra[k]
+           << "   " << setw(8) << q_inter[k]
+           << "\n";
+  }
+  q_file.close();
+
+  return 0;
+}
+
+void print_usage(char* s)
+{
+  cout << " Usage: "
+       << s
+       << " -f xxx.dcd (-p xxx_cg.ffp | -r ref.pdb | -r ref.crd -s xxx.psf [-c cutoff(real)] [-m min_seq_separation])"
+       << " [-t tolerance(real)] [-o xxx_Q.dat] [-b first_frame] [-e last_frame] [-k stride] [-I] [-n threads] [-h]"
+       << "\n";
+  cout << " -I: build frame index file xxx.dcdidx (an up-to-date one is always used). \n";
+  cout << " Native contacts are read from the [ native ] block of a CG ffp file (pdb_cg_top -P),"
+       << " or derived from a reference structure.\n"
+       << " A contact is formed if its distance < tolerance (default 1.2) * native distance.\n"
+       << " Output columns: frame, Q, Q_intra, Q_inter."
+       << endl;
+  exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,189 @@
+/*!
+  @file cafedcd_cluster.cpp
+  @brief Conformational clustering of MD trajectory (dcd file).
+
+  Cluster frames of a DCD (CafeMol) file by their RMSD (after superimposition)
+  with the GROMOS or the k-medoids (CLARA) method.  Distances are read from a
+  cached RMSD matrix (see p_cafedcd_rmsd_matrix) or computed on demand.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:12
+  @copyright GNU Public License V3.0
+*/
+
+#include "clustering.hpp"
+#include "rmsd_matrix.hpp"
+
+#include <fstream>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace std;
+
+void print_usage(char* s);
+
+int main(int argc, char *argv[])
+{
+  int opt;
+  int frame_first = 0;
+  int frame_last = 0;
+  int frame_stride = 1;
+  bool use_index = false;
+  int n_thread = 0;
+  int mat_flag = 0;
+  int n_cluster = 0;
+  int n_sample = 0;
+  int n_repeat = 5;
+  unsigned seed = 0;
+  double cutoff = -1.0;
+
+  string dcd_name = "please_provide_name.dcd";
+  string inp_name = "please_provide_name.in";
+  string mat_name = "please_provide_name.rmsdmat";
+  string out_name = "please_provide_name";
+  string method = "gromos";
+
+  while ((opt = getopt(argc, argv, "f:i:m:o:a:c:K:S:R:s:b:e:k:n:Ih")) != -1) {
+    switch (opt) {
+      case 'f':
+        dcd_name = optarg;
+        break;
+      case 'i':
+        inp_name = optarg;
+        break;
+      case 'm':
+        mat_name = optarg;
+        mat_flag = 1;
+        break;
+      case 'o':
+        out_name = optarg;
+        break;
+      case 'a':
+        method = optarg;
+        break;
+      case 'c':
+        cutoff = atof(optarg);
+        break;
+      case 'K':
+        n_cluster = atoi(optarg);
+        break;
+      case 'S':
+        n_sample = atoi(optarg);
+        break;
+      case 'R':
+        n_repeat = atoi(optarg);
+        break;
+      case 's':
+        seed = atoi(optarg);
+        break;
+      case 'b':
+        frame_first = atoi(optarg);
+        break;
+      case 'e':
+        frame_last = atoi(optarg);
+        break;
+      case 'k':
+        frame_stride = atoi(optarg);
+        break;
+      case 'n':
+        n_thread = atoi(optarg);
+        break;
+      case 'I':
+        use_index = true;
+        break;
+      case 'h':
+        print_usage(argv[0]);
+        break;
+      default: /* '?' */
+        print_usage(argv[0]);
+    }
+  }
+  if (method == "gromos") {
+    if (cutoff < 0)
+      print_usage(argv[0]);
+  } else if (method == "kmedoids") {
+    if (n_cluster <= 0)
+      print_usage(argv[0]);
+  } else {
+    print_usage(argv[0]);
+  }
+
+  // ------------------------------ Distances ----------------------------------
+  pinang::RmsdMatrix mat;
+  pinang::CenteredFrames frames;
+  pinang::DcdMappedReader dcd_map;
+  function<double(int, int)> dist;
+  function<int(int)> frame_index;
+  int n = 0;
+  if (mat_flag) {
+    if (mat.open(mat_name))
+      return 1;
+    n = mat.get_size();
+    dist = [&](int i, int j) { return mat.get(i, j); };
+    frame_index = [&](int k) { return mat.get_frame(k); };
+    cout << " Clustering " << n << " frames with RMSD matrix : " << mat_name << " ... " << endl;
+  } else {
+    pinang::Selection sel_rmsd(inp_name, "RMSD_MATRIX");
+    cout << " Number of particles in GROUP RMSD_MATRIX: " << sel_rmsd.get_size() << "\n";
+    if (dcd_map.open(dcd_name, use_index) || dcd_map.frame_count() == 0)
+    {
+      cout << " ERROR: Empty DCD file!  Please check! " << "\n";
+      return 1;
+    }
+    if (dcd_map.set_frame_range(frame_first, frame_last, frame_stride))
+    {
+      print_usage(argv[0]);
+    }
+    vector<pinang::Selection> sel_all = {sel_rmsd};
+    if (dcd_map.set_atom_subset(sel_all))
+      return 1;
+    sel_rmsd = dcd_map.get_subset_selection(sel_rmsd);
+    if (frames.load(dcd_map, sel_rmsd, n_thread))
+      return 1;
+    n = frames.get_size();
+    dist = [&](int i, int j) { return frames.get_rmsd(i, j); };
+    frame_index = [&](int k) { return dcd_map.get_range_frame(k); };
+    cout << " Clustering " << n << " frames from dcd file : " << dcd_name << " ... " << endl;
+  }
+
+  // ------------------------------ Clustering ---------------------------------
+  pinang::ClusterResult result;
+  if (method == "gromos") {
+    if (pinang::cluster_gromos(n, dist, cutoff, n_thread, result))
+      return 1;
+  } else {
+    if (pinang::cluster_kmedoids(n, dist, n_cluster, n_thread, result, n_sample, n_repeat, seed))
+      return 1;
+  }
+  cout << " Number of clusters: " << result.get_cluster_number() << "\n";
+
+  string clu_name = out_name + "_clusters.dat";
+  string lab_name = out_name + "_labels.dat";
+  ofstream clu_file(clu_name.c_str());
+  ofstream lab_file(lab_name.c_str());
+  result.write_clusters(clu_file, frame_index);
+  result.write_labels(lab_file, frame_index);
+  clu_file.close();
+  lab_file.close();
+
+  return 0;
+}
+
+void print_usage(char* s)
+{
+  cout << " Usage: "
+            << s
+            << " (-m xxx.rmsdmat | -f xxx.dcd -i xxx.in [-b first_frame] [-e last_frame] [-k stride] [-I])"
+            << " [-a gromos|kmedoids] [-c cutoff] [-K clusters] [-S sample_size] [-R samples] [-s seed]"
+            << " [-o prefix] [-n threads] [-h]"
+            << "\n";
+  cout << " -I: build frame index file xxx.dcdidx (an up-to-date one is always used). \n";
+  cout << " -a gromos: cutoff clustering, -c is required. \n"
+       << " -a kmedoids: k-medoids (CLARA) clustering, -K is required. \n"
+       << " Output: prefix_clusters.dat (cluster, medoid frame, population), \n"
+       << "         prefix_labels.dat (frame, cluster). \n"
+       << " Input file example: \n"
+       << " ~~~~~~~~~~~~~~~~~~~~ \n RMSD_MATRIX: 1 to 100 \n ~~~~~~~~~~~~~~~~~~~~ "
+       << endl;
+  exit(EXIT_SUCCESS);
+}
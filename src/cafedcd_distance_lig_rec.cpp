@@ -9,9 +9,9 @@
   @copyright GNU Public License V3.0
 */
 
-#include "read_cafemol_dcd.hpp"
+#include "parallel_frames.hpp"
 #include "topology.hpp"
-#include "group.hpp"
+#include "frame_analysis.hpp"
 
 #include <iomanip>
 #include <sstream>
@@ -26,13 +26,18 @@ void print_usage(char* s);
 int main(int argc, char *argv[])
 {
   int opt;
+  int frame_first = 0;
+  int frame_last = 0;
+  int frame_stride = 1;
+  bool use_index = false;
+  int n_thread = 1;
 
   string dcd_name = "please_provide_name.dcd";
   string top_name = "please_provide_name.psf";
   string inp_name = "please_provide_name.in";
   string dis_name = "please_provide_name.dat";
 
-  while ((opt = getopt(argc, argv, "f:s:i:o:h")) != -1) {
+  while ((opt = getopt(argc, argv, "f:s:i:o:b:e:k:n:Ih")) != -1) {
     switch (opt) {
       case 'f':
         dcd_name = optarg;
@@ -46,6 +51,21 @@ int main(int argc, char *argv[])
       case 'o':
         dis_name = optarg;
         break;
+      case 'b':
+        frame_first = atoi(optarg);
+        break;
+      case 'e':
+        frame_last = atoi(optarg);
+        break;
+      case 'k':
+        frame_stride = atoi(optarg);
+        break;
+      case 'n':
+        n_thread = atoi(optarg);
+        break;
+      case 'I':
+        use_index = true;
+        break;
       case 'h':
         print_usage(argv[0]);
         break;
@@ -55,7 +75,6 @@ int main(int argc, char *argv[])
   }
 
   // ------------------------------ prepare files ------------------------------
-  ifstream dcd_file(dcd_name.c_str(), ifstream::binary);
   ofstream dis_file(dis_name.c_str());
   pinang::Topology top(top_name);
 
@@ -72,47 +91,47 @@ int main(int argc, char *argv[])
   }
 
   // ------------------------------ Reading DCD --------------------------------
-  vector<pinang::Conformation> conformations;
-  pinang::read_cafemol_dcd(dcd_file, conformations);
-  int nframe = conformations.size();
-
-  if (nframe == 0)
+  pinang::DcdMappedReader dcd_map(dcd_name, use_index);
+  if (!dcd_map.is_open() || dcd_map.frame_count() == 0)
   {
     cout << " ERROR: Empty DCD file!  Please check! " << "\n";
     return 1;
   }
-  if (top.get_size() != conformations[0].get_size())
+  if (top.get_size() != dcd_map.get_natom())
   {
     cout << " ERROR: Particle number don't match in top and dcd! "
               << " Please check! " << "\n";
     return 1;
   }
+  if (dcd_map.set_frame_range(frame_first, frame_last, frame_stride))
+  {
+    print_usage(argv[0]);
+  }
+
+  // ------------------------------ Decode selected atoms only ---------------
+  vector<pinang::Selection> sel_all = {sel_lig, sel_rec};
+  if (dcd_map.set_atom_subset(sel_all))
+    return 1;
+  sel_lig = dcd_map.get_subset_selection(sel_lig);
+  sel_rec = dcd_map.get_subset_selection(sel_rec);
 
   // ------------------------------ Calculating distance ----------------------
-  double dist;
-  double d_tmp;
-  pinang::Vec3d com_lig;
-  pinang::Vec3d coor_rec;
   cout << " Calculating distance_min from LIG(COM) to REC : ..." << endl;
-  for (int i= 0; i < nframe; ++i) {
-    pinang::Group grp_lig(conformations[i], sel_lig);
-    com_lig = pinang::get_center_of_mass(grp_lig, masses_lig);
-
-    dist = -1.0;
-    d_tmp = 0.0;
-    for (int j = 0; j < sel_rec.get_size(); ++j) {
-      coor_rec = conformations[i].get_coordinate(sel_rec.get_selection(j));
-      d_tmp = pinang::vec_distance(com_lig, coor_rec);
-      if (dist < 0 || dist > d_tmp) dist = d_tmp;
-    }
-
-    dis_file << setw(6) << i
-             << "   " << setw(8) << dist
+  vector<double> dist_frames(dcd_map.get_range_size());
+  if (pinang::parallel_for_frames(dcd_map, n_thread, [&](int, int k, pinang::Conformation& conf) {
+        dist_frames[k] = pinang::get_min_com_distance(conf, sel_lig, masses_lig, sel_rec);
+      }))
+  {
+    cout << " ERROR: Cannot read all the frames from dcd file!  Please check! " << "\n";
+    return 1;
+  }
+  for (int k = 0; k < dcd_map.get_range_size(); ++k) {
+    dis_file << setw(6) << dcd_map.get_range_frame(k)
+             << "   " << setw(8) << dist_frames[k]
              << "\n"; // Output the distance!
   }
   cout << " Done! " << "\n";
 
-  dcd_file.close();
   dis_file.close();
 
   return 0;
@@ -122,8 +141,9 @@ void print_usage(char* s)
 {
   cout << " Usage: "
             << s
-            << " -f xxx.dcd -s xxx.psf -i xxx.in [-o distance.dat] [-h]"
+            << " -f xxx.dcd -s xxx.psf -i xxx.in [-o distance.dat] [-b first_frame] [-e last_frame] [-k stride] [-I] [-n threads] [-h]"
             << "\n";
+  cout << " -I: build frame index file xxx.dcdidx (an up-to-date one is always used). \n";
   cout << " Input file example: \n"
        << " ~~~~~~~~~~~~~~~~~~~~ \n REC: 1 to 100 \n LIG: 2 to 50, 55 to 106 \n"
        << endl;
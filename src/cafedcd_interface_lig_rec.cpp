@@ -9,10 +9,11 @@
   @copyright GNU Public License V3.0
 */
 
-#include "read_cafemol_dcd.hpp"
+#include "parallel_frames.hpp"
 #include "topology.hpp"
-#include "group.hpp"
+#include "frame_analysis.hpp"
 
+#include <atomic>
 #include <iomanip>
 #include <sstream>
 #include <cstdlib>
@@ -27,15 +28,21 @@ int main(int argc, char *argv[])
 {
   double contact_cutoff = 10.0;
   double com_cutoff = 0.0;
+  double skin = 2.0;
 
   int opt;
+  int frame_first = 0;
+  int frame_last = 0;
+  int frame_stride = 1;
+  bool use_index = false;
+  int n_thread = 1;
 
   string dcd_name = "please_provide_name.dcd";
   string top_name = "please_provide_name.psf";
   string inp_name = "please_provide_name.in";
   string dat_name = "please_provide_name.dat";
 
-  while ((opt = getopt(argc, argv, "f:c:C:s:i:o:h")) != -1) {
+  while ((opt = getopt(argc, argv, "f:c:C:v:s:i:o:b:e:k:n:Ih")) != -1) {
     switch (opt) {
       case 'f':
         dcd_name = optarg;
@@ -49,12 +56,30 @@ int main(int argc, char *argv[])
       case 'C':
         com_cutoff = atof(optarg);
         break;
+      case 'v':
+        skin = atof(optarg);
+        break;
       case 'i':
         inp_name = optarg;
         break;
       case 'o':
         dat_name = optarg;
         break;
+      case 'b':
+        frame_first = atoi(optarg);
+        break;
+      case 'e':
+        frame_last = atoi(optarg);
+        break;
+      case 'k':
+        frame_stride = atoi(optarg);
+        break;
+      case 'n':
+        n_thread = atoi(optarg);
+        break;
+      case 'I':
+        use_index = true;
+        break;
       case 'h':
         print_usage(argv[0]);
         break;
@@ -64,7 +89,6 @@ int main(int argc, char *argv[])
   }
 
   // ------------------------------ prepare files ------------------------------
-  ifstream dcd_file(dcd_name.c_str(), ifstream::binary);
   ofstream dat_file(dat_name.c_str());
   pinang::Topology top(top_name);
 
@@ -76,81 +100,61 @@ int main(int argc, char *argv[])
   cout << " Number of particles in GROUP REC: " << sel_rec.get_size() << "\n";
 
   // ------------------------------ Reading DCD --------------------------------
-  vector<pinang::Conformation> conformations;
-  pinang::read_cafemol_dcd(dcd_file, conformations);
-  int nframe = conformations.size();
-
-  if (nframe == 0)
+  pinang::DcdMappedReader dcd_map(dcd_name, use_index);
+  if (!dcd_map.is_open() || dcd_map.frame_count() == 0)
   {
     cout << " ERROR: Empty DCD file!  Please check! " << "\n";
     return 1;
   }
-  if (top.get_size() != conformations[0].get_size())
+  if (top.get_size() != dcd_map.get_natom())
   {
     cout << " ERROR: Particle number don't match in top and dcd! "
               << " Please check! " << "\n";
     return 1;
   }
+  if (dcd_map.set_frame_range(frame_first, frame_last, frame_stride))
+  {
+    print_usage(argv[0]);
+  }
+
+  // ------------------------------ Decode selected atoms only ---------------
+  vector<pinang::Selection> sel_all = {sel_lig, sel_rec};
+  if (dcd_map.set_atom_subset(sel_all))
+    return 1;
+  pinang::Selection sel_lig_dcd = dcd_map.get_subset_selection(sel_lig);
+  pinang::Selection sel_rec_dcd = dcd_map.get_subset_selection(sel_rec);
 
   // ------------------------------ Estimate size of rec/lig -------------------
-  pinang::Group grp_lig_0(conformations[0], sel_lig);
-  pinang::Group grp_rec_0(conformations[0], sel_rec);
-  double rg_lig_0 = pinang::get_radius_of_gyration(grp_lig_0);
-  double rg_rec_0 = pinang::get_radius_of_gyration(grp_rec_0);
-  com_cutoff = 2 * (rg_lig_0 + rg_rec_0);
+  pinang::Conformation conf_0;
+  if (dcd_map.read_frame(0, conf_0))
+    return 1;
+  com_cutoff = pinang::get_interface_com_cutoff(conf_0, sel_lig_dcd, sel_rec_dcd);
 
   // ------------------------------ Calculating interface ----------------------
-  pinang::Vec3d centroid_lig;
-  pinang::Vec3d centroid_rec;
-  pinang::Vec3d coor_lig;
-  pinang::Vec3d coor_rec;
-  double d_tmp;
-  vector<int> lig_resid_flag;
-  vector<int> rec_resid_flag;
-  for (int i= 0; i < nframe; ++i) {
-    pinang::Group grp_lig(conformations[i], sel_lig);
-    pinang::Group grp_rec(conformations[i], sel_rec);
-    centroid_lig = grp_lig.get_centroid();
-    centroid_rec = grp_rec.get_centroid();
-    d_tmp = pinang::vec_distance(centroid_rec, centroid_lig);
-    if (d_tmp > com_cutoff) {
-      continue;
-    }
-
-    for (int j = 0; j < sel_rec.get_size(); ++j) {
-      rec_resid_flag.push_back(0);
-      lig_resid_flag.push_back(0);
-    }
-
-    for (int j = 0; j < sel_rec.get_size(); ++j) {
-      coor_rec = conformations[i].get_coordinate(sel_rec.get_selection(j));
-      for (int k = 0; k < sel_lig.get_size(); ++k) {
-        coor_lig = conformations[i].get_coordinate(sel_lig.get_selection(k));
-        d_tmp = pinang::vec_distance(coor_rec, coor_lig);
-        if (d_tmp < contact_cutoff) {
-          rec_resid_flag[j] = 1;
-          lig_resid_flag[k] = 1;
-        }
-      }
-    }
-    dat_file << "STEP > " << setw(8) << i << " \n";
-    dat_file << " | LIG > ";
-    for (int j = 0; j < sel_rec.get_size(); ++j) {
-      if (lig_resid_flag[j] > 0)
-        dat_file << " " << setw(5) << sel_lig.get_selection(j) + 1;
-    }
-    dat_file << "\n | REC > ";
-    for (int k = 0; k < sel_rec.get_size(); ++k) {
-      if (rec_resid_flag[k] > 0)
-        dat_file << " " << setw(5) << sel_rec.get_selection(k) + 1;
-    }
-    dat_file << "\nTER >" << "\n";
-
-    rec_resid_flag.clear();
-    lig_resid_flag.clear();
+  vector<string> out_frames(dcd_map.get_range_size());
+  // each thread keeps its own Verlet list;
+  vector<pinang::VerletList> pair_lists(pinang::get_thread_number(n_thread),
+                                        pinang::VerletList(contact_cutoff, skin));
+  std::atomic<int> status(0);
+  if (pinang::parallel_for_frames(dcd_map, n_thread, [&](int t, int k, pinang::Conformation& conf) {
+        ostringstream out;
+        if (pinang::write_interface(out, dcd_map.get_range_frame(k), conf, sel_lig_dcd, sel_rec_dcd,
+                                    sel_lig, sel_rec, contact_cutoff, com_cutoff, pair_lists[t]))
+          status = 1;
+        out_frames[k] = out.str();
+      }))
+  {
+    cout << " ERROR: Cannot read all the frames from dcd file!  Please check! " << "\n";
+    return 1;
+  }
+  if (status)
+  {
+    cout << " ERROR: Cannot search receptor-ligand pairs!  Please check! " << "\n";
+    return 1;
   }
+  for (const string& out : out_frames)
+    dat_file << out;
 
-  dcd_file.close();
   dat_file.close();
 
   return 0;
@@ -161,8 +165,9 @@ void print_usage(char* s)
   cout << " Usage: "
        << s
        << " -f xxx.dcd -s xxx.psf -i xxx.in \n"
-       << "[-C com_cutoff(real)] [-c contact_cutoff(real)] [-o distance.dat] [-h]"
+       << "[-C com_cutoff(real)] [-c contact_cutoff(real)] [-v skin(real)] [-o distance.dat] [-b first_frame] [-e last_frame] [-k stride] [-I] [-n threads] [-h]"
        << "\n";
+  cout << " -I: build frame index file xxx.dcdidx (an up-to-date one is always used). \n";
   cout << " Input file example: \n"
        << " ~~~~~~~~~~~~~~~~~~~~ \n REC: 1 to 100 \n LIG: 2 to 50, 55 to 106 \n"
        << endl;
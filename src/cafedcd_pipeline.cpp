@@ -0,0 +1,172 @@
+/*!
+  @file cafedcd_pipeline.cpp
+  @brief Run several analyses on MD trajectory (dcd file) in one pass.
+
+  Read DCD (CafeMol) file once, and feed every frame to all the analyses listed
+  in the input file.  Each analysis writes its own output file.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 12:53
+  @copyright GNU Public License V3.0
+*/
+
+#include "dcd_prefetcher.hpp"
+#include "analysis_stage.hpp"
+
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace std;
+
+void print_usage(char* s);
+
+int main(int argc, char *argv[])
+{
+  int opt;
+  int frame_first = 0;
+  int frame_last = 0;
+  int frame_stride = 1;
+  bool use_index = false;
+
+  string dcd_name = "please_provide_name.dcd";
+  string top_name = "please_provide_name.psf";
+  string inp_name = "please_provide_name.in";
+
+  while ((opt = getopt(argc, argv, "f:s:i:b:e:k:Ih")) != -1) {
+    switch (opt) {
+      case 'f':
+        dcd_name = optarg;
+        break;
+      case 's':
+        top_name = optarg;
+        break;
+      case 'i':
+        inp_name = optarg;
+        break;
+      case 'b':
+        frame_first = atoi(optarg);
+        break;
+      case 'e':
+        frame_last = atoi(optarg);
+        break;
+      case 'k':
+        frame_stride = atoi(optarg);
+        break;
+      case 'I':
+        use_index = true;
+        break;
+      case 'h':
+        print_usage(argv[0]);
+        break;
+      default: /* '?' */
+        print_usage(argv[0]);
+    }
+  }
+
+  // ------------------------------ prepare files ------------------------------
+  pinang::DcdReader dcd_file(dcd_name, use_index);
+  pinang::Topology top(top_name);
+
+  // ------------------------------ set up analyses ----------------------------
+  vector<unique_ptr<pinang::AnalysisStage> > stages;
+  ifstream inp_file(inp_name.c_str());
+  string inp_line;
+  while (getline(inp_file, inp_line)) {
+    if (inp_line.find("ANALYSIS:") != 0)
+      continue;
+    unique_ptr<pinang::AnalysisStage> stage =
+        pinang::create_analysis_stage(inp_line.substr(9), inp_name, top);
+    if (!stage)
+    {
+      cout << " ERROR: Cannot set up analysis: " << inp_line << "\n";
+      return 1;
+    }
+    stages.push_back(std::move(stage));
+  }
+  inp_file.close();
+  cout << " Number of analyses: " << stages.size() << "\n";
+  if (stages.empty())
+    print_usage(argv[0]);
+
+  // ------------------------------ Reading DCD --------------------------------
+  int nframe = dcd_file.frame_count();
+
+  if (nframe == 0)
+  {
+    cout << " ERROR: Empty DCD file!  Please check! " << "\n";
+    return 1;
+  }
+  if (top.get_size() != dcd_file.get_natom())
+  {
+    cout << " ERROR: Particle number don't match in top and dcd! "
+         << " Please check! " << "\n";
+    return 1;
+  }
+  if (dcd_file.set_frame_range(frame_first, frame_last, frame_stride))
+  {
+    print_usage(argv[0]);
+  }
+
+  // ------------------------------ Decode selected atoms only ---------------
+  bool all_atoms = false;
+  vector<pinang::Selection> sel_all;
+  for (const unique_ptr<pinang::AnalysisStage>& stage : stages) {
+    if (stage->needs_all_atoms())
+      all_atoms = true;
+    vector<pinang::Selection> sels = stage->get_selections();
+    sel_all.insert(sel_all.end(), sels.begin(), sels.end());
+  }
+  if (!all_atoms) {
+    if (dcd_file.set_atom_subset(sel_all))
+      return 1;
+    for (unique_ptr<pinang::AnalysisStage>& stage : stages)
+      stage->map_selections(dcd_file);
+  }
+  cout << " Number of particles decoded per frame: " << dcd_file.get_subset_size() << "\n";
+
+  // ------------------------------ Analysing frames ---------------------------
+  cout << " Analysing dcd file : " << dcd_name << " ... " << endl;
+  pinang::DcdPrefetcher prefetcher(dcd_file);
+  pinang::Conformation conf;
+  while (prefetcher.next_frame(conf) == 0) {
+    int i = prefetcher.get_frame_index();
+    for (unique_ptr<pinang::AnalysisStage>& stage : stages) {
+      if (stage->analyze(i, conf))
+        return 1;
+    }
+  }
+  cout << " Done! " << "\n";
+
+  prefetcher.stop();
+  dcd_file.close();
+
+  return 0;
+}
+
+void print_usage(char* s)
+{
+  cout << " Usage: "
+       << s
+       << " -f xxx.dcd -s xxx.psf -i xxx.in [-b first_frame] [-e last_frame] [-k stride] [-I] [-h]"
+       << "\n";
+  cout << " -I: build frame index file xxx.dcdidx (an up-to-date one is always used). \n";
+  cout << " Input file example: \n"
+       << " ~~~~~~~~~~~~~~~~~~~~ \n"
+       << " ANALYSIS: rmsd rmsd.dat \n"
+       << " ANALYSIS: rmsd rmsd_native.dat ref=native.crd prefix=N_ \n"
+       << " ANALYSIS: angle angle.dat \n"
+       << " ANALYSIS: distance distance.dat \n"
+       << " ANALYSIS: interface interface.dat cutoff=10.0 skin=2.0 \n"
+       << " ANALYSIS: Ep Ep.dat ffp=xxx.ffp shift=0.0 scale=1.0 skin=2.0 \n"
+       << " TRAN_REF: 1 to 100 \n TRAN_OBJ: 1 to 100 \n"
+       << " RMSD_REF: 1 to 200 \n RMSD_OBJ: 1 to 200 \n"
+       << " N_TRAN_REF: 1 to 100 \n N_TRAN_OBJ: 1 to 100 \n"
+       << " N_RMSD_REF: 1 to 200 \n N_RMSD_OBJ: 1 to 200 \n"
+       << " VA1: 1 to 5 \n VA2: 6 to 20 \n VB1: 201 to 205 \n VB2: 206 to 400 \n"
+       << " LIG: 1 to 200 \n REC: 201 to 400 \n"
+       << " ~~~~~~~~~~~~~~~~~~~~ "
+       << endl;
+  exit(EXIT_SUCCESS);
+}
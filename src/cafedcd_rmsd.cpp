@@ -9,9 +9,9 @@
   @copyright GNU Public License V3.0
 */
 
-#include "read_cafemol_dcd.hpp"
+#include "parallel_frames.hpp"
 #include "topology.hpp"
-#include "geometry.hpp"
+#include "frame_analysis.hpp"
 
 #include <iomanip>
 #include <sstream>
@@ -26,6 +26,11 @@ void print_usage(char* s);
 int main(int argc, char *argv[])
 {
   int opt;
+  int frame_first = 0;
+  int frame_last = 0;
+  int frame_stride = 1;
+  bool use_index = false;
+  int n_thread = 1;
   int ref_flag = 0;
 
   string dcd_name = "please_provide_name.dcd";
@@ -34,7 +39,7 @@ int main(int argc, char *argv[])
   string ref_name = "please_provide_name.crd";
   string rmsd_name = "please_provide_name.dat";
 
-  while ((opt = getopt(argc, argv, "f:s:i:o:r:h")) != -1) {
+  while ((opt = getopt(argc, argv, "f:s:i:o:r:b:e:k:n:Ih")) != -1) {
     switch (opt) {
       case 'f':
         dcd_name = optarg;
@@ -52,6 +57,21 @@ int main(int argc, char *argv[])
         ref_name = optarg;
         ref_flag = 1;
         break;
+      case 'b':
+        frame_first = atoi(optarg);
+        break;
+      case 'e':
+        frame_last = atoi(optarg);
+        break;
+      case 'k':
+        frame_stride = atoi(optarg);
+        break;
+      case 'n':
+        n_thread = atoi(optarg);
+        break;
+      case 'I':
+        use_index = true;
+        break;
       case 'h':
         print_usage(argv[0]);
         break;
@@ -61,11 +81,8 @@ int main(int argc, char *argv[])
   }
 
   // ------------------------------ prepare files ------------------------------
-  ifstream dcd_file(dcd_name.c_str(), ifstream::binary);
-  ofstream rmsd_file(rmsd_name.c_str());
   pinang::Topology top(top_name);
   pinang::Conformation conf_ref;
-  pinang::Conformation conf_obj;
   if (ref_flag == 1) {
     conf_ref = pinang::Conformation(ref_name);
   }
@@ -92,46 +109,68 @@ int main(int argc, char *argv[])
   }
 
   // ------------------------------ Reading DCD --------------------------------
-  vector<pinang::Conformation> conformations;
-  pinang::read_cafemol_dcd(dcd_file, conformations);
-  int nframe = conformations.size();
-
-  if (nframe == 0)
+  pinang::DcdMappedReader dcd_map(dcd_name, use_index);
+  if (!dcd_map.is_open() || dcd_map.frame_count() == 0)
   {
     cout << " ERROR: Empty DCD file!  Please check! " << "\n";
     return 1;
   }
-  if (top.get_size() != conformations[0].get_size())
+  if (top.get_size() != dcd_map.get_natom())
   {
     cout << " ERROR: Particle number don't match in top and dcd! "
               << " Please check! " << "\n";
     return 1;
   }
+  if (dcd_map.set_frame_range(frame_first, frame_last, frame_stride))
+  {
+    print_usage(argv[0]);
+  }
 
-  // ------------------------------ Calculating rmsd --------------------------
+  // ------------------------------ Decode selected atoms only ---------------
+  vector<pinang::Selection> sel_all = {sel_tran_obj, sel_rmsd_obj};
   if (ref_flag == 0) {
-    conf_ref = conformations[0];
+    sel_all.push_back(sel_tran_ref);
+    sel_all.push_back(sel_rmsd_ref);
   }
-  pinang::Transform t;
-  pinang::Group translated_obj;
-  double rmsd;
+  if (dcd_map.set_atom_subset(sel_all))
+    return 1;
+  sel_tran_obj = dcd_map.get_subset_selection(sel_tran_obj);
+  sel_rmsd_obj = dcd_map.get_subset_selection(sel_rmsd_obj);
+  if (ref_flag == 0) {
+    sel_tran_ref = dcd_map.get_subset_selection(sel_tran_ref);
+    sel_rmsd_ref = dcd_map.get_subset_selection(sel_rmsd_ref);
+    if (dcd_map.read_frame(0, conf_ref))
+      return 1;
+  }
+
+  // ------------------------------ Calculating rmsd --------------------------
+  pinang::Superposer superposer;
+  pinang::CoordinateArray<double> tran_ref;
+  pinang::CoordinateArray<double> rmsd_ref;
+  tran_ref.assign(conf_ref.get_view(), sel_tran_ref);
+  superposer.set_reference(tran_ref.get_view());
+  rmsd_ref.assign(conf_ref.get_view(), sel_rmsd_ref);
+
   cout << " Calculating rmsd from dcd file : " << dcd_name << " ... " << endl;
-  for (int i= 0; i < nframe; ++i) {
-    conf_obj = conformations[i];
-    pinang::Group grp_tran_ref(conf_ref, sel_tran_ref);
-    pinang::Group grp_tran_obj(conf_obj, sel_tran_obj);
-    pinang::Group grp_rmsd_ref(conf_ref, sel_rmsd_ref);
-    pinang::Group grp_rmsd_obj(conf_obj, sel_rmsd_obj);
-
-    pinang::find_transform(grp_tran_obj, grp_tran_ref, t);
-    translated_obj = t.apply(grp_rmsd_obj);
-    rmsd = pinang::get_rmsd(grp_rmsd_ref, translated_obj);
-    rmsd_file << setw(6) << i
-             << "   " << setw(8) << rmsd
-             << "\n"; // Output the rmsdtance!
+  // Thread-local scratch objects.
+  int n_local = pinang::get_thread_number(n_thread);
+  vector<pinang::RmsdScratch> scratch(n_local);
+  vector<double> rmsd_frames(dcd_map.get_range_size());
+  if (pinang::parallel_for_frames(dcd_map, n_local, [&](int thread, int k, pinang::Conformation& conf) {
+        rmsd_frames[k] = pinang::get_superimposed_rmsd(superposer, rmsd_ref.get_view(), conf,
+                                                       sel_tran_obj, sel_rmsd_obj, scratch[thread]);
+      }))
+  {
+    cout << " ERROR: Cannot read all the frames from dcd file!  Please check! " << "\n";
+    return 1;
   }
 
-  dcd_file.close();
+  ofstream rmsd_file(rmsd_name.c_str());
+  for (int k = 0; k < dcd_map.get_range_size(); ++k) {
+    rmsd_file << setw(6) << dcd_map.get_range_frame(k)
+             << "   " << setw(8) << rmsd_frames[k]
+             << "\n"; // Output the rmsdtance!
+  }
   rmsd_file.close();
 
   return 0;
@@ -141,8 +180,10 @@ void print_usage(char* s)
 {
   cout << " Usage: "
             << s
-            << " -f xxx.dcd -s xxx.psf -i xxx.in [-r reference_struct.crd] [-o xxx_rmsd.dat] [-h]"
+            << " -f xxx.dcd -s xxx.psf -i xxx.in [-r reference_struct.crd] [-o xxx_rmsd.dat] [-b first_frame] [-e last_frame] [-k stride] [-I] [-n threads] [-h]"
             << "\n";
+  cout << " -I: build frame index file xxx.dcdidx (an up-to-date one is always used). \n";
+  cout << " Without -r the first frame of the dcd file is the reference, also with -b. \n";
   cout << " Input file example: \n"
        << " ~~~~~~~~~~~~~~~~~~~~ \n TRAN_REF: 1 to 100 \n TRAN_OBJ: 2 to 50, 55 to 106 \n"
        << " RMSD_REF: 1 to 200 \n RMSD_OBJ 2 to 201 \n ~~~~~~~~~~~~~~~~~~~~ "
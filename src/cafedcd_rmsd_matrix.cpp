@@ -0,0 +1,143 @@
+/*!
+  @file cafedcd_rmsd_matrix.cpp
+  @brief Calculate all-vs-all RMSD matrix from MD trajectory (dcd file).
+
+  Read DCD (CafeMol) file, calculate RMSD (after superimposition) between every
+  pair of frames for a group of particles, and write the upper triangle of the
+  matrix to a binary file (see RmsdMatrix).
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:08
+  @copyright GNU Public License V3.0
+*/
+
+#include "rmsd_matrix.hpp"
+
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace std;
+
+void print_usage(char* s);
+
+int main(int argc, char *argv[])
+{
+  int opt;
+  int frame_first = 0;
+  int frame_last = 0;
+  int frame_stride = 1;
+  bool use_index = false;
+  int n_thread = 0;
+  int tile = 64;
+  int value_bits = 32;
+  int out_of_core = 0;
+
+  string dcd_name = "please_provide_name.dcd";
+  string inp_name = "please_provide_name.in";
+  string mat_name = "please_provide_name.rmsdmat";
+
+  while ((opt = getopt(argc, argv, "f:i:o:p:t:xb:e:k:n:Ih")) != -1) {
+    switch (opt) {
+      case 'f':
+        dcd_name = optarg;
+        break;
+      case 'i':
+        inp_name = optarg;
+        break;
+      case 'o':
+        mat_name = optarg;
+        break;
+      case 'p':
+        value_bits = atoi(optarg);
+        break;
+      case 't':
+        tile = atoi(optarg);
+        break;
+      case 'x':
+        out_of_core = 1;
+        break;
+      case 'b':
+        frame_first = atoi(optarg);
+        break;
+      case 'e':
+        frame_last = atoi(optarg);
+        break;
+      case 'k':
+        frame_stride = atoi(optarg);
+        break;
+      case 'n':
+        n_thread = atoi(optarg);
+        break;
+      case 'I':
+        use_index = true;
+        break;
+      case 'h':
+        print_usage(argv[0]);
+        break;
+      default: /* '?' */
+        print_usage(argv[0]);
+    }
+  }
+  if ((value_bits != 16 && value_bits != 32) || tile <= 0)
+    print_usage(argv[0]);
+
+  // ------------------------------ get selection ------------------------------
+  pinang::Selection sel_rmsd(inp_name, "RMSD_MATRIX");
+  cout << " Number of particles in GROUP RMSD_MATRIX: " << sel_rmsd.get_size() << "\n";
+  if (sel_rmsd.get_size() == 0)
+  {
+    cout << " Error: Empty selection for RMSD matrix. \n";
+    print_usage(argv[0]);
+  }
+
+  // ------------------------------ Reading DCD --------------------------------
+  pinang::DcdMappedReader dcd_map(dcd_name, use_index);
+  if (!dcd_map.is_open() || dcd_map.frame_count() == 0)
+  {
+    cout << " ERROR: Empty DCD file!  Please check! " << "\n";
+    return 1;
+  }
+  if (dcd_map.set_frame_range(frame_first, frame_last, frame_stride))
+  {
+    print_usage(argv[0]);
+  }
+  vector<pinang::Selection> sel_all = {sel_rmsd};
+  if (dcd_map.set_atom_subset(sel_all))
+    return 1;
+  sel_rmsd = dcd_map.get_subset_selection(sel_rmsd);
+
+  // ------------------------------ Calculating RMSD matrix --------------------
+  int n = dcd_map.get_range_size();
+  pinang::RmsdMatrix mat;
+  if (out_of_core) {
+    if (mat.create(mat_name, n, value_bits / 8))
+      return 1;
+  } else {
+    if (mat.create(n, value_bits / 8))
+      return 1;
+  }
+  cout << " Calculating " << n << " x " << n << " RMSD matrix from dcd file : "
+       << dcd_name << " ... " << endl;
+  if (pinang::compute_rmsd_matrix(dcd_map, sel_rmsd, n_thread, mat, tile))
+    return 1;
+  if (!out_of_core && mat.write(mat_name))
+    return 1;
+  mat.close();
+
+  return 0;
+}
+
+void print_usage(char* s)
+{
+  cout << " Usage: "
+            << s
+            << " -f xxx.dcd -i xxx.in [-o xxx.rmsdmat] [-p 16|32] [-t tile] [-x] [-b first_frame] [-e last_frame] [-k stride] [-I] [-n threads] [-h]"
+            << "\n";
+  cout << " -I: build frame index file xxx.dcdidx (an up-to-date one is always used). \n";
+  cout << " -p: precision of stored RMSD (bits, default 32). \n"
+       << " -x: out-of-core mode: write the matrix directly into the mapped output file. \n"
+       << " Input file example: \n"
+       << " ~~~~~~~~~~~~~~~~~~~~ \n RMSD_MATRIX: 1 to 100 \n ~~~~~~~~~~~~~~~~~~~~ "
+       << endl;
+  exit(EXIT_SUCCESS);
+}
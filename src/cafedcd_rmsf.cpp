@@ -0,0 +1,138 @@
+/*!
+  @file cafedcd_rmsf.cpp
+  @brief Calculate RMSF from MD trajectory (dcd file).
+
+  Read DCD (CafeMol) file, align all frames iteratively to their average
+  structure, and calculate root mean square fluctuation of each particle.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:14
+  @copyright GNU Public License V3.0
+*/
+
+#include "rmsf.hpp"
+
+#include <iomanip>
+#include <fstream>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace std;
+
+void print_usage(char* s);
+
+int main(int argc, char *argv[])
+{
+  int opt;
+  int frame_first = 0;
+  int frame_last = 0;
+  int frame_stride = 1;
+  bool use_index = false;
+  int n_thread = 1;
+  int max_iter = 20;
+  double tol = 1e-4;
+
+  string dcd_name = "please_provide_name.dcd";
+  string inp_name = "please_provide_name.in";
+  string rmsf_name = "please_provide_name.dat";
+
+  while ((opt = getopt(argc, argv, "f:i:o:N:t:b:e:k:n:Ih")) != -1) {
+    switch (opt) {
+      case 'f':
+        dcd_name = optarg;
+        break;
+      case 'i':
+        inp_name = optarg;
+        break;
+      case 'o':
+        rmsf_name = optarg;
+        break;
+      case 'N':
+        max_iter = atoi(optarg);
+        break;
+      case 't':
+        tol = atof(optarg);
+        break;
+      case 'b':
+        frame_first = atoi(optarg);
+        break;
+      case 'e':
+        frame_last = atoi(optarg);
+        break;
+      case 'k':
+        frame_stride = atoi(optarg);
+        break;
+      case 'n':
+        n_thread = atoi(optarg);
+        break;
+      case 'I':
+        use_index = true;
+        break;
+      case 'h':
+        print_usage(argv[0]);
+        break;
+      default: /* '?' */
+        print_usage(argv[0]);
+    }
+  }
+
+  if (max_iter < 1)
+  {
+    cout << " ERROR: max_iterations must be at least 1! " << "\n";
+    return 1;
+  }
+
+  // ------------------------------ get selections -----------------------------
+  pinang::Selection sel_fit(inp_name, "FIT");
+  pinang::Selection sel_rmsf(inp_name, "RMSF");
+  cout << " Number of particles in GROUP FIT: " << sel_fit.get_size() << "\n";
+  cout << " Number of particles in GROUP RMSF: " << sel_rmsf.get_size() << "\n";
+
+  // ------------------------------ Reading DCD --------------------------------
+  pinang::DcdMappedReader dcd_map(dcd_name, use_index);
+  if (!dcd_map.is_open() || dcd_map.frame_count() == 0)
+  {
+    cout << " ERROR: Empty DCD file!  Please check! " << "\n";
+    return 1;
+  }
+  if (dcd_map.set_frame_range(frame_first, frame_last, frame_stride))
+  {
+    print_usage(argv[0]);
+  }
+  vector<pinang::Selection> sel_all = {sel_fit, sel_rmsf};
+  if (dcd_map.set_atom_subset(sel_all))
+    return 1;
+  pinang::Selection sub_fit = dcd_map.get_subset_selection(sel_fit);
+  pinang::Selection sub_rmsf = dcd_map.get_subset_selection(sel_rmsf);
+
+  // ------------------------------ Calculating RMSF ---------------------------
+  cout << " Calculating RMSF from dcd file : " << dcd_name << " ... " << endl;
+  pinang::PositionAccumulator acc;
+  int n_iter = pinang::compute_rmsf(dcd_map, sub_fit, sub_rmsf, n_thread, acc, max_iter, tol);
+  if (n_iter < 0)
+    return 1;
+  cout << " Number of alignment iterations: " << n_iter << "\n";
+
+  ofstream rmsf_file(rmsf_name.c_str());
+  for (int i = 0; i < acc.get_size(); ++i) {
+    rmsf_file << setw(6) << sel_rmsf.get_selection(i) + 1
+              << "   " << setw(8) << acc.get_rmsf(i)
+              << "\n";
+  }
+  rmsf_file.close();
+
+  return 0;
+}
+
+void print_usage(char* s)
+{
+  cout << " Usage: "
+            << s
+            << " -f xxx.dcd -i xxx.in [-o xxx_rmsf.dat] [-N max_iterations] [-t tolerance] [-b first_frame] [-e last_frame] [-k stride] [-I] [-n threads] [-h]"
+            << "\n";
+  cout << " -I: build frame index file xxx.dcdidx (an up-to-date one is always used). \n";
+  cout << " Input file example: \n"
+       << " ~~~~~~~~~~~~~~~~~~~~ \n FIT: 1 to 100 \n RMSF: 1 to 200 \n ~~~~~~~~~~~~~~~~~~~~ "
+       << endl;
+  exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,171 @@
+/*!
+  @file cafedcd_sasa.cpp
+  @brief Calculate solvent accessible surface area from MD trajectory (dcd file).
+
+  Read DCD (CafeMol) file and topology, compute SASA of CG beads in every
+  frame (Shrake-Rupley), and output the total SASA of every frame and the
+  average SASA of every particle.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:42
+  @copyright GNU Public License V3.0
+*/
+
+#include "sasa.hpp"
+#include "parallel_frames.hpp"
+#include "topology.hpp"
+
+#include <iomanip>
+#include <fstream>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace std;
+
+void print_usage(char* s);
+
+int main(int argc, char *argv[])
+{
+  int opt;
+  int frame_first = 0;
+  int frame_last = 0;
+  int frame_stride = 1;
+  bool use_index = false;
+  int n_thread = 1;
+  int n_points = 480;
+  double probe = 1.4;
+
+  string dcd_name = "please_provide_name.dcd";
+  string top_name = "please_provide_name.psf";
+  string sasa_name = "please_provide_name.dat";
+  string avg_name = "";
+
+  while ((opt = getopt(argc, argv, "f:s:o:a:r:p:b:e:k:n:Ih")) != -1) {
+    switch (opt) {
+      case 'f':
+        dcd_name = optarg;
+        break;
+      case 's':
+        top_name = optarg;
+        break;
+      case 'o':
+        sasa_name = optarg;
+        break;
+      case 'a':
+        avg_name = optarg;
+        break;
+      case 'r':
+        probe = atof(optarg);
+        break;
+      case 'p':
+        n_points = atoi(optarg);
+        break;
+      case 'b':
+        frame_first = atoi(optarg);
+        break;
+      case 'e':
+        frame_last = atoi(optarg);
+        break;
+      case 'k':
+        frame_stride = atoi(optarg);
+        break;
+      case 'n':
+        n_thread = atoi(optarg);
+        break;
+      case 'I':
+        use_index = true;
+        break;
+      case 'h':
+        print_usage(argv[0]);
+        break;
+      default: /* '?' */
+        print_usage(argv[0]);
+    }
+  }
+
+  // ------------------------------ Topology -----------------------------------
+  pinang::Topology top(top_name);
+  int n_particle = top.get_size();
+  vector<double> radii(n_particle);
+  for (int i = 0; i < n_particle; ++i)
+    radii[i] = pinang::get_cg_radius(top.get_particle(i).get_atom_name());
+
+  // ------------------------------ Reading DCD --------------------------------
+  pinang::DcdMappedReader dcd_map(dcd_name, use_index);
+  if (!dcd_map.is_open() || dcd_map.frame_count() == 0)
+  {
+    cout << " ERROR: Empty DCD file!  Please check! " << "\n";
+    return 1;
+  }
+  if (dcd_map.set_frame_range(frame_first, frame_last, frame_stride))
+  {
+    print_usage(argv[0]);
+  }
+  if (dcd_map.get_natom() != n_particle)
+  {
+    cout << " ERROR: Particle number don't match in dcd and psf! " << "\n";
+    return 1;
+  }
+
+  // ------------------------------ Calculating SASA ---------------------------
+  cout << " Calculating SASA from dcd file : " << dcd_name << " ... " << endl;
+  pinang::ShrakeRupley sr(n_points, probe);
+  int n_frame = dcd_map.get_range_size();
+  int n_thread_used = pinang::get_thread_number(n_thread);
+  vector<double> sasa_total(n_frame, 0.0);
+  vector<vector<pinang::Vec3d> > frame_coors(n_thread_used);
+  vector<vector<double> > area(n_thread_used);
+  vector<vector<double> > area_sum(n_thread_used, vector<double>(n_particle, 0.0));
+  if (pinang::parallel_for_frames(dcd_map, n_thread_used, [&](int t, int k, pinang::Conformation& conf) {
+        pinang::CoordinateView<double> v = conf.get_view();
+        frame_coors[t].resize(n_particle);
+        for (int i = 0; i < n_particle; ++i)
+          frame_coors[t][i] = v.get_coordinate(i);
+        sr.compute(frame_coors[t], radii, area[t], 1);
+        for (int i = 0; i < n_particle; ++i) {
+          sasa_total[k] += area[t][i];
+          area_sum[t][i] += area[t][i];
+        }
+      }))
+  {
+    cout << " ERROR: Cannot read all the frames from dcd file!  Please check! " << "\n";
+    return 1;
+  }
+
+  ofstream sasa_file(sasa_name.c_str());
+  for (int k = 0; k < n_frame; ++k) {
+    sasa_file << setw(6) << dcd_map.get_range_frame(k)
+              << "   " << setw(12) << sasa_total[k]
+              << "\n";
+  }
+  sasa_file.close();
+
+  if (!avg_name.empty()) {
+    ofstream avg_file(avg_name.c_str());
+    for (int i = 0; i < n_particle; ++i) {
+      double a = 0;
+      for (int t = 0; t < n_thread_used; ++t)
+        a += area_sum[t][i];
+      avg_file << setw(6) << i + 1
+               << "   " << setw(10) << a / n_frame
+               << "\n";
+    }
+    avg_file.close();
+  }
+
+  return 0;
+}
+
+void print_usage(char* s)
+{
+  cout << " Usage: "
+       << s
+       << " -f xxx.dcd -s xxx.psf [-o xxx_sasa.dat] [-a xxx_sasa_avg.dat] [-r probe_radius] [-p points_per_particle]"
+       << " [-b first_frame] [-e last_frame] [-k stride] [-I] [-n threads] [-h]"
+       << "\n";
+  cout << " -I: build frame index file xxx.dcdidx (an up-to-date one is always used). \n";
+  cout << " Radii of CG beads are chosen by atom name (CA, DP, DS, DB).\n"
+       << " Output columns: frame, total SASA (A^2); -a: particle, average SASA."
+       << endl;
+  exit(EXIT_SUCCESS);
+}
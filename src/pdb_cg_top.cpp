@@ -82,7 +82,7 @@ int main(int argc, char *argv[])
     }
   }
 
-  pinang::Model m0 = pdb1.get_model(mod_index);
+  pinang::Model& m0 = pdb1.get_model(mod_index);
 
   if (pdb_flag) {
     string pdb_name = basefilename + "_cg.pdb";
@@ -0,0 +1,137 @@
+/*!
+  @file pdb_sasa.cpp
+  @brief Calculate solvent accessible surface area of PDB structures.
+
+  Read PDB file, compute SASA of every atom (Shrake-Rupley), and output the
+  SASA of every residue (and optionally of every atom).
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:42
+  @copyright GNU Public License V3.0
+*/
+
+#include <fstream>
+#include <iomanip>
+#include <unistd.h>
+#include "PDB.hpp"
+
+using namespace std;
+
+void print_usage(char* s);
+
+int main(int argc, char *argv[])
+{
+  int opt, mod_index = 0;
+  int in_flag = 0;
+  int out_flag = 0;
+  int atom_flag = 0;
+  int cg_flag = 0;
+  int n_thread = 1;
+  int n_points = 960;
+  double probe = 1.4;
+
+  string basefilename = "";
+  string infilename = "some.pdb";
+  string outfilename = "some.dat";
+
+  while ((opt = getopt(argc, argv, "f:o:m:r:p:n:ach")) != -1) {
+    switch (opt) {
+      case 'f':
+        infilename = optarg;
+        in_flag = 1;
+        basefilename = infilename.substr(0, infilename.size()-4);
+        break;
+      case 'o':
+        outfilename = optarg;
+        out_flag = 1;
+        break;
+      case 'm':
+        mod_index = atoi(optarg) - 1;
+        break;
+      case 'r':
+        probe = atof(optarg);
+        break;
+      case 'p':
+        n_points = atoi(optarg);
+        break;
+      case 'n':
+        n_thread = atoi(optarg);
+        break;
+      case 'a':
+        atom_flag = 1;
+        break;
+      case 'c':
+        cg_flag = 1;
+        break;
+      case 'h':
+        print_usage(argv[0]);
+        break;
+      default: /* '?' */
+        print_usage(argv[0]);
+    }
+  }
+
+  if (!in_flag)
+  {
+    cout << " ERROR: need parameter for option -f: " << "\n";
+    print_usage(argv[0]);
+  }
+  if (!out_flag) {
+    outfilename = basefilename + "_sasa.dat";
+  }
+
+  pinang::PDB pdb1(infilename);
+  if (mod_index < 0 || mod_index >= pdb1.get_size())
+  {
+    cout << " ERROR: Model " << mod_index + 1 << " not found in " << infilename << "\n";
+    return 1;
+  }
+  pinang::Model& m0 = pdb1.get_model(mod_index);
+
+  pinang::ShrakeRupley sr(n_points, probe);
+  vector<double> atom_area;
+  if (m0.compute_sasa(sr, atom_area, cg_flag, n_thread))
+    return 1;
+
+  ofstream out_file(outfilename.c_str());
+  out_file << setiosflags(ios_base::fixed) << setprecision(2);
+  double sasa_total = 0;
+  int i_atom = 0;
+  for (int i = 0; i < m0.get_size(); ++i) {
+    pinang::Chain& c = m0.get_chain(i);
+    for (int j = 0; j < c.get_size(); ++j) {
+      pinang::Residue& r = c.get_residue(j);
+      out_file << r.get_chain_ID() << "   " << setw(5) << r.get_residue_serial()
+               << "  " << r.get_residue_name() << "   " << setw(9) << r.get_sasa() << "\n";
+      for (int k = 0; k < r.get_size(); ++k, ++i_atom) {
+        if (atom_flag)
+          out_file << "    " << setw(6) << r.get_atom(k).get_atom_serial()
+                   << "  " << r.get_atom(k).get_atom_name()
+                   << "   " << setw(9) << atom_area[i_atom] << "\n";
+      }
+      sasa_total += r.get_sasa();
+    }
+  }
+  out_file.close();
+  cout << " Total SASA: " << setiosflags(ios_base::fixed) << setprecision(2) << sasa_total
+       << " A^2 (" << n_points << " points, probe " << probe << ")\n";
+
+  return 0;
+}
+
+void print_usage(char* s)
+{
+  cout << " Usage: "
+       << s
+       << "\n\t -f some.pdb\n\t"
+       << " [-o (some_sasa.dat)]\n\t"
+       << " [-m model_index]\n\t"
+       << " [-r probe_radius (1.4)]\n\t"
+       << " [-p points_per_atom (960)]\n\t"
+       << " [-a (output SASA of atoms)]\n\t"
+       << " [-c (CG model: radii by bead name)]\n\t"
+       << " [-n threads]\n\t"
+       << " [-h]"
+       << "\n";
+  exit(EXIT_SUCCESS);
+}
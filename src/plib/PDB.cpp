@@ -2,15 +2,17 @@
   @file PDB.cpp
   @brief Functions of class PDB.
 
-  In this file I define the member and friend functions of class PDB.
+  In this file I define the member and friend functions of class PDB.  PDB
+  files are read with PDBReader (block reading, in-place field decoding).
 
   @author Cheng Tan (noinil@gmail.com)
   @date 2016-05-24 15:26
   @copyright GNU Public License V3.0
 */
 
-#include <fstream>
 #include "PDB.hpp"
+#include "pdb_reader.hpp"
+#include "pdb_cache.hpp"
 
 namespace pinang {
 
@@ -25,22 +27,17 @@ PDB::PDB(const std::string& s)
   n_model_ = 0;
   v_models_.clear();
 
-  std::ifstream ifile(PDB_file_name_.c_str());
-  if (!ifile.is_open())
+  PDBReader reader;
+  if (reader.open(PDB_file_name_))
   {
     std::cout << " ~         PINANG :: PDB.cpp          ~ " << "\n";
     std::cerr << " ERROR: Cannot read file: " << s << "\n";
     exit(EXIT_FAILURE);
   }
 
-  while (ifile.good()) {
-    ifile >> atom_tmp;
-    if (ifile.fail())
-    {
-      break;
-    }
-
-    if (atom_tmp.get_record_name() == "MODEL ")
+  PDBRecord record;
+  while (reader.read(atom_tmp, record)) {
+    if (record == pdb_model)
     {
       model_tmp.reset();
       model_tmp.set_model_serial(atom_tmp.get_atom_serial());
@@ -49,33 +46,33 @@ PDB::PDB(const std::string& s)
       resid_tmp.reset();
       atom_tmp.reset();
     }
-    if (atom_tmp.get_record_name() == "TER   ")
+    if (record == pdb_ter)
     {
       if (resid_tmp.get_size() != 0)
       {
-        chain_tmp.add_residue(resid_tmp);
         chain_tmp.set_chain_ID(resid_tmp.get_chain_ID());
         chain_tmp.set_chain_type(resid_tmp.get_chain_type());
+        chain_tmp.add_residue(std::move(resid_tmp));
       }
-      model_tmp.add_chain(chain_tmp);
+      model_tmp.add_chain(std::move(chain_tmp));
 
       chain_tmp.reset();
       resid_tmp.reset();
       atom_tmp.reset();
     }
-    if (atom_tmp.get_record_name() == "ENDMDL")
+    if (record == pdb_endmdl)
     {
       if (resid_tmp.get_size() != 0)
       {
-        chain_tmp.add_residue(resid_tmp);
         chain_tmp.set_chain_ID(resid_tmp.get_chain_ID());
         chain_tmp.set_chain_type(resid_tmp.get_chain_type());
+        chain_tmp.add_residue(std::move(resid_tmp));
       }
       if (chain_tmp.get_size() != 0)
       {
-        model_tmp.add_chain(chain_tmp);
+        model_tmp.add_chain(std::move(chain_tmp));
       }
-      v_models_.push_back(model_tmp);
+      v_models_.push_back(std::move(model_tmp));
       ++n_model_;
 
       model_tmp.reset();
@@ -83,21 +80,21 @@ PDB::PDB(const std::string& s)
       resid_tmp.reset();
       atom_tmp.reset();
     }
-    if (atom_tmp.get_record_name() == "END   ")
+    if (record == pdb_end)
     {
       if (resid_tmp.get_size() != 0)
       {
-        chain_tmp.add_residue(resid_tmp);
         chain_tmp.set_chain_ID(resid_tmp.get_chain_ID());
         chain_tmp.set_chain_type(resid_tmp.get_chain_type());
+        chain_tmp.add_residue(std::move(resid_tmp));
       }
       if (chain_tmp.get_size() != 0)
       {
-        model_tmp.add_chain(chain_tmp);
+        model_tmp.add_chain(std::move(chain_tmp));
       }
       if (model_tmp.get_size() != 0)
       {
-        v_models_.push_back(model_tmp);
+        v_models_.push_back(std::move(model_tmp));
         ++n_model_;
       }
 
@@ -106,18 +103,22 @@ PDB::PDB(const std::string& s)
       resid_tmp.reset();
       atom_tmp.reset();
     }
-    if (atom_tmp.get_record_name() == "ATOM  " )
+    if (record == pdb_atom)
     {
       if (resid_tmp.add_atom(atom_tmp))
       {
         if (resid_tmp.get_size() != 0)
         {
-          chain_tmp.add_residue(resid_tmp);
-          if (resid_tmp.get_atom(0).get_record_name() == "HETATM")
+          bool is_hetatm = resid_tmp.get_atom(0).get_record_name() == "HETATM";
+          if (is_hetatm)
           {
             chain_tmp.set_chain_ID(resid_tmp.get_chain_ID());
             chain_tmp.set_chain_type(resid_tmp.get_chain_type());
-            model_tmp.add_chain(chain_tmp);
+          }
+          chain_tmp.add_residue(std::move(resid_tmp));
+          if (is_hetatm)
+          {
+            model_tmp.add_chain(std::move(chain_tmp));
             chain_tmp.reset();
           }
           resid_tmp.reset();
@@ -129,16 +130,16 @@ PDB::PDB(const std::string& s)
         resid_tmp.add_atom(atom_tmp);
       }
     }
-    if (atom_tmp.get_record_name() == "HETATM")
+    if (record == pdb_hetatm)
     {
       if (resid_tmp.add_atom(atom_tmp))
       {
         if (resid_tmp.get_size() != 0)
         {
-          chain_tmp.add_residue(resid_tmp);
           chain_tmp.set_chain_ID(resid_tmp.get_chain_ID());
           chain_tmp.set_chain_type(resid_tmp.get_chain_type());
-          model_tmp.add_chain(chain_tmp);
+          chain_tmp.add_residue(std::move(resid_tmp));
+          model_tmp.add_chain(std::move(chain_tmp));
 
           chain_tmp.reset();
           resid_tmp.reset();
@@ -150,11 +151,34 @@ PDB::PDB(const std::string& s)
       }
     }
   }
+}
 
-  ifile.close();
+PDB PDB::load_cached(const std::string& s)
+{
+  PDB cached;
+  if (PDBCache::read(s, cached) == 0)
+    return cached;
+
+  // stamp of the file before parsing; see PDBCache::write();
+  std::int64_t size = 0;
+  std::int64_t mtime = 0;
+  int stamp_status = PDBCache::get_stamp(s, size, mtime);
+  PDB parsed(s);
+  if (stamp_status || PDBCache::write(s, parsed, size, mtime))
+  {
+    std::cout << " ~         PINANG :: PDB.cpp          ~ " << "\n";
+    std::cout << " Warning: Cannot write PDB cache: "
+              << PDBCache::get_sidecar_name(s) << "\n";
+  }
+  return parsed;
 }
 
 Model& PDB::get_model(unsigned int n)
+{
+  return const_cast<Model&>(static_cast<const PDB&>(*this).get_model(n));
+}
+
+const Model& PDB::get_model(unsigned int n) const
 {
   if (v_models_.empty())
   {
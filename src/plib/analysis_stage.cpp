@@ -0,0 +1,315 @@
+/*!
+  @file analysis_stage.cpp
+  @brief Define functions of analysis stages.
+
+  Definitions of member functions of AnalysisStage and its derived classes, and
+  the factory function create_analysis_stage().
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 12:53
+  @copyright GNU Public License V3.0
+*/
+
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include "analysis_stage.hpp"
+
+namespace pinang {
+
+namespace {
+// Get option value, or the default value if the option is not given.
+std::string get_option(const std::map<std::string, std::string>& opts,
+                       const std::string& key, const std::string& value)
+{
+  std::map<std::string, std::string>::const_iterator it = opts.find(key);
+  return it == opts.end() ? value : it->second;
+}
+
+// Get real-valued option, or the default value if the option is not given.
+int get_real_option(const std::map<std::string, std::string>& opts,
+                    const std::string& key, double value, double& x)
+{
+  std::map<std::string, std::string>::const_iterator it = opts.find(key);
+  if (it == opts.end()) {
+    x = value;
+    return 0;
+  }
+  const char* s = it->second.c_str();
+  char* end = 0;
+  x = std::strtod(s, &end);
+  if (end == s || *end != '\0')
+  {
+    std::cout << " ~           PINANG :: analysis_stage         ~ " << "\n";
+    std::cerr << " ERROR: Wrong value of option " << key << ": " << it->second << "\n";
+    return 1;
+  }
+  return 0;
+}
+
+std::vector<double> get_masses(Topology& top, const Selection& sel)
+{
+  std::vector<double> masses;
+  for (int i = 0; i < sel.get_size(); ++i)
+    masses.push_back(top.get_particle(sel.get_selection(i)).get_mass());
+  return masses;
+}
+}
+
+// AnalysisStage ===============================================================
+int AnalysisStage::open_output(const std::string& s)
+{
+  out_file_.open(s.c_str());
+  if (!out_file_.is_open())
+  {
+    std::cout << " ~           PINANG :: analysis_stage         ~ " << "\n";
+    std::cerr << " ERROR: Cannot write file: " << s << "\n";
+    return 1;
+  }
+  return 0;
+}
+
+// RmsdStage ===================================================================
+int RmsdStage::setup(const std::string& inp_name,
+                     const std::map<std::string, std::string>& opts, Topology&)
+{
+  std::string prefix = get_option(opts, "prefix", "");
+  sel_tran_ref_ = Selection(inp_name, prefix + "TRAN_REF");
+  sel_tran_obj_ = Selection(inp_name, prefix + "TRAN_OBJ");
+  sel_rmsd_ref_ = Selection(inp_name, prefix + "RMSD_REF");
+  sel_rmsd_obj_ = Selection(inp_name, prefix + "RMSD_OBJ");
+  if (sel_tran_ref_.get_size() != sel_tran_obj_.get_size())
+  {
+    std::cout << " Error: Inconsistent number of particles in superimposition (RMSD). \n";
+    return 1;
+  }
+  if (sel_rmsd_ref_.get_size() != sel_rmsd_obj_.get_size())
+  {
+    std::cout << " Error: Inconsistent number of particles in RMSD calculation. \n";
+    return 1;
+  }
+
+  std::string ref_name = get_option(opts, "ref", "");
+  ref_flag_ = !ref_name.empty();
+  ref_set_ = false;
+  if (ref_flag_)
+    conf_ref_ = Conformation(ref_name);
+  return 0;
+}
+
+std::vector<Selection> RmsdStage::get_selections() const
+{
+  std::vector<Selection> sels = {sel_tran_obj_, sel_rmsd_obj_};
+  if (!ref_flag_) {
+    sels.push_back(sel_tran_ref_);
+    sels.push_back(sel_rmsd_ref_);
+  }
+  return sels;
+}
+
+void RmsdStage::map_selections(const DcdReader& dcd)
+{
+  sel_tran_obj_ = dcd.get_subset_selection(sel_tran_obj_);
+  sel_rmsd_obj_ = dcd.get_subset_selection(sel_rmsd_obj_);
+  if (!ref_flag_) {
+    sel_tran_ref_ = dcd.get_subset_selection(sel_tran_ref_);
+    sel_rmsd_ref_ = dcd.get_subset_selection(sel_rmsd_ref_);
+  }
+}
+
+int RmsdStage::analyze(int i, Conformation& conf)
+{
+  if (!ref_set_) {
+    if (!ref_flag_)
+      conf_ref_ = conf;
+    CoordinateArray<double> tran_ref;
+    tran_ref.assign(conf_ref_.get_view(), sel_tran_ref_);
+    superposer_.set_reference(tran_ref.get_view());
+    rmsd_ref_.assign(conf_ref_.get_view(), sel_rmsd_ref_);
+    ref_set_ = true;
+  }
+  double rmsd = get_superimposed_rmsd(superposer_, rmsd_ref_.get_view(), conf,
+                                      sel_tran_obj_, sel_rmsd_obj_, scratch_);
+  out_file_ << std::setw(6) << i
+            << "   " << std::setw(8) << rmsd
+            << "\n";
+  return 0;
+}
+
+// AngleStage ==================================================================
+int AngleStage::setup(const std::string& inp_name,
+                      const std::map<std::string, std::string>& opts, Topology& top)
+{
+  const char* keywords[4] = {"VA1", "VA2", "VB1", "VB2"};
+  std::string prefix = get_option(opts, "prefix", "");
+  for (int k = 0; k < 4; ++k) {
+    sel_[k] = Selection(inp_name, prefix + keywords[k]);
+    masses_[k] = get_masses(top, sel_[k]);
+  }
+  return 0;
+}
+
+std::vector<Selection> AngleStage::get_selections() const
+{
+  return std::vector<Selection>(sel_, sel_ + 4);
+}
+
+void AngleStage::map_selections(const DcdReader& dcd)
+{
+  for (int k = 0; k < 4; ++k)
+    sel_[k] = dcd.get_subset_selection(sel_[k]);
+}
+
+int AngleStage::analyze(int i, Conformation& conf)
+{
+  out_file_ << std::setw(6) << i
+            << "   " << std::setw(8) << get_com_vector_angle(conf, sel_, masses_)
+            << "\n";
+  return 0;
+}
+
+// DistanceStage ===============================================================
+int DistanceStage::setup(const std::string& inp_name,
+                         const std::map<std::string, std::string>& opts, Topology& top)
+{
+  std::string prefix = get_option(opts, "prefix", "");
+  sel_lig_ = Selection(inp_name, prefix + "LIG");
+  sel_rec_ = Selection(inp_name, prefix + "REC");
+  masses_lig_ = get_masses(top, sel_lig_);
+  return 0;
+}
+
+std::vector<Selection> DistanceStage::get_selections() const
+{
+  return {sel_lig_, sel_rec_};
+}
+
+void DistanceStage::map_selections(const DcdReader& dcd)
+{
+  sel_lig_ = dcd.get_subset_selection(sel_lig_);
+  sel_rec_ = dcd.get_subset_selection(sel_rec_);
+}
+
+int DistanceStage::analyze(int i, Conformation& conf)
+{
+  out_file_ << std::setw(6) << i
+            << "   " << std::setw(8) << get_min_com_distance(conf, sel_lig_, masses_lig_, sel_rec_)
+            << "\n";
+  return 0;
+}
+
+// InterfaceStage ==============================================================
+int InterfaceStage::setup(const std::string& inp_name,
+                          const std::map<std::string, std::string>& opts, Topology&)
+{
+  std::string prefix = get_option(opts, "prefix", "");
+  sel_lig_ = Selection(inp_name, prefix + "LIG");
+  sel_rec_ = Selection(inp_name, prefix + "REC");
+  sel_lig_dcd_ = sel_lig_;
+  sel_rec_dcd_ = sel_rec_;
+  double skin;
+  if (get_real_option(opts, "cutoff", 10.0, contact_cutoff_)
+      || get_real_option(opts, "skin", 2.0, skin))
+    return 1;
+  com_cutoff_ = -1.0;
+  pair_list_.set_cutoff(contact_cutoff_, skin);
+  return 0;
+}
+
+std::vector<Selection> InterfaceStage::get_selections() const
+{
+  return {sel_lig_, sel_rec_};
+}
+
+void InterfaceStage::map_selections(const DcdReader& dcd)
+{
+  sel_lig_dcd_ = dcd.get_subset_selection(sel_lig_);
+  sel_rec_dcd_ = dcd.get_subset_selection(sel_rec_);
+}
+
+int InterfaceStage::analyze(int i, Conformation& conf)
+{
+  if (com_cutoff_ < 0)
+    com_cutoff_ = get_interface_com_cutoff(conf, sel_lig_dcd_, sel_rec_dcd_);
+  return write_interface(out_file_, i, conf, sel_lig_dcd_, sel_rec_dcd_, sel_lig_, sel_rec_,
+                         contact_cutoff_, com_cutoff_, pair_list_);
+}
+
+// EnergyStage =================================================================
+int EnergyStage::setup(const std::string&,
+                       const std::map<std::string, std::string>& opts, Topology& top)
+{
+  std::string ffp_name = get_option(opts, "ffp", "");
+  if (ffp_name.empty())
+  {
+    std::cout << " ~           PINANG :: analysis_stage         ~ " << "\n";
+    std::cerr << " ERROR: Please provide force field file by ffp=xxx.ffp " << "\n";
+    return 1;
+  }
+  double shift, scale, skin;
+  if (get_real_option(opts, "shift", 0.0, shift)
+      || get_real_option(opts, "scale", 1.0, scale)
+      || get_real_option(opts, "skin", 2.0, skin))
+    return 1;
+  ff_ss_ = FFProteinDNASpecific(ffp_name);
+  ff_ss_.set_energy_shift(shift);
+  ff_ss_.set_energy_scaling_factor(scale);
+  pair_list_.set_cutoff(0.0, skin);
+  top_ = &top;
+  return 0;
+}
+
+int EnergyStage::analyze(int i, Conformation& conf)
+{
+  double ene_pdss = ff_ss_.compute_energy_protein_DNA_specific(*top_, conf, pair_list_);
+  out_file_ << std::setw(6) << i
+            << "   " << std::setw(8) << ene_pdss
+            << "\n";
+  return 0;
+}
+
+// Factory =====================================================================
+std::unique_ptr<AnalysisStage> create_analysis_stage(const std::string& line,
+                                                     const std::string& inp_name,
+                                                     Topology& top)
+{
+  std::istringstream tmp_sstr(line);
+  std::string type;
+  std::string out_name;
+  std::string word;
+  std::map<std::string, std::string> opts;
+  std::unique_ptr<AnalysisStage> stage;
+
+  tmp_sstr >> type >> out_name;
+  while (tmp_sstr >> word) {
+    std::string::size_type m = word.find("=");
+    if (m == std::string::npos)
+    {
+      std::cout << " ~           PINANG :: analysis_stage         ~ " << "\n";
+      std::cerr << " ERROR: Wrong option (should be key=value): " << word << "\n";
+      return stage;
+    }
+    opts[word.substr(0, m)] = word.substr(m + 1);
+  }
+
+  if (type == "rmsd") {
+    stage.reset(new RmsdStage);
+  } else if (type == "angle") {
+    stage.reset(new AngleStage);
+  } else if (type == "distance") {
+    stage.reset(new DistanceStage);
+  } else if (type == "interface") {
+    stage.reset(new InterfaceStage);
+  } else if (type == "Ep") {
+    stage.reset(new EnergyStage);
+  } else {
+    std::cout << " ~           PINANG :: analysis_stage         ~ " << "\n";
+    std::cerr << " ERROR: Unknown analysis type: " << type << "\n";
+    return stage;
+  }
+  if (out_name.empty() || stage->setup(inp_name, opts, top) || stage->open_output(out_name))
+    stage.reset();
+  return stage;
+}
+
+}  // pinang
@@ -15,6 +15,11 @@
 namespace pinang {
 
 Residue& Chain::get_residue(int n)
+{
+  return const_cast<Residue&>(static_cast<const Chain&>(*this).get_residue(n));
+}
+
+const Residue& Chain::get_residue(int n) const
 {
   if (v_residues_.empty())
   {
@@ -39,7 +44,15 @@ int Chain::add_residue(const Residue& r)
   return 0;
 }
 
-double get_mass_from_atom_name_tmp(const std::string& s)
+int Chain::add_residue(Residue&& r)
+{
+  r.self_check();
+  v_residues_.push_back(std::move(r));
+  ++n_residue_;
+  return 0;
+}
+
+double get_mass_from_atom_name_tmp(AtomName s)
 {
   char c = s[0];
   switch (c) {
@@ -109,26 +122,27 @@ void Chain::self_check()
       O3p_flag = 0;
       int natom = r.get_size();
       for (int j = 0; j < natom; ++j) {
-        Atom ta = r.get_atom(j);
-        std::string aname = ta.get_atom_name();
+        const Atom& ta = r.get_atom(j);
+        AtomName aname = ta.get_atom_name();
         mass_tmp_atom = get_mass_from_atom_name_tmp(aname);
-        if (aname == "O3' ") {
-          tmp_O3p = ta.get_coordinate();
-          O3p_flag = 1;
-        } else if (aname == "P   " || aname == "OP1 " || aname == "OP2 " ||
-                   aname == "O5' " || aname == "O1P " || aname == "O2P ") {
-          com_P += ta.get_coordinate() * mass_tmp_atom;
-          mass_P += mass_tmp_atom;
-        } else {
-          std::string::size_type np;
-          np = aname.find("'");
-          if (np == std::string::npos) {
-            com_B += ta.get_coordinate() * mass_tmp_atom;
-            mass_B += mass_tmp_atom;
-          } else {
-            com_S += ta.get_coordinate() * mass_tmp_atom;
-            mass_S += mass_tmp_atom;
-          }
+        switch (aname.code()) {
+          case atom_code("O3' "):
+            tmp_O3p = ta.get_coordinate();
+            O3p_flag = 1;
+            break;
+          case atom_code("P   "): case atom_code("OP1 "): case atom_code("OP2 "):
+          case atom_code("O5' "): case atom_code("O1P "): case atom_code("O2P "):
+            com_P += ta.get_coordinate() * mass_tmp_atom;
+            mass_P += mass_tmp_atom;
+            break;
+          default:
+            if (!aname.contains('\'')) {
+              com_B += ta.get_coordinate() * mass_tmp_atom;
+              mass_B += mass_tmp_atom;
+            } else {
+              com_S += ta.get_coordinate() * mass_tmp_atom;
+              mass_S += mass_tmp_atom;
+            }
         }
       }
       if (i > 0) {
@@ -246,7 +260,7 @@ void Chain::output_cg_crd(std::ostream& o)
     }
   }
   if (chain_type_ == ion) {
-    Residue r = v_residues_[0];
+    const Residue& r = v_residues_[0];
     o << r.get_atom(0).get_coordinate() << " \n";
   }
 }
@@ -344,7 +358,7 @@ void Chain::output_top_mass(std::ostream& o, int& n, int& m)
                            "RB", "B", 0.0, r.get_residue_mass() - 83.11 - 94.97);
     }
   } else if (chain_type_ == ion) {
-    Residue r = v_residues_[0];
+    const Residue& r = v_residues_[0];
     output_top_mass_line(o, ++n, cid, r.get_residue_serial(), r.get_residue_name(),
                          r.get_residue_name(), "i", r.get_residue_charge(), r.get_residue_mass());
   }
@@ -521,27 +535,20 @@ void Chain::output_top_dihedral(std::ostream& o, int& n, int& m)
   }
 }
 
-int Chain::get_protein_native_contact_number()
+std::vector<std::pair<int, int> > Chain::get_protein_native_contacts()
 {
-  int i = 0, j = 0;
-  double d = -1;
-  int n = 0;
-  ChainType cti, ctj;
-
-  for (i = 0; i < n_residue_-4; ++i) {
-    cti = v_residues_[i].get_chain_type();
-    if (cti != protein)
-      continue;
-    for (j = i + 4; j < n_residue_; ++j) {
-      ctj = v_residues_[j].get_chain_type();
-      if (ctj != protein)
-        continue;
-      d = residue_min_distance(v_residues_[i], v_residues_[j]);
-      if ( d < g_pro_pro_aa_cutoff && d > 0)
-        ++n;
-    }
+  std::vector<std::pair<int, int> > contacts;
+  for (const std::pair<int, int>& p : get_residue_contacts(v_residues_, g_pro_pro_aa_cutoff, 4)) {
+    if (v_residues_[p.first].get_chain_type() == protein
+        && v_residues_[p.second].get_chain_type() == protein)
+      contacts.push_back(p);
   }
-  return n;
+  return contacts;
+}
+
+int Chain::get_protein_native_contact_number()
+{
+  return get_protein_native_contacts().size();
 }
 
 
@@ -0,0 +1,316 @@
+/*!
+  @file clustering.cpp
+  @brief Define functions of class ClusterResult and clustering methods.
+
+  Definitions of member functions of class ClusterResult, GROMOS clustering and
+  k-medoids (PAM / CLARA) clustering.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:12
+  @copyright GNU Public License V3.0
+*/
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include "clustering.hpp"
+#include "parallel_frames.hpp"
+
+namespace pinang {
+
+void ClusterResult::reset()
+{
+  labels_.clear();
+  medoids_.clear();
+  populations_.clear();
+}
+
+void ClusterResult::set(const std::vector<int>& medoids, const std::vector<int>& labels)
+{
+  const int nc = medoids.size();
+  std::vector<int> pop(nc, 0);
+  for (int l : labels)
+    ++pop[l];
+
+  // Sort clusters by population (descending), then by medoid.
+  std::vector<int> order(nc);
+  for (int c = 0; c < nc; ++c)
+    order[c] = c;
+  std::sort(order.begin(), order.end(), [&](int a, int b) {
+      return pop[a] != pop[b] ? pop[a] > pop[b] : medoids[a] < medoids[b];
+    });
+  std::vector<int> new_label(nc);
+  medoids_.resize(nc);
+  populations_.resize(nc);
+  for (int c = 0; c < nc; ++c) {
+    new_label[order[c]] = c;
+    medoids_[c] = medoids[order[c]];
+    populations_[c] = pop[order[c]];
+  }
+  labels_.resize(labels.size());
+  for (std::size_t k = 0; k < labels.size(); ++k)
+    labels_[k] = new_label[labels[k]];
+}
+
+void ClusterResult::write_clusters(std::ostream& o, const std::function<int(int)>& frame) const
+{
+  for (int c = 0; c < get_cluster_number(); ++c)
+    o << std::setw(6) << c
+      << "   " << std::setw(8) << frame(medoids_[c])
+      << "   " << std::setw(8) << populations_[c]
+      << "\n";
+}
+
+void ClusterResult::write_labels(std::ostream& o, const std::function<int(int)>& frame) const
+{
+  for (int k = 0; k < get_size(); ++k)
+    o << std::setw(6) << frame(k)
+      << "   " << std::setw(6) << labels_[k]
+      << "\n";
+}
+
+// ------------------------------ GROMOS ------------------------------
+int cluster_gromos(int n, const std::function<double(int, int)>& dist, double cutoff,
+                   int n_thread, ClusterResult& result)
+{
+  result.reset();
+  if (n <= 0 || cutoff < 0)
+  {
+    std::cout << " ~             PINANG :: clustering         ~ " << "\n";
+    std::cerr << " ERROR: Wrong number of frames or cutoff in GROMOS clustering! " << "\n";
+    return 1;
+  }
+
+  // Neighbours j > i of each frame i, then made symmetric.
+  std::vector<std::vector<int> > neighbours(n);
+  parallel_for(n, n_thread, [&](int, int i) {
+      for (int j = i + 1; j < n; ++j)
+        if (dist(i, j) <= cutoff)
+          neighbours[i].push_back(j);
+    });
+  std::vector<int> count(n);
+  for (int i = 0; i < n; ++i)
+    count[i] = neighbours[i].size();
+  for (int i = 0; i < n; ++i)
+    for (int j : neighbours[i])
+      if (j > i) {
+        neighbours[j].push_back(i);
+        ++count[j];
+      }
+
+  std::vector<int> labels(n, -1);
+  std::vector<int> medoids;
+  std::vector<int> members;
+  int n_left = n;
+  while (n_left > 0) {
+    int center = -1;
+    for (int i = 0; i < n; ++i)
+      if (labels[i] < 0 && (center < 0 || count[i] > count[center]))
+        center = i;
+    int c = medoids.size();
+    medoids.push_back(center);
+    members.clear();
+    members.push_back(center);
+    labels[center] = c;
+    for (int j : neighbours[center])
+      if (labels[j] < 0) {
+        labels[j] = c;
+        members.push_back(j);
+      }
+    n_left -= members.size();
+    // Removed frames are no longer neighbours of the frames left.
+    for (int m : members)
+      for (int j : neighbours[m])
+        if (labels[j] < 0)
+          --count[j];
+  }
+
+  result.set(medoids, labels);
+  return 0;
+}
+
+// ------------------------------ k-medoids ------------------------------
+namespace {
+
+// PAM (BUILD + SWAP) on a distance matrix of s candidates; returns k medoids (0 .. s-1).
+std::vector<int> pam(const std::vector<double>& d, int s, int k, int n_thread)
+{
+  const double inf = std::numeric_limits<double>::max();
+  std::vector<int> medoids;
+  std::vector<bool> is_medoid(s, false);
+  std::vector<double> nearest(s, inf);
+
+  // BUILD: greedily add the candidate decreasing the total distance most.
+  for (int c = 0; c < k; ++c) {
+    std::vector<double> gain(s, -inf);
+    parallel_for(s, n_thread, [&](int, int h) {
+        if (is_medoid[h])
+          return;
+        double g = 0;
+        for (int j = 0; j < s; ++j) {
+          double dj = d[(std::size_t)h * s + j];
+          if (nearest[j] == inf)
+            g -= dj;  // first medoid: minimise the sum of distances;
+          else if (dj < nearest[j])
+            g += nearest[j] - dj;
+        }
+        gain[h] = g;
+      });
+    int best = std::max_element(gain.begin(), gain.end()) - gain.begin();
+    medoids.push_back(best);
+    is_medoid[best] = true;
+    for (int j = 0; j < s; ++j)
+      nearest[j] = std::min(nearest[j], d[(std::size_t)best * s + j]);
+  }
+
+  // SWAP: replace a medoid by a non-medoid while the total distance decreases.
+  std::vector<int> near_id(s);
+  std::vector<double> second(s);
+  std::vector<double> delta(s);
+  std::vector<int> delta_m(s);
+  for (int iter = 0; iter < 100 * k; ++iter) {
+    for (int j = 0; j < s; ++j) {
+      double d1 = inf, d2 = inf;
+      int m1 = 0;
+      for (int m = 0; m < k; ++m) {
+        double dj = d[(std::size_t)medoids[m] * s + j];
+        if (dj < d1) {
+          d2 = d1;
+          d1 = dj;
+          m1 = m;
+        } else if (dj < d2) {
+          d2 = dj;
+        }
+      }
+      nearest[j] = d1;
+      near_id[j] = m1;
+      second[j] = d2;
+    }
+    parallel_for(s, n_thread, [&](int, int h) {
+        delta[h] = 0;
+        delta_m[h] = -1;
+        if (is_medoid[h])
+          return;
+        for (int m = 0; m < k; ++m) {
+          double dc = 0;
+          for (int j = 0; j < s; ++j) {
+            double dh = d[(std::size_t)h * s + j];
+            double dn = near_id[j] == m ? std::min(dh, second[j]) : std::min(dh, nearest[j]);
+            dc += dn - nearest[j];
+          }
+          if (dc < delta[h]) {
+            delta[h] = dc;
+            delta_m[h] = m;
+          }
+        }
+      });
+    int best = std::min_element(delta.begin(), delta.end()) - delta.begin();
+    if (delta_m[best] < 0 || delta[best] > -1e-10)
+      break;
+    is_medoid[medoids[delta_m[best]]] = false;
+    medoids[delta_m[best]] = best;
+    is_medoid[best] = true;
+  }
+  return medoids;
+}
+
+}  // anonymous namespace
+
+int cluster_kmedoids(int n, const std::function<double(int, int)>& dist, int k,
+                     int n_thread, ClusterResult& result, int n_sample, int n_repeat,
+                     unsigned seed)
+{
+  result.reset();
+  if (n <= 0 || k <= 0 || k > n)
+  {
+    std::cout << " ~             PINANG :: clustering         ~ " << "\n";
+    std::cerr << " ERROR: Wrong number of frames or clusters in k-medoids clustering! " << "\n";
+    return 1;
+  }
+  if (n_sample <= 0)
+    n_sample = 40 + 2 * k;
+  if (n_sample >= n) {
+    n_sample = n;
+    n_repeat = 1;
+  }
+  if (n_sample < k)
+    n_sample = k;
+  if (n_repeat < 1)
+    n_repeat = 1;
+
+  std::mt19937 rng(seed);
+  const double inf = std::numeric_limits<double>::max();
+  double best_cost = inf;
+  std::vector<int> best_medoids;
+  std::vector<int> best_labels;
+  std::vector<int> labels(n);
+  std::vector<double> d_min(n);
+  std::vector<double> d(n_sample * (std::size_t)n_sample);
+
+  for (int r = 0; r < n_repeat; ++r) {
+    // Sample: the best medoids so far, and random frames.
+    std::vector<int> sample;
+    std::vector<bool> used(n, false);
+    for (int m : best_medoids) {
+      sample.push_back(m);
+      used[m] = true;
+    }
+    if (n_sample == n) {
+      sample.clear();
+      for (int i = 0; i < n; ++i)
+        sample.push_back(i);
+    } else {
+      std::uniform_int_distribution<int> uni(0, n - 1);
+      while ((int)sample.size() < n_sample) {
+        int i = uni(rng);
+        if (!used[i]) {
+          used[i] = true;
+          sample.push_back(i);
+        }
+      }
+    }
+
+    const int s = sample.size();
+    parallel_for(s, n_thread, [&](int, int i) {
+        d[(std::size_t)i * s + i] = 0;
+        for (int j = i + 1; j < s; ++j)
+          d[(std::size_t)i * s + j] = dist(sample[i], sample[j]);
+      });
+    for (int i = 0; i < s; ++i)
+      for (int j = 0; j < i; ++j)
+        d[(std::size_t)i * s + j] = d[(std::size_t)j * s + i];
+
+    std::vector<int> medoids = pam(d, s, k, n_thread);
+    for (int& m : medoids)
+      m = sample[m];
+
+    // Assign every frame to the nearest medoid.
+    parallel_for(n, n_thread, [&](int, int i) {
+        double dm = inf;
+        int lm = 0;
+        for (int c = 0; c < k; ++c) {
+          double dc = medoids[c] == i ? 0.0 : dist(i, medoids[c]);
+          if (dc < dm) {
+            dm = dc;
+            lm = c;
+          }
+        }
+        labels[i] = lm;
+        d_min[i] = dm;
+      });
+    double cost = 0;
+    for (int i = 0; i < n; ++i)
+      cost += d_min[i];
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_medoids = medoids;
+      best_labels = labels;
+    }
+  }
+
+  result.set(best_medoids, best_labels);
+  return 0;
+}
+
+}  // pinang
@@ -9,6 +9,7 @@
   @copyright GNU Public License V3.0
 */
 
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include "ff_protein_DNA_specific.hpp"
@@ -16,6 +17,13 @@
 namespace pinang {
 
 double FFProteinDNASpecific::compute_energy_protein_DNA_specific(Topology &top, Conformation &conf)
+{
+  VerletList list;
+  return compute_energy_protein_DNA_specific(top, conf, list);
+}
+
+double FFProteinDNASpecific::compute_energy_protein_DNA_specific(Topology &top, Conformation &conf,
+                                                                 VerletList &list)
 {
   double total_energy = 0;
   std::vector<int> dna_index;
@@ -32,9 +40,28 @@ double FFProteinDNASpecific::compute_energy_protein_DNA_specific(Topology &top,
     }
   }
 
+  if (n_protein_particle_ == 0)
+    return total_energy;
+
+  // Candidate (protein, DNA base) pairs from the Verlet list, within the
+  // largest cutoff of all protein particles;
+  std::vector<Vec3d> coors_pro(n_protein_particle_);
+  std::vector<Vec3d> coors_dna(dna_index.size());
+  double max_cutoff = 0;
+  for (i = 0; i < n_protein_particle_; ++i) {
+    coors_pro[i] = conf.get_coordinate(ss_pairwise_params_[i].protein_serial_);
+    max_cutoff = std::max(max_cutoff, ss_pairwise_params_[i].d_cutoff_);
+  }
+  for (j = 0; j < int(dna_index.size()); ++j)
+    coors_dna[j] = conf.get_coordinate(dna_index[j]);
+  if (list.get_cutoff() < max_cutoff)
+    list.set_cutoff(max_cutoff, list.get_skin());
+  if (list.update(coors_pro, coors_dna))
+    exit(EXIT_SUCCESS);
+
   // std::cout << "n_protein_particle_ :  " << n_protein_particle_ << "\n";
   for (i = 0; i < n_protein_particle_; ++i) {
-    PairProteinDNASpecificCombination tmp_pair = ss_pairwise_params_[i];
+    const PairProteinDNASpecificCombination& tmp_pair = ss_pairwise_params_[i];
     int proi = tmp_pair.protein_serial_;  // protein particle index;
     // std::cout << " protein particle: " << i << "   serial: " << proi + 1 << "\n";
     Vec3d tmp_c_CA = conf.get_coordinate(proi);         // protein Calpha coordinates;
@@ -62,8 +89,8 @@ double FFProteinDNASpecific::compute_energy_protein_DNA_specific(Topology &top,
     }
     Vec3d tmp_CCA_NCA = tmp_c_CA_N - tmp_c_CA_C;
     double dist_cutoff = tmp_pair.d_cutoff_;
-    for (j = 0; j < dna_index.size(); ++j) {
-      int dnai = dna_index[j];                          // DNA particle index;
+    for (const int* jp = list.neighbors_begin(i); jp != list.neighbors_end(i); ++jp) {
+      int dnai = dna_index[*jp];                        // DNA particle index;
       char tmp_chain_id = top.get_particle(dnai).get_chain_ID();
       std::string tmp_base_name = top.get_particle(dnai).get_residue_name();
       Vec3d tmp_c_B0 = conf.get_coordinate(dnai);       // DNA Base coordinates;
@@ -91,7 +118,7 @@ double FFProteinDNASpecific::compute_energy_protein_DNA_specific(Topology &top,
       double tmp_angle_NC = vec_angle(tmp_CCA_NCA,  tmp_B0_CA);
       // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ CORE CALCULATION! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
       for (k = 0; k < tmp_pair.n_inter_pair_; ++k) {
-        PairProteinDNASpecific p = tmp_pair.interaction_pairs_[k];
+        const PairProteinDNASpecific& p = tmp_pair.interaction_pairs_[k];
         double f1 = 0, f2 = 0, f3 = 0, f4 = 0;  // f1: bond; f2: angle 0; f3: angle NC; f4: angle 53;
         double dr = tmp_distance - p.r_0_;
         f1 = exp(- (dr * dr) / p.twice_sigma_square_);
@@ -53,6 +53,12 @@ void Conformation::reset()
   coordinates_.clear();
 }
 
+void Conformation::swap(Conformation& c)
+{
+  coordinates_.swap(c.coordinates_);
+  std::swap(n_atom_, c.n_atom_);
+}
+
 int Conformation::set_coordinate(int i, Vec3d c)
 {
   if (i >= n_atom_)
@@ -93,4 +99,14 @@ Vec3d& Conformation::get_coordinate(int n)
   }
 }
 
+CoordinateView<double> Conformation::get_view() const
+{
+  // Vec3d is three doubles without padding, so coordinates_ is x, y, z, x, ...
+  static_assert(sizeof(Vec3d) == 3 * sizeof(double), "Vec3d must be 3 packed doubles");
+  if (coordinates_.empty())
+    return CoordinateView<double>();
+  const double* p = reinterpret_cast<const double*>(&coordinates_[0]);
+  return CoordinateView<double>(p, p + 1, p + 2, n_atom_, 3);
+}
+
 }  // pinang
@@ -2,13 +2,17 @@
   @file constants.cpp
   @brief Defines lots of physical constants.
 
-  Definitions of physical constants and functions.
+  Definitions of physical constants and functions.  Residue properties are
+  kept in a constexpr table sorted by the packed residue name and found by
+  binary search; atom names are looked up with a switch over their packed
+  codes.
 
   @author Cheng Tan (noinil@gmail.com)
   @date 2016-05-24 15:39
   @copyright GNU Public License V3.0
 */
 
+#include <algorithm>
 #include <vector>
 #include "constants.hpp"
 
@@ -32,213 +36,90 @@ std::string chainType_2_string(ChainType ct)
   return chainType_name[ct];
 }
 
-PhysicalProperty::PhysicalProperty()
+namespace {
+
+//! @brief Properties of known residues, sorted by code for get_residue_property().
+constexpr ResidueProperty k_residue_table[] = {
+  // code              short type          mass  charge
+  {residue_code("A  "), "nA", na,         312.18, -1.0},
+  {residue_code("ALA"), "aA", protein,   71.0788,  0.0},
+  {residue_code("ARG"), "aR", protein,  156.1875,  1.0},
+  {residue_code("ASN"), "aN", protein,  114.1038,  0.0},
+  {residue_code("ASP"), "aD", protein,  115.0886, -1.0},
+  {residue_code("C  "), "nC", na,         288.17, -1.0},
+  {residue_code("CA "), "ic", ion,         40.08,  2.0},
+  {residue_code("CYS"), "aC", protein,  103.1388,  0.0},
+  {residue_code("DA "), "dA", DNA,        312.18, -1.0},
+  {residue_code("DA3"), "dA", DNA,        312.18, -1.0},
+  {residue_code("DA5"), "dA", DNA,        312.18, -1.0},
+  {residue_code("DC "), "dC", DNA,        288.17, -1.0},
+  {residue_code("DC3"), "dC", DNA,        288.17, -1.0},
+  {residue_code("DC5"), "dC", DNA,        288.17, -1.0},
+  {residue_code("DG "), "dG", DNA,        328.18, -1.0},
+  {residue_code("DG3"), "dG", DNA,        328.18, -1.0},
+  {residue_code("DG5"), "dG", DNA,        328.18, -1.0},
+  {residue_code("DT "), "dT", DNA,       303.181, -1.0},
+  {residue_code("DT3"), "dT", DNA,       303.181, -1.0},
+  {residue_code("DT5"), "dT", DNA,       303.181, -1.0},
+  {residue_code("G  "), "nG", na,         328.18, -1.0},
+  {residue_code("GLN"), "aQ", protein,  128.1307,  0.0},
+  {residue_code("GLU"), "aE", protein,  129.1155, -1.0},
+  {residue_code("GLY"), "aG", protein,   57.0519,  0.0},
+  {residue_code("HIS"), "aH", protein,  137.1411,  1.0},
+  {residue_code("HOH"), "wt", water,      18.014,  0.0},
+  {residue_code("ILE"), "aI", protein,  113.1594,  0.0},
+  {residue_code("LEU"), "aL", protein,  113.1594,  0.0},
+  {residue_code("LYS"), "aK", protein,  128.1741,  1.0},
+  {residue_code("MET"), "aM", protein,  131.1926,  0.0},
+  {residue_code("MG "), "im", ion,        24.305,  2.0},
+  {residue_code("PHE"), "aF", protein,  147.1766,  0.0},
+  {residue_code("PRO"), "aP", protein,   97.1167,  0.0},
+  {residue_code("RA "), "rA", RNA,       328.198, -1.0},
+  {residue_code("RC "), "rC", RNA,       304.173, -1.0},
+  {residue_code("RG "), "rG", RNA,       344.197, -1.0},
+  {residue_code("RU "), "rU", RNA,       305.158, -1.0},
+  {residue_code("SEC"), "aU", protein,  150.0379,  0.0},
+  {residue_code("SER"), "aS", protein,   87.0782,  0.0},
+  {residue_code("T  "), "nT", na,        303.181, -1.0},
+  {residue_code("THR"), "aT", protein,  101.1051,  0.0},
+  {residue_code("TRP"), "aW", protein,  186.2132,  0.0},
+  {residue_code("TYR"), "aY", protein,  163.1760,  0.0},
+  {residue_code("U  "), "nU", na,        305.158, -1.0},
+  {residue_code("VAL"), "aV", protein,   99.1326,  0.0},
+  {residue_code("ZN "), "iz", ion,        65.409,  2.0},
+};
+
+constexpr int k_residue_table_size = sizeof(k_residue_table) / sizeof(k_residue_table[0]);
+
+//! @brief Check that k_residue_table[i..] is sorted by code.
+constexpr bool residue_table_sorted(int i)
 {
-  // ---------- full name to short name ----------
-  map_resName_shortName["ALA"] = "aA";
-  map_resName_shortName["ARG"] = "aR";
-  map_resName_shortName["ASN"] = "aN";
-  map_resName_shortName["ASP"] = "aD";
-  map_resName_shortName["CYS"] = "aC";
-  map_resName_shortName["GLN"] = "aQ";
-  map_resName_shortName["GLU"] = "aE";
-  map_resName_shortName["GLY"] = "aG";
-  map_resName_shortName["HIS"] = "aH";
-  map_resName_shortName["ILE"] = "aI";
-  map_resName_shortName["LEU"] = "aL";
-  map_resName_shortName["LYS"] = "aK";
-  map_resName_shortName["MET"] = "aM";
-  map_resName_shortName["PHE"] = "aF";
-  map_resName_shortName["PRO"] = "aP";
-  map_resName_shortName["SER"] = "aS";
-  map_resName_shortName["SEC"] = "aU";
-  map_resName_shortName["THR"] = "aT";
-  map_resName_shortName["TRP"] = "aW";
-  map_resName_shortName["TYR"] = "aY";
-  map_resName_shortName["VAL"] = "aV";
-  map_resName_shortName["A  "] = "nA";
-  map_resName_shortName["DA "] = "dA";
-  map_resName_shortName["DA3"] = "dA";
-  map_resName_shortName["DA5"] = "dA";
-  map_resName_shortName["G  "] = "nG";
-  map_resName_shortName["DG "] = "dG";
-  map_resName_shortName["DG3"] = "dG";
-  map_resName_shortName["DG5"] = "dG";
-  map_resName_shortName["C  "] = "nC";
-  map_resName_shortName["DC "] = "dC";
-  map_resName_shortName["DC3"] = "dC";
-  map_resName_shortName["DC5"] = "dC";
-  map_resName_shortName["T  "] = "nT";
-  map_resName_shortName["DT "] = "dT";
-  map_resName_shortName["DT3"] = "dT";
-  map_resName_shortName["DT5"] = "dT";
-  map_resName_shortName["RA "] = "rA";
-  map_resName_shortName["RG "] = "rG";
-  map_resName_shortName["RC "] = "rC";
-  map_resName_shortName["RU "] = "rU";
-  map_resName_shortName["U  "] = "nU";
-  map_resName_shortName["ZN "] = "iz";
-  map_resName_shortName["CA "] = "ic";
-  map_resName_shortName["MG "] = "im";
-  map_resName_shortName["HOH"] = "wt";
-
-  // ---------- full name to mass ----------
-  map_resName_mass["ALA"] = 71.0788;
-  map_resName_mass["ARG"] = 156.1875;
-  map_resName_mass["ASN"] = 114.1038;
-  map_resName_mass["ASP"] = 115.0886;
-  map_resName_mass["CYS"] = 103.1388;
-  map_resName_mass["GLU"] = 129.1155;
-  map_resName_mass["GLN"] = 128.1307;
-  map_resName_mass["GLY"] = 57.0519;
-  map_resName_mass["HIS"] = 137.1411;
-  map_resName_mass["ILE"] = 113.1594;
-  map_resName_mass["LEU"] = 113.1594;
-  map_resName_mass["LYS"] = 128.1741;
-  map_resName_mass["MET"] = 131.1926;
-  map_resName_mass["PHE"] = 147.1766;
-  map_resName_mass["PRO"] = 97.1167;
-  map_resName_mass["SER"] = 87.0782;
-  map_resName_mass["SEC"] = 150.0379;
-  map_resName_mass["THR"] = 101.1051;
-  map_resName_mass["TRP"] = 186.2132;
-  map_resName_mass["TYR"] = 163.1760;
-  map_resName_mass["VAL"] = 99.1326;
-  map_resName_mass["A  "] = 312.18;
-  map_resName_mass["DA "] = 312.18;
-  map_resName_mass["DA3"] = 312.18;
-  map_resName_mass["DA5"] = 312.18;
-  map_resName_mass["C  "] = 288.17;
-  map_resName_mass["DC "] = 288.17;
-  map_resName_mass["DC3"] = 288.17;
-  map_resName_mass["DC5"] = 288.17;
-  map_resName_mass["G  "] = 328.18;
-  map_resName_mass["DG "] = 328.18;
-  map_resName_mass["DG3"] = 328.18;
-  map_resName_mass["DG5"] = 328.18;
-  map_resName_mass["T  "] = 303.181;
-  map_resName_mass["DT "] = 303.181;
-  map_resName_mass["DT3"] = 303.181;
-  map_resName_mass["DT5"] = 303.181;
-  map_resName_mass["RA "] = 328.198;
-  map_resName_mass["RC "] = 304.173;
-  map_resName_mass["RU "] = 305.158;
-  map_resName_mass["RG "] = 344.197;
-  map_resName_mass["U  "] = 305.158;
-  map_resName_mass["ZN "] = 65.409;
-  map_resName_mass["CA "] = 40.08;
-  map_resName_mass["MG "] = 24.305;
-  map_resName_mass["HOH"] = 18.014;
-
-  // ---------- full name to charg ----------
-  map_resName_charge["ALA"] = 0.0;
-  map_resName_charge["ARG"] = 1.0;
-  map_resName_charge["ASN"] = 0.0;
-  map_resName_charge["ASP"] = -1.0;
-  map_resName_charge["CYS"] = 0.0;
-  map_resName_charge["GLU"] = -1.0;
-  map_resName_charge["GLN"] = 0.0;
-  map_resName_charge["GLY"] = 0.0;
-  map_resName_charge["HIS"] = 1.0;
-  map_resName_charge["ILE"] = 0.0;
-  map_resName_charge["LEU"] = 0.0;
-  map_resName_charge["LYS"] = 1.0;
-  map_resName_charge["MET"] = 0.0;
-  map_resName_charge["PHE"] = 0.0;
-  map_resName_charge["PRO"] = 0.0;
-  map_resName_charge["SER"] = 0.0;
-  map_resName_charge["SEC"] = 0.0;
-  map_resName_charge["THR"] = 0.0;
-  map_resName_charge["TRP"] = 0.0;
-  map_resName_charge["TYR"] = 0.0;
-  map_resName_charge["VAL"] = 0.0;
-  map_resName_charge["A  "] = -1.0;
-  map_resName_charge["DA "] = -1.0;
-  map_resName_charge["DA3"] = -1.0;
-  map_resName_charge["DA5"] = -1.0;
-  map_resName_charge["C  "] = -1.0;
-  map_resName_charge["DC "] = -1.0;
-  map_resName_charge["DC3"] = -1.0;
-  map_resName_charge["DC5"] = -1.0;
-  map_resName_charge["G  "] = -1.0;
-  map_resName_charge["DG "] = -1.0;
-  map_resName_charge["DG3"] = -1.0;
-  map_resName_charge["DG5"] = -1.0;
-  map_resName_charge["T  "] = -1.0;
-  map_resName_charge["DT "] = -1.0;
-  map_resName_charge["DT3"] = -1.0;
-  map_resName_charge["DT5"] = -1.0;
-  map_resName_charge["RA "] = -1.0;
-  map_resName_charge["RC "] = -1.0;
-  map_resName_charge["RG "] = -1.0;
-  map_resName_charge["RU "] = -1.0;
-  map_resName_charge["U  "] = -1.0;
-  map_resName_charge["ZN "] = 2.0;
-  map_resName_charge["CA "] = 2.0;
-  map_resName_charge["MG "] = 2.0;
-  map_resName_charge["HOH"] = 0.0;
-
-  // ---------- full name to residue type ----------
-  map_resName_chainType["ALA"] = protein;
-  map_resName_chainType["ARG"] = protein;
-  map_resName_chainType["ASN"] = protein;
-  map_resName_chainType["ASP"] = protein;
-  map_resName_chainType["CYS"] = protein;
-  map_resName_chainType["GLU"] = protein;
-  map_resName_chainType["GLN"] = protein;
-  map_resName_chainType["GLY"] = protein;
-  map_resName_chainType["HIS"] = protein;
-  map_resName_chainType["ILE"] = protein;
-  map_resName_chainType["LEU"] = protein;
-  map_resName_chainType["LYS"] = protein;
-  map_resName_chainType["MET"] = protein;
-  map_resName_chainType["PHE"] = protein;
-  map_resName_chainType["PRO"] = protein;
-  map_resName_chainType["SER"] = protein;
-  map_resName_chainType["SEC"] = protein;
-  map_resName_chainType["THR"] = protein;
-  map_resName_chainType["TRP"] = protein;
-  map_resName_chainType["TYR"] = protein;
-  map_resName_chainType["VAL"] = protein;
-  map_resName_chainType["A  "] = na;
-  map_resName_chainType["DA "] = DNA;
-  map_resName_chainType["DA3"] = DNA;
-  map_resName_chainType["DA5"] = DNA;
-  map_resName_chainType["T  "] = na;
-  map_resName_chainType["DT "] = DNA;
-  map_resName_chainType["DT3"] = DNA;
-  map_resName_chainType["DT5"] = DNA;
-  map_resName_chainType["G  "] = na;
-  map_resName_chainType["DG "] = DNA;
-  map_resName_chainType["DG3"] = DNA;
-  map_resName_chainType["DG5"] = DNA;
-  map_resName_chainType["C  "] = na;
-  map_resName_chainType["DC "] = DNA;
-  map_resName_chainType["DC3"] = DNA;
-  map_resName_chainType["DC5"] = DNA;
-  map_resName_chainType["RA "] = RNA;
-  map_resName_chainType["RC "] = RNA;
-  map_resName_chainType["RG "] = RNA;
-  map_resName_chainType["RU "] = RNA;
-  map_resName_chainType["U  "] = na;
-  map_resName_chainType["ZN "] = ion;
-  map_resName_chainType["CA "] = ion;
-  map_resName_chainType["MG "] = ion;
-  map_resName_chainType["HOH"] = water;
+  return i + 1 >= k_residue_table_size
+      || (k_residue_table[i].code < k_residue_table[i + 1].code && residue_table_sorted(i + 1));
 }
+static_assert(residue_table_sorted(0), "k_residue_table must be sorted by residue code");
+
+}  // namespace
 
-PhysicalProperty::~PhysicalProperty() {
-  map_resName_shortName.clear();
-  map_resName_charge.clear();
-  map_resName_mass.clear();
-  map_resName_chainType.clear();
+const ResidueProperty* get_residue_property(const std::string& s)
+{
+  if (s.size() != 3)
+    return nullptr;
+  const unsigned int c = residue_code(s[0], s[1], s[2]);
+  const ResidueProperty* end = k_residue_table + k_residue_table_size;
+  const ResidueProperty* p = std::lower_bound(
+      k_residue_table, end, c,
+      [](const ResidueProperty& r, unsigned int code) { return r.code < code; });
+  if (p != end && p->code == c)
+    return p;
+  return nullptr;
 }
 
 std::string PhysicalProperty::get_short_name(const std::string& s)
 {
-  auto search = map_resName_shortName.find(s);
-  if (search != map_resName_shortName.end()) {
-    return search->second;
+  const ResidueProperty* p = get_residue_property(s);
+  if (p) {
+    return std::string(p->short_name, 2);
   } else {
     std::cout << " ~             PINANG :: constants.hpp          ~ " << "\n";
     std::cerr << " WARNING: Cannot find residue name for short name: "
@@ -249,9 +130,9 @@ std::string PhysicalProperty::get_short_name(const std::string& s)
 
 double PhysicalProperty::get_charge(const std::string& s)
 {
-  auto search = map_resName_charge.find(s);
-  if (search != map_resName_charge.end()) {
-    return search->second;
+  const ResidueProperty* p = get_residue_property(s);
+  if (p) {
+    return p->charge;
   } else {
     std::cout << " ~             PINANG :: constants.hpp          ~ " << "\n";
     std::cerr << " WARNING: Cannot find residue name for charge: "
@@ -262,9 +143,9 @@ double PhysicalProperty::get_charge(const std::string& s)
 
 double PhysicalProperty::get_mass(const std::string& s)
 {
-  auto search = map_resName_mass.find(s);
-  if (search != map_resName_mass.end()) {
-    return search->second;
+  const ResidueProperty* p = get_residue_property(s);
+  if (p) {
+    return p->mass;
   } else {
     std::cout << " ~             PINANG :: constants.hpp          ~ " << "\n";
     std::cerr << " WARNING: Cannot find residue name for mass: "
@@ -275,9 +156,9 @@ double PhysicalProperty::get_mass(const std::string& s)
 
 ChainType PhysicalProperty::get_chain_type(const std::string& s)
 {
-  auto search = map_resName_chainType.find(s);
-  if (search != map_resName_chainType.end()) {
-    return search->second;
+  const ResidueProperty* p = get_residue_property(s);
+  if (p) {
+    return p->chain_type;
   } else {
     std::cout << " ~             PINANG :: constants.hpp          ~ " << "\n";
     std::cerr << " WARNING: Cannot find residue name for chain type: "
@@ -288,51 +169,55 @@ ChainType PhysicalProperty::get_chain_type(const std::string& s)
 
 std::string get_DNA_atom_position_info(const std::string& rname, const std::string& aname)
 {
-  if (aname == "P   " || aname == "OP1 " || aname == "OP2 " || aname == "O3' " ||
-      aname == "O5' " || aname == "O1P " || aname == "O2P ") {
-    return "Phosphate";
+  unsigned int a = aname.size() == 4 ? atom_code(aname[0], aname[1], aname[2], aname[3]) : 0;
+  switch (a) {
+    case atom_code("P   "): case atom_code("OP1 "): case atom_code("OP2 "): case atom_code("O3' "):
+    case atom_code("O5' "): case atom_code("O1P "): case atom_code("O2P "):
+      return "Phosphate";
   }
-  std::string::size_type np;
-  np = aname.find("'");
-  if (np != std::string::npos) {
+  if (aname.find('\'') != std::string::npos) {
     return "Sugar";
   }
 
-  if (rname == "DA ") {
-    if (aname == "N1  " || aname == "C2  " || aname == "N3  " || aname == "C4  " || aname == "N9  ") {
-      return "Minor";
-    } else if (aname == "C5  " || aname == "C6  " || aname == "N6  " || aname == "N7  " || aname == "C8  ") {
-      return "Major";
-    } else {
+  unsigned int r = rname.size() == 3 ? residue_code(rname[0], rname[1], rname[2]) : 0;
+  switch (r) {
+    case residue_code("DA "):
+      switch (a) {
+        case atom_code("N1  "): case atom_code("C2  "): case atom_code("N3  "): case atom_code("C4  "):
+        case atom_code("N9  "):
+          return "Minor";
+        case atom_code("C5  "): case atom_code("C6  "): case atom_code("N6  "): case atom_code("N7  "):
+        case atom_code("C8  "):
+          return "Major";
+      }
       return "Unknown";
-    }
-  }
-  if (rname == "DG ") {
-    if (aname == "N2  " || aname == "C2  " || aname == "N3  " || aname == "C4  " || aname == "N9  ") {
-      return "Minor";
-    } else if (aname == "C5  " || aname == "C6  " || aname == "O6  " || aname == "N7  " || aname == "C8  ") {
-      return "Major";
-    } else {
+    case residue_code("DG "):
+      switch (a) {
+        case atom_code("N2  "): case atom_code("C2  "): case atom_code("N3  "): case atom_code("C4  "):
+        case atom_code("N9  "):
+          return "Minor";
+        case atom_code("C5  "): case atom_code("C6  "): case atom_code("O6  "): case atom_code("N7  "):
+        case atom_code("C8  "):
+          return "Major";
+      }
       return "Unknown";
-    }
-  }
-  if (rname == "DC ") {
-    if (aname == "C2  " || aname == "O2  " || aname == "N1  ") {
-      return "Minor";
-    } else if (aname == "C4  " || aname == "N4  " || aname == "C5  " || aname == "C6  ") {
-      return "Major";
-    } else {
+    case residue_code("DC "):
+      switch (a) {
+        case atom_code("C2  "): case atom_code("O2  "): case atom_code("N1  "):
+          return "Minor";
+        case atom_code("C4  "): case atom_code("N4  "): case atom_code("C5  "): case atom_code("C6  "):
+          return "Major";
+      }
       return "Unknown";
-    }
-  }
-  if (rname == "DT ") {
-    if (aname == "C2  " || aname == "O2  " || aname == "N3  " || aname == "N1  ") {
-      return "Minor";
-    } else if (aname == "C4  " || aname == "O4  " || aname == "C5  " || aname == "C6  " || aname == "C7  ") {
-      return "Major";
-    } else {
+    case residue_code("DT "):
+      switch (a) {
+        case atom_code("C2  "): case atom_code("O2  "): case atom_code("N3  "): case atom_code("N1  "):
+          return "Minor";
+        case atom_code("C4  "): case atom_code("O4  "): case atom_code("C5  "): case atom_code("C6  "):
+        case atom_code("C7  "):
+          return "Major";
+      }
       return "Unknown";
-    }
   }
   return "Unknown";
 }
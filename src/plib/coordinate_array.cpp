@@ -0,0 +1,332 @@
+/*!
+  @file coordinate_array.cpp
+  @brief Define kernels working on CoordinateView and CoordinateArray.
+
+  Kernels for centroid, center of mass, radius of gyration, RMSD, translation and
+  rotation.  Single precision input is converted to double precision before
+  accumulation.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 12:58
+  @copyright GNU Public License V3.0
+*/
+
+#include <cmath>
+#include "coordinate_array.hpp"
+#include "geometry.hpp"
+
+namespace pinang {
+
+namespace {
+
+void check_size(int m1, int m2, const char* what)
+{
+  if (m1 != m2) {
+    std::cout << " ~         PINANG :: coordinate_array.cpp   ~ " << "\n";
+    std::cerr << " ERROR: inconsistent number of atoms when calculating "
+              << what << "!" << "\n";
+    exit(EXIT_SUCCESS);
+  }
+}
+
+}  // anonymous namespace
+
+template <typename T>
+Vec3d get_centroid(const CoordinateView<T>& v)
+{
+  const int n = v.get_size();
+  const int s = v.get_stride();
+  const T* x = v.x();
+  const T* y = v.y();
+  const T* z = v.z();
+  double sx = 0, sy = 0, sz = 0;
+  for (int i = 0; i < n; ++i) {
+    sx += x[i * s];
+    sy += y[i * s];
+    sz += z[i * s];
+  }
+  return Vec3d(sx / n, sy / n, sz / n);
+}
+
+template <typename T>
+Vec3d get_center_of_mass(const CoordinateView<T>& v, const std::vector<double>& masses)
+{
+  const int n = v.get_size();
+  const int s = v.get_stride();
+  check_size(n, masses.size(), "COM");
+  const T* x = v.x();
+  const T* y = v.y();
+  const T* z = v.z();
+  const double* m = masses.data();
+  double sx = 0, sy = 0, sz = 0, sm = 0;
+  for (int i = 0; i < n; ++i) {
+    sx += m[i] * x[i * s];
+    sy += m[i] * y[i * s];
+    sz += m[i] * z[i * s];
+    sm += m[i];
+  }
+  return Vec3d(sx / sm, sy / sm, sz / sm);
+}
+
+template <typename T>
+double get_radius_of_gyration(const CoordinateView<T>& v)
+{
+  const int n = v.get_size();
+  const int s = v.get_stride();
+  const T* x = v.x();
+  const T* y = v.y();
+  const T* z = v.z();
+  Vec3d ctr = get_centroid(v);
+  const double cx = ctr.x(), cy = ctr.y(), cz = ctr.z();
+  double d = 0;
+  for (int i = 0; i < n; ++i) {
+    double dx = x[i * s] - cx;
+    double dy = y[i * s] - cy;
+    double dz = z[i * s] - cz;
+    d += dx * dx + dy * dy + dz * dz;
+  }
+  return sqrt(d / n);
+}
+
+template <typename T>
+double get_rmsd(const CoordinateView<T>& v1, const CoordinateView<T>& v2)
+{
+  const int n = v1.get_size();
+  check_size(n, v2.get_size(), "RMSD");
+  const int s1 = v1.get_stride();
+  const int s2 = v2.get_stride();
+  const T* x1 = v1.x();
+  const T* y1 = v1.y();
+  const T* z1 = v1.z();
+  const T* x2 = v2.x();
+  const T* y2 = v2.y();
+  const T* z2 = v2.z();
+  double d = 0;
+  for (int i = 0; i < n; ++i) {
+    double dx = x1[i * s1] - x2[i * s2];
+    double dy = y1[i * s1] - y2[i * s2];
+    double dz = z1[i * s1] - z2[i * s2];
+    d += dx * dx + dy * dy + dz * dz;
+  }
+  return sqrt(d / n);
+}
+
+template <typename T>
+void get_inner_product(const CoordinateView<T>& va, const CoordinateView<T>& vb,
+                       double* m, double* g, Vec3d& ctr_a, Vec3d& ctr_b)
+{
+  const int n = va.get_size();
+  check_size(n, vb.get_size(), "inner product");
+  for (int k = 0; k < 9; ++k)
+    m[k] = 0;
+  g[0] = g[1] = 0;
+  ctr_a = Vec3d(0.0, 0.0, 0.0);
+  ctr_b = Vec3d(0.0, 0.0, 0.0);
+  if (n == 0)
+    return;
+
+  const int sa = va.get_stride();
+  const int sb = vb.get_stride();
+  const T* ax = va.x();
+  const T* ay = va.y();
+  const T* az = va.z();
+  const T* bx = vb.x();
+  const T* by = vb.y();
+  const T* bz = vb.z();
+
+  // Sums are taken relative to the first coordinates, to limit cancellation
+  // when the centering is done afterwards.
+  const double ox = ax[0], oy = ay[0], oz = az[0];
+  const double px = bx[0], py = by[0], pz = bz[0];
+  double s[17] = {0};  // sum a (3), sum b (3), sum a_i b_j (9), sum |a|^2, sum |b|^2;
+  for (int i = 0; i < n; ++i) {
+    double x1 = ax[i * sa] - ox, y1 = ay[i * sa] - oy, z1 = az[i * sa] - oz;
+    double x2 = bx[i * sb] - px, y2 = by[i * sb] - py, z2 = bz[i * sb] - pz;
+    s[0] += x1;
+    s[1] += y1;
+    s[2] += z1;
+    s[3] += x2;
+    s[4] += y2;
+    s[5] += z2;
+    s[6] += x1 * x2;
+    s[7] += x1 * y2;
+    s[8] += x1 * z2;
+    s[9] += y1 * x2;
+    s[10] += y1 * y2;
+    s[11] += y1 * z2;
+    s[12] += z1 * x2;
+    s[13] += z1 * y2;
+    s[14] += z1 * z2;
+    s[15] += x1 * x1 + y1 * y1 + z1 * z1;
+    s[16] += x2 * x2 + y2 * y2 + z2 * z2;
+  }
+
+  // Shift the sums to the centroids.
+  const double ma[3] = {s[0] / n, s[1] / n, s[2] / n};
+  for (int r = 0; r < 3; ++r)
+    for (int c = 0; c < 3; ++c)
+      m[3 * r + c] = s[6 + 3 * r + c] - ma[r] * s[3 + c];
+  g[0] = s[15] - (s[0] * s[0] + s[1] * s[1] + s[2] * s[2]) / n;
+  g[1] = s[16] - (s[3] * s[3] + s[4] * s[4] + s[5] * s[5]) / n;
+  ctr_a = Vec3d(ox + ma[0], oy + ma[1], oz + ma[2]);
+  ctr_b = Vec3d(px + s[3] / n, py + s[4] / n, pz + s[5] / n);
+}
+
+template <typename T>
+void get_inner_product(const CoordinateView<T>& va, const CoordinateView<T>& vb, double* m)
+{
+  const int n = va.get_size();
+  check_size(n, vb.get_size(), "inner product");
+  const int sa = va.get_stride();
+  const int sb = vb.get_stride();
+  const T* ax = va.x();
+  const T* ay = va.y();
+  const T* az = va.z();
+  const T* bx = vb.x();
+  const T* by = vb.y();
+  const T* bz = vb.z();
+  for (int k = 0; k < 9; ++k)
+    m[k] = 0;
+  for (int i = 0; i < n; ++i) {
+    double x1 = ax[i * sa], y1 = ay[i * sa], z1 = az[i * sa];
+    double x2 = bx[i * sb], y2 = by[i * sb], z2 = bz[i * sb];
+    m[0] += x1 * x2;
+    m[1] += x1 * y2;
+    m[2] += x1 * z2;
+    m[3] += y1 * x2;
+    m[4] += y1 * y2;
+    m[5] += y1 * z2;
+    m[6] += z1 * x2;
+    m[7] += z1 * y2;
+    m[8] += z1 * z2;
+  }
+}
+
+template <typename T>
+void get_inner_product(const CoordinateView<T>& va, const CoordinateView<double>& vb,
+                       double* m, double& g_a, Vec3d& ctr_a)
+{
+  const int n = va.get_size();
+  check_size(n, vb.get_size(), "inner product");
+  for (int k = 0; k < 9; ++k)
+    m[k] = 0;
+  g_a = 0;
+  ctr_a = Vec3d(0.0, 0.0, 0.0);
+  if (n == 0)
+    return;
+
+  const int sa = va.get_stride();
+  const int sb = vb.get_stride();
+  const T* ax = va.x();
+  const T* ay = va.y();
+  const T* az = va.z();
+  const double* bx = vb.x();
+  const double* by = vb.y();
+  const double* bz = vb.z();
+
+  // a is shifted by its first coordinates; since b sums to zero, the shift
+  // does not change sum(a_i * b_j).
+  const double ox = ax[0], oy = ay[0], oz = az[0];
+  double s[13] = {0};  // sum a_i b_j (9), sum a (3), sum |a|^2;
+  for (int i = 0; i < n; ++i) {
+    double x1 = ax[i * sa] - ox, y1 = ay[i * sa] - oy, z1 = az[i * sa] - oz;
+    double x2 = bx[i * sb], y2 = by[i * sb], z2 = bz[i * sb];
+    s[0] += x1 * x2;
+    s[1] += x1 * y2;
+    s[2] += x1 * z2;
+    s[3] += y1 * x2;
+    s[4] += y1 * y2;
+    s[5] += y1 * z2;
+    s[6] += z1 * x2;
+    s[7] += z1 * y2;
+    s[8] += z1 * z2;
+    s[9] += x1;
+    s[10] += y1;
+    s[11] += z1;
+    s[12] += x1 * x1 + y1 * y1 + z1 * z1;
+  }
+
+  for (int k = 0; k < 9; ++k)
+    m[k] = s[k];
+  g_a = s[12] - (s[9] * s[9] + s[10] * s[10] + s[11] * s[11]) / n;
+  ctr_a = Vec3d(ox + s[9] / n, oy + s[10] / n, oz + s[11] / n);
+}
+
+template <typename T>
+void translate(CoordinateArray<T>& a, const Vec3d& t)
+{
+  const int n = a.get_size();
+  T* x = a.x();
+  T* y = a.y();
+  T* z = a.z();
+  const double tx = t.x(), ty = t.y(), tz = t.z();
+  for (int i = 0; i < n; ++i) {
+    x[i] = x[i] + tx;
+    y[i] = y[i] + ty;
+    z[i] = z[i] + tz;
+  }
+}
+
+namespace {
+
+template <typename T>
+void rotate_translate(CoordinateArray<T>& a, const double r[9], const Vec3d& t)
+{
+  const int n = a.get_size();
+  T* x = a.x();
+  T* y = a.y();
+  T* z = a.z();
+  const double tx = t.x(), ty = t.y(), tz = t.z();
+  for (int i = 0; i < n; ++i) {
+    double vx = x[i], vy = y[i], vz = z[i];
+    x[i] = r[0] * vx + r[1] * vy + r[2] * vz + tx;
+    y[i] = r[3] * vx + r[4] * vy + r[5] * vz + ty;
+    z[i] = r[6] * vx + r[7] * vy + r[8] * vz + tz;
+  }
+}
+
+}  // anonymous namespace
+
+template <typename T>
+void rotate(CoordinateArray<T>& a, const Transform& t)
+{
+  double r[9];
+  t.get_rotation_matrix(r);
+  rotate_translate(a, r, Vec3d(0.0, 0.0, 0.0));
+}
+
+template <typename T>
+void apply_transform(CoordinateArray<T>& a, const Transform& t)
+{
+  double r[9];
+  t.get_rotation_matrix(r);
+  rotate_translate(a, r, t.translation());
+}
+
+// Explicit instantiations for single and double precision.
+template Vec3d get_centroid(const CoordinateView<float>&);
+template Vec3d get_centroid(const CoordinateView<double>&);
+template Vec3d get_center_of_mass(const CoordinateView<float>&, const std::vector<double>&);
+template Vec3d get_center_of_mass(const CoordinateView<double>&, const std::vector<double>&);
+template double get_radius_of_gyration(const CoordinateView<float>&);
+template double get_radius_of_gyration(const CoordinateView<double>&);
+template double get_rmsd(const CoordinateView<float>&, const CoordinateView<float>&);
+template double get_rmsd(const CoordinateView<double>&, const CoordinateView<double>&);
+template void get_inner_product(const CoordinateView<float>&, const CoordinateView<float>&,
+                                double*, double*, Vec3d&, Vec3d&);
+template void get_inner_product(const CoordinateView<double>&, const CoordinateView<double>&,
+                                double*, double*, Vec3d&, Vec3d&);
+template void get_inner_product(const CoordinateView<float>&, const CoordinateView<float>&, double*);
+template void get_inner_product(const CoordinateView<double>&, const CoordinateView<double>&, double*);
+template void get_inner_product(const CoordinateView<float>&, const CoordinateView<double>&,
+                                double*, double&, Vec3d&);
+template void get_inner_product(const CoordinateView<double>&, const CoordinateView<double>&,
+                                double*, double&, Vec3d&);
+template void translate(CoordinateArray<float>&, const Vec3d&);
+template void translate(CoordinateArray<double>&, const Vec3d&);
+template void rotate(CoordinateArray<float>&, const Transform&);
+template void rotate(CoordinateArray<double>&, const Transform&);
+template void apply_transform(CoordinateArray<float>&, const Transform&);
+template void apply_transform(CoordinateArray<double>&, const Transform&);
+
+}  // pinang
@@ -0,0 +1,190 @@
+/*!
+  @file dcd_index.cpp
+  @brief Define functions of class DcdIndex.
+
+  Definitions of member functions of class DcdIndex, including scanning dcd files
+  and reading / writing the sidecar files.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 12:46
+  @copyright GNU Public License V3.0
+*/
+
+#include <cstring>
+#include <sys/stat.h>
+#include "dcd_reader.hpp"
+
+namespace pinang {
+
+namespace {
+const char k_dcdidx_magic[8] = {'P', 'N', 'D', 'C', 'D', 'I', 'D', 'X'};
+const std::int32_t k_dcdidx_version = 2;
+}
+
+DcdIndex::DcdIndex()
+{
+  reset();
+}
+
+void DcdIndex::reset()
+{
+  file_size_ = 0;
+  file_mtime_ = 0;
+  natom_ = 0;
+  nsavc_ = 0;
+  delta_ = 0;
+  frame_offsets_.clear();
+}
+
+std::string DcdIndex::get_sidecar_name(const std::string& dcd_name)
+{
+  std::size_t n = dcd_name.size();
+  if (n >= 4 && dcd_name.compare(n - 4, 4, ".dcd") == 0)
+    return dcd_name + "idx";
+  return dcd_name + ".dcdidx";
+}
+
+int DcdIndex::stat_file(const std::string& s, std::int64_t& size, std::int64_t& mtime)
+{
+  struct stat st;
+  if (stat(s.c_str(), &st) != 0)
+    return 1;
+  size = st.st_size;
+  // in nanoseconds, so that a dcd file rewritten within a second is noticed;
+  mtime = std::int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+  return 0;
+}
+
+int DcdIndex::build(std::istream& dcd_file, const DcdHeader& header)
+{
+  const std::size_t Si = sizeof(int);
+  const int natom = header.get_natom();
+  const std::int64_t block_size = 2 * Si + std::int64_t(natom) * sizeof(float);
+  const std::int64_t uc_size = header.get_unit_cell_size();
+
+  frame_offsets_.clear();
+  natom_ = natom;
+  nsavc_ = header.get_nsavc();
+  delta_ = header.get_delta();
+
+  dcd_file.clear();
+  dcd_file.seekg(0, dcd_file.end);
+  std::int64_t filesize = dcd_file.tellg();
+  std::int64_t offset = header.get_header_size();
+  while (offset + header.get_frame_size() <= filesize) {
+    // Check leading and trailing markers of the X, Y, Z blocks.
+    bool complete = true;
+    for (int k = 0; k < 3 && complete; ++k) {
+      std::int64_t block_start = offset + uc_size + k * block_size;
+      int flag_1 = 0;
+      int flag_2 = 0;
+      dcd_file.seekg(block_start, dcd_file.beg);
+      dcd_file.read((char*)&flag_1, Si);
+      dcd_file.seekg(block_start + block_size - Si, dcd_file.beg);
+      dcd_file.read((char*)&flag_2, Si);
+      if (!dcd_file || flag_1 / 4 != natom || flag_2 != flag_1)
+        complete = false;
+    }
+    if (!complete)
+    {
+      std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+      std::cout << " !!! Coordinates mismatch the atom number. !!! "
+                << "Frames from " << frame_offsets_.size() << " on are ignored."
+                << "\n";
+      break;
+    }
+    frame_offsets_.push_back(offset);
+    offset += header.get_frame_size();
+  }
+  dcd_file.clear();
+  return 0;
+}
+
+int DcdIndex::read(const std::string& dcd_name, const DcdHeader& header)
+{
+  std::int64_t size = 0;
+  std::int64_t mtime = 0;
+  reset();
+  if (stat_file(dcd_name, size, mtime))
+    return 1;
+
+  std::ifstream idx_file(get_sidecar_name(dcd_name).c_str(), std::ifstream::binary);
+  if (!idx_file.is_open())
+    return 1;
+
+  char magic[8];
+  std::int32_t version = 0;
+  std::int64_t n_frame = 0;
+  idx_file.read(magic, 8);
+  idx_file.read((char*)&version, sizeof(version));
+  idx_file.read((char*)&file_size_, sizeof(file_size_));
+  idx_file.read((char*)&file_mtime_, sizeof(file_mtime_));
+  idx_file.read((char*)&natom_, sizeof(natom_));
+  idx_file.read((char*)&nsavc_, sizeof(nsavc_));
+  idx_file.read((char*)&delta_, sizeof(delta_));
+  idx_file.read((char*)&n_frame, sizeof(n_frame));
+  if (!idx_file || std::memcmp(magic, k_dcdidx_magic, 8) != 0
+      || version != k_dcdidx_version
+      || file_size_ != size || file_mtime_ != mtime
+      || natom_ != header.get_natom() || n_frame < 0
+      || n_frame > (size - header.get_header_size()) / header.get_frame_size())
+  {
+    reset();
+    return 1;
+  }
+  frame_offsets_.resize(n_frame);
+  if (n_frame > 0)
+    idx_file.read((char*)&frame_offsets_[0], n_frame * sizeof(std::int64_t));
+  if (!idx_file)
+  {
+    reset();
+    return 1;
+  }
+  // a damaged sidecar must not send reads past the end of the dcd file;
+  for (std::int64_t offset : frame_offsets_) {
+    if (offset < header.get_header_size() || offset + header.get_frame_size() > size)
+    {
+      reset();
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int DcdIndex::write(const std::string& dcd_name) const
+{
+  std::ofstream idx_file(get_sidecar_name(dcd_name).c_str(), std::ofstream::binary);
+  if (!idx_file.is_open())
+    return 1;
+
+  std::int64_t n_frame = frame_offsets_.size();
+  idx_file.write(k_dcdidx_magic, 8);
+  idx_file.write((const char*)&k_dcdidx_version, sizeof(k_dcdidx_version));
+  idx_file.write((const char*)&file_size_, sizeof(file_size_));
+  idx_file.write((const char*)&file_mtime_, sizeof(file_mtime_));
+  idx_file.write((const char*)&natom_, sizeof(natom_));
+  idx_file.write((const char*)&nsavc_, sizeof(nsavc_));
+  idx_file.write((const char*)&delta_, sizeof(delta_));
+  idx_file.write((const char*)&n_frame, sizeof(n_frame));
+  if (n_frame > 0)
+    idx_file.write((const char*)&frame_offsets_[0], n_frame * sizeof(std::int64_t));
+  return idx_file ? 0 : 1;
+}
+
+int DcdIndex::load(const std::string& dcd_name, std::istream& dcd_file, const DcdHeader& header)
+{
+  if (read(dcd_name, header) == 0)
+    return 0;
+
+  if (stat_file(dcd_name, file_size_, file_mtime_) || build(dcd_file, header))
+    return 1;
+  if (write(dcd_name))
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cout << " Warning: Cannot write frame index: "
+              << get_sidecar_name(dcd_name) << "\n";
+  }
+  return 0;
+}
+
+}  // pinang
@@ -0,0 +1,232 @@
+/*!
+  @file dcd_mapped_reader.cpp
+  @brief Define functions of class DcdMappedReader.
+
+  Definitions of member functions of class DcdMappedReader.  The dcd file is
+  mapped read-only with mmap, and frames are located by their offsets.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 12:40
+  @copyright GNU Public License V3.0
+*/
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "dcd_mapped_reader.hpp"
+
+namespace pinang {
+
+DcdMappedReader::DcdMappedReader()
+{
+  n_frame_ = 0;
+  range_first_ = 0;
+  range_last_ = 0;
+  range_stride_ = 1;
+  map_addr_ = 0;
+  map_size_ = 0;
+}
+
+DcdMappedReader::DcdMappedReader(const std::string& s, bool use_index)
+{
+  n_frame_ = 0;
+  range_first_ = 0;
+  range_last_ = 0;
+  range_stride_ = 1;
+  map_addr_ = 0;
+  map_size_ = 0;
+  open(s, use_index);
+}
+
+int DcdMappedReader::open(const std::string& s, bool use_index)
+{
+  close();
+  dcd_name_ = s;
+
+  std::ifstream dcd_file(dcd_name_.c_str(), std::ifstream::binary);
+  if (!dcd_file.is_open())
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cerr << " ERROR: Cannot read dcd file: " << s << "\n";
+    return 1;
+  }
+  if (header_.read(dcd_file))
+    return 1;
+  if (use_index && index_.load(dcd_name_, dcd_file, header_))
+  {
+    close();
+    return 1;
+  }
+  if (!use_index)
+    index_.read(dcd_name_, header_);  // an up-to-date sidecar is used anyway;
+  dcd_file.close();
+
+  int fd = ::open(dcd_name_.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cerr << " ERROR: Cannot read dcd file: " << s << "\n";
+    close();
+    return 1;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0)
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cout << " !!! Error: empty dcd file! !!!" << "\n";
+    ::close(fd);
+    close();
+    return 1;
+  }
+  void* addr = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED)
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cerr << " ERROR: Cannot map dcd file: " << s << "\n";
+    close();
+    return 1;
+  }
+  map_addr_ = static_cast<const char*>(addr);
+  map_size_ = st.st_size;
+  // the tools scan frames in order, so keep readahead on by default;
+  set_random_access(false);
+  if (!index_.is_empty())
+    n_frame_ = index_.get_frame_count();
+  else
+    n_frame_ = (map_size_ - header_.get_header_size()) / header_.get_frame_size();
+  range_first_ = 0;
+  range_last_ = n_frame_;
+  range_stride_ = 1;
+  return 0;
+}
+
+void DcdMappedReader::set_random_access(bool random)
+{
+  if (map_addr_ != 0)
+    madvise(const_cast<char*>(map_addr_), map_size_, random ? MADV_RANDOM : MADV_SEQUENTIAL);
+}
+
+void DcdMappedReader::close()
+{
+  if (map_addr_ != 0)
+    munmap(const_cast<char*>(map_addr_), map_size_);
+  map_addr_ = 0;
+  map_size_ = 0;
+  n_frame_ = 0;
+  range_first_ = 0;
+  range_last_ = 0;
+  range_stride_ = 1;
+  header_.reset();
+  index_.reset();
+  subset_.reset();
+}
+
+std::int64_t DcdMappedReader::get_frame_offset(int n) const
+{
+  if (!index_.is_empty() && n < n_frame_)
+    return index_.get_frame_offset(n);
+  return header_.get_header_size() + std::int64_t(n) * header_.get_frame_size();
+}
+
+DcdFrameView DcdMappedReader::frame(int n) const
+{
+  const std::size_t Si = sizeof(int);
+  const int natom = header_.get_natom();
+  const std::int64_t block_size = natom * sizeof(float);
+
+  if (n < 0)
+    n += n_frame_;
+  if (map_addr_ == 0 || n < 0 || n >= n_frame_)
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cerr << " ERROR: Frame index out of range in dcd file: " << dcd_name_ << "\n";
+    return DcdFrameView();
+  }
+
+  // X, Y, Z blocks, each with leading and trailing record markers.
+  const char* p = map_addr_ + get_frame_offset(n) + header_.get_unit_cell_size();
+  const float* xyz[3];
+  for (int k = 0; k < 3; ++k) {
+    int flag = 0;
+    std::memcpy(&flag, p, Si);
+    if (flag / 4 != natom)
+    {
+      std::cout << " !!! Coordinates mismatch the atom number. !!! "
+                << "\n";
+      return DcdFrameView();
+    }
+    xyz[k] = reinterpret_cast<const float*>(p + Si);
+    p += 2 * Si + block_size;
+  }
+  return DcdFrameView(xyz[0], xyz[1], xyz[2], natom);
+}
+
+int DcdMappedReader::set_frame_range(int first, int last, int stride)
+{
+  if (first < 0)
+    first += n_frame_;
+  if (last <= 0)
+    last += n_frame_;
+  if (last > n_frame_)
+    last = n_frame_;
+  if (first < 0 || first > last || stride < 1)
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cerr << " ERROR: Wrong frame range: " << first << " to " << last
+              << " every " << stride << "\n";
+    return 1;
+  }
+  range_first_ = first;
+  range_last_ = last;
+  range_stride_ = stride;
+  return 0;
+}
+
+int DcdMappedReader::get_range_size() const
+{
+  if (range_last_ <= range_first_)
+    return 0;
+  return (range_last_ - range_first_ + range_stride_ - 1) / range_stride_;
+}
+
+int DcdMappedReader::set_atom_subset(const std::vector<Selection>& sels)
+{
+  if (subset_.set(sels, header_.get_natom()))
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cerr << " ERROR: Atom index out of range in dcd file: " << dcd_name_ << "\n";
+    return 1;
+  }
+  return 0;
+}
+
+int DcdMappedReader::read_frame(int n, Conformation& conf) const
+{
+  DcdFrameView v = frame(n);
+  if (!v.is_valid())
+    return 1;
+
+  const int natom = get_subset_size();
+  if (conf.n_atom_ != natom) {
+    conf.coordinates_.resize(natom);
+    conf.n_atom_ = natom;
+  }
+  const float* x = v.x();
+  const float* y = v.y();
+  const float* z = v.z();
+  if (subset_.is_empty()) {
+    for (int i = 0; i < natom; ++i)
+      conf.coordinates_[i].set_coordinate(x[i], y[i], z[i]);
+    return 0;
+  }
+  int i = 0;
+  for (const std::pair<int, int>& r : subset_.get_runs())
+    for (int j = r.first; j < r.first + r.second; ++j)
+      conf.coordinates_[i++].set_coordinate(x[j], y[j], z[j]);
+  return 0;
+}
+
+}  // pinang
@@ -0,0 +1,110 @@
+/*!
+  @file dcd_prefetcher.cpp
+  @brief Define functions of class DcdPrefetcher.
+
+  Definitions of member functions of class DcdPrefetcher.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 12:43
+  @copyright GNU Public License V3.0
+*/
+
+#include "dcd_prefetcher.hpp"
+
+namespace pinang {
+
+DcdPrefetcher::DcdPrefetcher(DcdReader& r, int k): reader_(&r), mapped_(0), next_range_(0)
+{
+  start(k);
+}
+
+DcdPrefetcher::DcdPrefetcher(const DcdMappedReader& r, int k): reader_(0), mapped_(&r), next_range_(0)
+{
+  start(k);
+}
+
+void DcdPrefetcher::start(int k)
+{
+  if (k < 1)
+    k = 1;
+  buffers_.resize(k);
+  frame_index_.resize(k, -1);
+  head_ = 0;
+  n_ready_ = 0;
+  last_frame_ = -1;
+  done_ = false;
+  stop_ = false;
+  worker_ = std::thread(&DcdPrefetcher::run, this);
+}
+
+int DcdPrefetcher::read_next(Conformation& conf, int& index)
+{
+  if (reader_) {
+    if (reader_->next_frame(conf))
+      return 1;
+    index = reader_->get_frame_index();
+    return 0;
+  }
+  if (next_range_ >= mapped_->get_range_size())
+    return 1;
+  index = mapped_->get_range_frame(next_range_++);
+  return mapped_->read_frame(index, conf);
+}
+
+void DcdPrefetcher::run()
+{
+  const int k = buffers_.size();
+  while (true) {
+    int slot;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_full_.wait(lock, [this, k] { return stop_ || n_ready_ < k; });
+      if (stop_)
+        return;
+      slot = (head_ + n_ready_) % k;
+    }
+
+    // The consumer never touches a slot which is not ready.
+    int index = -1;
+    int status = read_next(buffers_[slot], index);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (status) {
+      done_ = true;
+      not_empty_.notify_one();
+      return;
+    }
+    frame_index_[slot] = index;
+    ++n_ready_;
+    not_empty_.notify_one();
+  }
+}
+
+int DcdPrefetcher::next_frame(Conformation& conf)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_empty_.wait(lock, [this] { return n_ready_ > 0 || done_ || stop_; });
+  if (stop_ || n_ready_ == 0)
+    return 1;
+
+  conf.swap(buffers_[head_]);
+  last_frame_ = frame_index_[head_];
+  head_ = (head_ + 1) % buffers_.size();
+  --n_ready_;
+  not_full_.notify_one();
+  return 0;
+}
+
+void DcdPrefetcher::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  not_full_.notify_one();
+  not_empty_.notify_all();
+  if (worker_.joinable())
+    worker_.join();
+}
+
+}  // pinang
@@ -0,0 +1,516 @@
+/*!
+  @file dcd_reader.cpp
+  @brief Define functions of classes DcdHeader and DcdReader.
+
+  Definitions of member functions of classes DcdHeader and DcdReader.  Frames are
+  read with one stream read per frame and decoded from the raw buffer.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 12:36
+  @copyright GNU Public License V3.0
+*/
+
+#include <algorithm>
+#include <cstring>
+#include "dcd_reader.hpp"
+
+namespace pinang {
+
+// DcdHeader ===================================================================
+DcdHeader::DcdHeader()
+{
+  reset();
+}
+
+void DcdHeader::reset()
+{
+  nset_ = 0;
+  istart_ = 0;
+  nsavc_ = 0;
+  nstep_ = 0;
+  nunit_ = 0;
+  nfreat_ = 0;
+  delta_ = 0;
+  unit_cell_flag_ = 0;
+  nver_ = 0;
+  ntitle_ = 0;
+  natom_ = 0;
+  header_size_ = 0;
+  frame_size_ = 0;
+}
+
+int DcdHeader::read(std::istream& dcd_file)
+{
+  const std::size_t Si = sizeof(int);
+  int flag = 0;
+  char block_1[84];
+
+  reset();
+  dcd_file.seekg(0, dcd_file.beg);
+
+  // ---------------------------------------------------------------------
+  // Block 1: control information.  First thing in the file should be an 84.
+  dcd_file.read((char*)&flag, Si);
+  if (!dcd_file || flag != 84)
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cout << " !!! Magic number of block 1 error. !!!" << "\n";
+    return 1;
+  }
+  dcd_file.read(block_1, 84);
+  std::memcpy(&nset_, block_1 + 4, Si);     // NSET
+  std::memcpy(&istart_, block_1 + 8, Si);   // ISTART
+  std::memcpy(&nsavc_, block_1 + 12, Si);   // NSAVC
+  std::memcpy(&nstep_, block_1 + 16, Si);   // NSTEP
+  std::memcpy(&nunit_, block_1 + 20, Si);   // NUNIT
+  std::memcpy(&nfreat_, block_1 + 36, Si);  // NFREAT
+  std::memcpy(&delta_, block_1 + 40, sizeof(float));  // DELTA
+  std::memcpy(&unit_cell_flag_, block_1 + 44, Si);    // unit-cell info
+  std::memcpy(&nver_, block_1 + 80, Si);    // NVER
+  dcd_file.read((char*)&flag, Si);
+
+  // ---------------------------------------------------------------------
+  // Block 2: title lines.
+  int block_2_size = 0;
+  dcd_file.read((char*)&block_2_size, Si);
+  dcd_file.read((char*)&ntitle_, Si);
+  dcd_file.seekg(block_2_size - Si, dcd_file.cur);
+  dcd_file.read((char*)&flag, Si);
+  if (!dcd_file || flag != block_2_size)
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cout << " !!! Magic number of block 2 error. !!!" << "\n";
+    return 1;
+  }
+
+  // ---------------------------------------------------------------------
+  // Block 3: number of atoms; block size should be 4 !!!
+  dcd_file.read((char*)&flag, Si);
+  if (!dcd_file || flag != 4)
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cout << " !!! Magic number of block 3 error. !!!" << "\n";
+    return 1;
+  }
+  dcd_file.read((char*)&natom_, Si);
+  dcd_file.read((char*)&flag, Si);
+  if (!dcd_file || flag != 4)
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cout << " !!! Magic number of block 3 error. !!!" << "\n";
+    return 1;
+  }
+
+  header_size_ = dcd_file.tellg();
+  frame_size_ = get_unit_cell_size() + 3 * (2 * Si + std::int64_t(natom_) * sizeof(float));
+  return 0;
+}
+
+// DcdAtomSubset ===============================================================
+void DcdAtomSubset::reset()
+{
+  atoms_.clear();
+  runs_.clear();
+}
+
+int DcdAtomSubset::set(const std::vector<Selection>& sels, int natom)
+{
+  reset();
+  for (const Selection& sel : sels)
+    for (int i = 0; i < sel.get_size(); ++i)
+      atoms_.push_back(sel.get_selection(i));
+  std::sort(atoms_.begin(), atoms_.end());
+  atoms_.erase(std::unique(atoms_.begin(), atoms_.end()), atoms_.end());
+  if (atoms_.empty())
+    return 0;
+  if (atoms_.front() < 0 || atoms_.back() >= natom)
+  {
+    reset();
+    return 1;
+  }
+
+  for (std::size_t i = 0; i < atoms_.size(); ++i) {
+    if (i > 0 && atoms_[i] == atoms_[i - 1] + 1)
+      ++runs_.back().second;
+    else
+      runs_.push_back(std::make_pair(atoms_[i], 1));
+  }
+  return 0;
+}
+
+Selection DcdAtomSubset::map_selection(const Selection& sel) const
+{
+  if (atoms_.empty())
+    return sel;
+
+  std::vector<int> v;
+  for (int i = 0; i < sel.get_size(); ++i) {
+    int m = sel.get_selection(i);
+    std::vector<int>::const_iterator it = std::lower_bound(atoms_.begin(), atoms_.end(), m);
+    if (it == atoms_.end() || *it != m)
+    {
+      std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+      std::cerr << " ERROR: Atom " << m + 1 << " not in the decoded atom subset. " << "\n";
+      return Selection();
+    }
+    v.push_back(it - atoms_.begin());
+  }
+  return Selection(v);
+}
+
+// DcdReader ===================================================================
+DcdReader::DcdReader()
+{
+  n_frame_ = 0;
+  i_frame_ = 0;
+  last_frame_ = -1;
+  range_first_ = 0;
+  range_last_ = 0;
+  range_stride_ = 1;
+  subset_block_size_ = 0;
+}
+
+DcdReader::DcdReader(const std::string& s, bool use_index)
+{
+  n_frame_ = 0;
+  i_frame_ = 0;
+  last_frame_ = -1;
+  range_first_ = 0;
+  range_last_ = 0;
+  range_stride_ = 1;
+  subset_block_size_ = 0;
+  open(s, use_index);
+}
+
+int DcdReader::open(const std::string& s, bool use_index)
+{
+  close();
+  dcd_name_ = s;
+  dcd_file_.open(dcd_name_.c_str(), std::ifstream::binary);
+  if (!dcd_file_.is_open())
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cerr << " ERROR: Cannot read dcd file: " << s << "\n";
+    return 1;
+  }
+
+  dcd_file_.seekg(0, dcd_file_.end);
+  std::int64_t filesize = dcd_file_.tellg();
+  if (filesize == 0)
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cout << " !!! Error: empty dcd file! !!!" << "\n";
+    close();
+    return 1;
+  }
+
+  if (header_.read(dcd_file_))
+  {
+    close();
+    return 1;
+  }
+
+  if (use_index)
+  {
+    if (index_.load(dcd_name_, dcd_file_, header_))
+    {
+      close();
+      return 1;
+    }
+    n_frame_ = index_.get_frame_count();
+  } else if (index_.read(dcd_name_, header_) == 0) {
+    // an up-to-date sidecar is used anyway;
+    n_frame_ = index_.get_frame_count();
+  } else {
+    n_frame_ = (filesize - header_.get_header_size()) / header_.get_frame_size();
+  }
+  range_first_ = 0;
+  range_last_ = n_frame_;
+  range_stride_ = 1;
+  i_frame_ = 0;
+  last_frame_ = -1;
+  frame_buffer_.resize(header_.get_frame_size());
+  dcd_file_.seekg(get_frame_offset(0), dcd_file_.beg);
+  return 0;
+}
+
+void DcdReader::close()
+{
+  if (dcd_file_.is_open())
+    dcd_file_.close();
+  dcd_file_.clear();
+  header_.reset();
+  index_.reset();
+  n_frame_ = 0;
+  i_frame_ = 0;
+  last_frame_ = -1;
+  range_first_ = 0;
+  range_last_ = 0;
+  range_stride_ = 1;
+  clear_atom_subset();
+}
+
+int DcdReader::rewind()
+{
+  if (!dcd_file_.is_open())
+    return 1;
+  return seek_frame(range_first_);
+}
+
+int DcdReader::seek_frame(int n)
+{
+  if (!dcd_file_.is_open())
+    return 1;
+  if (n < 0)
+    n += n_frame_;
+  if (n < 0 || n > n_frame_)
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cerr << " ERROR: Frame index out of range in dcd file: " << dcd_name_ << "\n";
+    return 1;
+  }
+  dcd_file_.clear();
+  dcd_file_.seekg(get_frame_offset(n), dcd_file_.beg);
+  i_frame_ = n;
+  return 0;
+}
+
+int DcdReader::set_frame_range(int first, int last, int stride)
+{
+  if (first < 0)
+    first += n_frame_;
+  if (last <= 0)
+    last += n_frame_;
+  if (last > n_frame_)
+    last = n_frame_;
+  if (first < 0 || first > last || stride < 1)
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cerr << " ERROR: Wrong frame range: " << first << " to " << last
+              << " every " << stride << "\n";
+    return 1;
+  }
+  range_first_ = first;
+  range_last_ = last;
+  range_stride_ = stride;
+  return seek_frame(range_first_);
+}
+
+int DcdReader::set_atom_subset(const std::vector<Selection>& sels)
+{
+  // Selected atoms which are closer than this are read in one go.
+  const int max_gap = 1024;
+
+  clear_atom_subset();
+  if (subset_.set(sels, header_.get_natom()))
+  {
+    std::cout << " ~               PINANG :: DCD                ~ " << "\n";
+    std::cerr << " ERROR: Atom index out of range in dcd file: " << dcd_name_ << "\n";
+    clear_atom_subset();
+    return 1;
+  }
+  if (subset_.is_empty())
+    return 0;
+
+  const std::vector<std::pair<int, int> >& runs = subset_.get_runs();
+  for (const std::pair<int, int>& r : runs) {
+    if (!subset_reads_.empty()
+        && r.first - (subset_reads_.back().first + subset_reads_.back().second) < max_gap)
+      subset_reads_.back().second = r.first + r.second - subset_reads_.back().first;
+    else
+      subset_reads_.push_back(r);
+  }
+
+  // Position of each run in the buffered block.
+  std::size_t j = 0;
+  int pos = 0;
+  for (const std::pair<int, int>& r : runs) {
+    while (r.first >= subset_reads_[j].first + subset_reads_[j].second) {
+      pos += subset_reads_[j].second;
+      ++j;
+    }
+    subset_run_pos_.push_back(pos + r.first - subset_reads_[j].first);
+  }
+  subset_block_size_ = 0;
+  for (const std::pair<int, int>& r : subset_reads_)
+    subset_block_size_ += r.second;
+  frame_buffer_.resize(3 * subset_block_size_ * sizeof(float));
+  return 0;
+}
+
+void DcdReader::clear_atom_subset()
+{
+  subset_.reset();
+  subset_run_pos_.clear();
+  subset_reads_.clear();
+  subset_block_size_ = 0;
+  frame_buffer_.resize(header_.get_frame_size());
+  // The stream position is unknown after reading a subset.
+  if (dcd_file_.is_open())
+  {
+    dcd_file_.clear();
+    dcd_file_.seekg(get_frame_offset(i_frame_), dcd_file_.beg);
+  }
+}
+
+int DcdReader::get_subset_size() const
+{
+  if (subset_.is_empty())
+    return header_.get_natom();
+  return subset_.get_size();
+}
+
+Selection DcdReader::get_subset_selection(const Selection& sel) const
+{
+  return subset_.map_selection(sel);
+}
+
+std::int64_t DcdReader::get_frame_offset(int n) const
+{
+  if (!index_.is_empty() && n < n_frame_)
+    return index_.get_frame_offset(n);
+  return header_.get_header_size() + std::int64_t(n) * header_.get_frame_size();
+}
+
+int DcdReader::get_range_size() const
+{
+  if (range_last_ <= range_first_)
+    return 0;
+  return (range_last_ - range_first_ + range_stride_ - 1) / range_stride_;
+}
+
+int DcdReader::next_frame(Conformation& conf)
+{
+  if (!dcd_file_.is_open() || i_frame_ >= range_last_)
+    return 1;
+
+  if (!subset_.is_empty()) {
+    if (read_subset_frame())
+      return 1;
+    last_frame_ = i_frame_;
+    i_frame_ += range_stride_;
+    return decode_subset_frame(conf);
+  }
+
+  if (last_frame_ + 1 != i_frame_)
+    dcd_file_.seekg(get_frame_offset(i_frame_), dcd_file_.beg);
+  dcd_file_.read(&frame_buffer_[0], header_.get_frame_size());
+  if (!dcd_file_)
+    return 1;
+  last_frame_ = i_frame_;
+  i_frame_ += range_stride_;
+
+  return decode_frame(conf);
+}
+
+int DcdReader::decode_frame(Conformation& conf)
+{
+  const std::size_t Si = sizeof(int);
+  const int natom = header_.get_natom();
+  const std::int64_t block_size = natom * sizeof(float);
+  const char* p = &frame_buffer_[0] + header_.get_unit_cell_size();
+
+  // X, Y, Z blocks, each with leading and trailing record markers.
+  const float* xyz[3];
+  for (int k = 0; k < 3; ++k) {
+    int flag = 0;
+    std::memcpy(&flag, p, Si);
+    if (flag / 4 != natom)
+    {
+      std::cout << " !!! Coordinates mismatch the atom number. !!! "
+                << "\n";
+      return 1;
+    }
+    xyz[k] = reinterpret_cast<const float*>(p + Si);
+    p += 2 * Si + block_size;
+  }
+
+  if (conf.n_atom_ != natom) {
+    conf.coordinates_.resize(natom);
+    conf.n_atom_ = natom;
+  }
+  float x, y, z;
+  for (int i = 0; i < natom; ++i) {
+    std::memcpy(&x, xyz[0] + i, sizeof(float));
+    std::memcpy(&y, xyz[1] + i, sizeof(float));
+    std::memcpy(&z, xyz[2] + i, sizeof(float));
+    conf.coordinates_[i].set_coordinate(x, y, z);
+  }
+  return 0;
+}
+
+int DcdReader::read_subset_frame()
+{
+  const std::size_t Si = sizeof(int);
+  const int natom = header_.get_natom();
+  const std::int64_t block_size = 2 * Si + std::int64_t(natom) * sizeof(float);
+  std::int64_t block_start = get_frame_offset(i_frame_) + header_.get_unit_cell_size();
+  char* p = &frame_buffer_[0];
+
+  for (int k = 0; k < 3; ++k) {
+    int flag = 0;
+    dcd_file_.seekg(block_start, dcd_file_.beg);
+    dcd_file_.read((char*)&flag, Si);
+    if (!dcd_file_)
+      return 1;
+    if (flag / 4 != natom)
+    {
+      std::cout << " !!! Coordinates mismatch the atom number. !!! "
+                << "\n";
+      return 1;
+    }
+    for (const std::pair<int, int>& r : subset_reads_) {
+      dcd_file_.seekg(block_start + Si + std::int64_t(r.first) * sizeof(float), dcd_file_.beg);
+      dcd_file_.read(p, r.second * sizeof(float));
+      p += r.second * sizeof(float);
+    }
+    if (!dcd_file_)
+      return 1;
+    block_start += block_size;
+  }
+  return 0;
+}
+
+int DcdReader::decode_subset_frame(Conformation& conf)
+{
+  const int n = subset_.get_size();
+  const std::vector<std::pair<int, int> >& runs = subset_.get_runs();
+  const float* x = reinterpret_cast<const float*>(&frame_buffer_[0]);
+  const float* y = x + subset_block_size_;
+  const float* z = y + subset_block_size_;
+
+  if (conf.n_atom_ != n) {
+    conf.coordinates_.resize(n);
+    conf.n_atom_ = n;
+  }
+  int i = 0;
+  for (std::size_t r = 0; r < runs.size(); ++r) {
+    const int pos = subset_run_pos_[r];
+    for (int j = pos; j < pos + runs[r].second; ++j)
+      conf.coordinates_[i++].set_coordinate(x[j], y[j], z[j]);
+  }
+  return 0;
+}
+
+DcdReader::iterator DcdReader::begin()
+{
+  if (rewind() || next_frame(frame_))
+    return end();
+  return iterator(this, 0);
+}
+
+DcdReader::iterator DcdReader::end()
+{
+  return iterator(this, -1);
+}
+
+DcdReader::iterator& DcdReader::iterator::operator++()
+{
+  if (reader_->next_frame(reader_->frame_))
+    i_frame_ = -1;
+  else
+    ++i_frame_;
+  return *this;
+}
+
+}  // pinang
@@ -0,0 +1,111 @@
+/*!
+  @file frame_analysis.cpp
+  @brief Define per-frame analysis functions.
+
+  Definitions of the per-frame bodies of the rmsd, angle, distance and
+  interface analyses.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 15:28
+  @copyright GNU Public License V3.0
+*/
+
+#include <cmath>
+#include <iomanip>
+#include "frame_analysis.hpp"
+
+namespace pinang {
+
+double get_superimposed_rmsd(const Superposer& superposer, const CoordinateView<double>& rmsd_ref,
+                             Conformation& conf, const Selection& sel_tran, const Selection& sel_rmsd,
+                             RmsdScratch& s)
+{
+  double rmsd;
+  s.tran.assign(conf.get_view(), sel_tran);
+  s.rmsd.assign(conf.get_view(), sel_rmsd);
+  superposer.superimpose(s.tran.get_view(), s.t, rmsd);
+  apply_transform(s.rmsd, s.t);
+  return get_rmsd(rmsd_ref, s.rmsd.get_view());
+}
+
+double get_com_vector_angle(Conformation& conf, const Selection* sel,
+                            const std::vector<double>* masses)
+{
+  Vec3d com[4];
+  for (int k = 0; k < 4; ++k) {
+    Group grp(conf, sel[k]);
+    com[k] = get_center_of_mass(grp, masses[k]);
+  }
+  Vec3d vecA = com[1] - com[0];
+  Vec3d vecB = com[3] - com[2];
+  return vec_angle_deg(vecA, vecB);
+}
+
+double get_min_com_distance(Conformation& conf, const Selection& sel_lig,
+                            const std::vector<double>& masses_lig, const Selection& sel_rec)
+{
+  Group grp_lig(conf, sel_lig);
+  Vec3d com_lig = get_center_of_mass(grp_lig, masses_lig);
+
+  double dist = -1.0;
+  double d_tmp = 0.0;
+  for (int j = 0; j < sel_rec.get_size(); ++j) {
+    d_tmp = vec_distance(com_lig, conf.get_coordinate(sel_rec.get_selection(j)));
+    if (dist < 0 || dist > d_tmp) dist = d_tmp;
+  }
+  return dist;
+}
+
+double get_interface_com_cutoff(Conformation& conf, const Selection& sel_lig,
+                                const Selection& sel_rec)
+{
+  Group grp_lig(conf, sel_lig);
+  Group grp_rec(conf, sel_rec);
+  return 2 * (get_radius_of_gyration(grp_lig) + get_radius_of_gyration(grp_rec));
+}
+
+int write_interface(std::ostream& out, int i, Conformation& conf,
+                    const Selection& sel_lig_dcd, const Selection& sel_rec_dcd,
+                    const Selection& sel_lig, const Selection& sel_rec,
+                    double contact_cutoff, double com_cutoff, VerletList& pair_list)
+{
+  Group grp_lig(conf, sel_lig_dcd);
+  Group grp_rec(conf, sel_rec_dcd);
+  if (vec_distance(grp_rec.get_centroid(), grp_lig.get_centroid()) > com_cutoff)
+    return 0;
+
+  // receptor-ligand pairs from the Verlet list, which is only rebuilt when
+  // particles have moved more than half of the skin;
+  std::vector<int> lig_resid_flag(sel_lig.get_size(), 0);
+  std::vector<int> rec_resid_flag(sel_rec.get_size(), 0);
+  std::vector<Vec3d> coors_rec(sel_rec.get_size());
+  std::vector<Vec3d> coors_lig(sel_lig.get_size());
+  for (int j = 0; j < sel_rec.get_size(); ++j)
+    coors_rec[j] = conf.get_coordinate(sel_rec_dcd.get_selection(j));
+  for (int k = 0; k < sel_lig.get_size(); ++k)
+    coors_lig[k] = conf.get_coordinate(sel_lig_dcd.get_selection(k));
+  if (pair_list.update(coors_rec, coors_lig))
+    return 1;
+  pair_list.for_each_pair(coors_rec, coors_lig, [&](int j, int k, double d2) {
+      if (std::sqrt(d2) < contact_cutoff) {
+        rec_resid_flag[j] = 1;
+        lig_resid_flag[k] = 1;
+      }
+    });
+
+  out << "STEP > " << std::setw(8) << i << " \n";
+  out << " | LIG > ";
+  for (int k = 0; k < sel_lig.get_size(); ++k) {
+    if (lig_resid_flag[k] > 0)
+      out << " " << std::setw(5) << sel_lig.get_selection(k) + 1;
+  }
+  out << "\n | REC > ";
+  for (int j = 0; j < sel_rec.get_size(); ++j) {
+    if (rec_resid_flag[j] > 0)
+      out << " " << std::setw(5) << sel_rec.get_selection(j) + 1;
+  }
+  out << "\nTER >" << "\n";
+  return 0;
+}
+
+}  // pinang
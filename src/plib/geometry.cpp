@@ -87,6 +87,13 @@ void Transform::set_rotation(const Quaternion& q)
   rotv3_ = Vec3d(zx - yw, yz + xw, 1 - x2 - y2);
 }
 
+void Transform::get_rotation_matrix(double* r) const
+{
+  r[0] = rotv1_.x(); r[1] = rotv1_.y(); r[2] = rotv1_.z();
+  r[3] = rotv2_.x(); r[4] = rotv2_.y(); r[5] = rotv2_.z();
+  r[6] = rotv3_.x(); r[7] = rotv3_.y(); r[8] = rotv3_.z();
+}
+
 Vec3d Transform::apply(const Vec3d& v)
 {
   Vec3d v_out;
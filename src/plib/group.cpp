@@ -34,11 +34,17 @@ Group::Group(const Conformation& c, const Selection& s)
     exit(EXIT_SUCCESS);
   }
 
-  Conformation c1 = c;
+  CoordinateView<double> v = c.get_view();
   int n = s.get_size();
+  coordinates_.reserve(n);
   for (int i = 0; i < n; ++i) {
     int m = s.get_selection(i);
-    coordinates_.push_back(c1.get_coordinate(m));
+    if (m < 0 || m >= c.get_size()) {
+      std::cout << " ~             PINANG :: conformation.hpp       ~ " << "\n";
+      std::cerr << " ERROR: Atom index out of range in Conformation. " << "\n";
+      exit(EXIT_SUCCESS);
+    }
+    coordinates_.push_back(v.get_coordinate(m));
   }
   n_atom_ = n;
 }
@@ -60,12 +66,7 @@ int Group::set_conformation(std::vector<Vec3d> v)
 
 Vec3d Group::get_centroid() const
 {
-  Vec3d com;
-  for (int i = 0; i < n_atom_; ++i) {
-    com += coordinates_[i];
-  }
-  com /= n_atom_;
-  return com;
+  return pinang::get_centroid(get_view());
 }
 
 }
@@ -19,7 +19,6 @@ namespace pinang {
 Vec3d get_center_of_mass(const Group& grp, std::vector<double> masses)
 {
   Vec3d com;
-  double M = 0;  // sum of masses;
 
   int m1 = grp.n_atom_;
   int m2 = masses.size();
@@ -35,31 +34,14 @@ Vec3d get_center_of_mass(const Group& grp, std::vector<double> masses)
     exit(EXIT_SUCCESS);
   }
 
-  for (int i = 0; i < m1; ++i) {
-    com += masses[i] * grp.coordinates_[i];
-    M += masses[i];
-  }
-  com /= M;
+  com = get_center_of_mass(grp.get_view(), masses);
 
   return com;
 }
 
 double get_radius_of_gyration(const Group& grp)
 {
-  double rg = 0;
-  Vec3d ctr = grp.get_centroid();
-  int m = grp.n_atom_;
-
-  Vec3d vtmp;
-  double dtmp = 0;
-
-  for (int i = 0; i < m; ++i) {
-    vtmp = grp.coordinates_[i] - ctr;
-    dtmp += vtmp.squared_norm();
-  }
-  rg = sqrt(dtmp / m);
-
-  return rg;
+  return get_radius_of_gyration(grp.get_view());
 }
 
 
@@ -9,105 +9,181 @@
   @copyright GNU Public License V3.0
 */
 
-// Based on https://github.com/oleg-alexandrov/projects/blob/master/eigen/Kabsch.cpp;
+// Superimposition with the QCP method:
+// D. L. Theobald, Acta Cryst. A61, 478-480 (2005);
+// P. Liu, D. K. Agrafiotis, D. L. Theobald, J. Comput. Chem. 31, 1561-1563 (2010).
 
 #include <cmath>
-#include <Eigen/Geometry>
+#include <Eigen/Eigenvalues>
 #include "geometry.hpp"
 
 namespace pinang {
 
-int find_transform(const Group& grp1, const Group& grp2, Transform& t)
+namespace {
+
+double det3(double a, double b, double c,
+            double d, double e, double f,
+            double g, double h, double i)
 {
-  // Simple check...
-  int m1 = grp1.get_size();
-  int m2 = grp2.get_size();
-  if (m1 != m2) {
-    std::cout << " ERROR: inconsistent number of atoms when calculating Rg! (group_rmsd.cpp)\n";
-    exit(EXIT_SUCCESS);
-  }
+  return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+}
+
+// Cofactor C(r, c) of a 4x4 matrix.
+double cofactor4(const double k[4][4], int r, int c)
+{
+  int rs[3], cs[3];
+  for (int i = 0, j = 0; i < 4; ++i)
+    if (i != r) rs[j++] = i;
+  for (int i = 0, j = 0; i < 4; ++i)
+    if (i != c) cs[j++] = i;
+  double d = det3(k[rs[0]][cs[0]], k[rs[0]][cs[1]], k[rs[0]][cs[2]],
+                  k[rs[1]][cs[0]], k[rs[1]][cs[1]], k[rs[1]][cs[2]],
+                  k[rs[2]][cs[0]], k[rs[2]][cs[1]], k[rs[2]][cs[2]]);
+  return ((r + c) % 2) ? -d : d;
+}
 
-  // Make copies of input groups...
-  Group g1 = grp1;
-  Group g2 = grp2;
-
-  // First find the scale, by finding the ratio of sums of some distances,
-  // then bring the datasets to the same scale.
-  double dist_in = 0, dist_out = 0;
-  Vec3d vtmp;
-  for (int i = 0; i < m1-1; ++i) {
-    vtmp = g1.get_coordinate(i + 1) - g1.get_coordinate(i);
-    dist_in += vtmp.norm();
-    vtmp = g2.get_coordinate(i + 1) - g2.get_coordinate(i);
-    dist_out += vtmp.norm();
+// Key matrix K, whose largest eigenvalue gives the best superimposition.
+void set_key_matrix(const double* s, double k[4][4])
+{
+  const double sxx = s[0], sxy = s[1], sxz = s[2];
+  const double syx = s[3], syy = s[4], syz = s[5];
+  const double szx = s[6], szy = s[7], szz = s[8];
+  const double kk[4][4] = {
+    {sxx + syy + szz, syz - szy,        szx - sxz,        sxy - syx},
+    {syz - szy,       sxx - syy - szz,  sxy + syx,        szx + sxz},
+    {szx - sxz,       sxy + syx,       -sxx + syy - szz,  syz + szy},
+    {sxy - syx,       szx + sxz,        syz + szy,       -sxx - syy + szz}};
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 4; ++j)
+      k[i][j] = kk[i][j];
+}
+
+// Largest eigenvalue of K by Newton-Raphson from the upper bound e0 = (G_a + G_b) / 2.
+double get_max_eigenvalue(const double* s, const double k[4][4], double e0)
+{
+  // Characteristic polynomial: x^4 + c2 x^2 + c1 x + c0.
+  double c2 = 0;
+  for (int i = 0; i < 9; ++i)
+    c2 += s[i] * s[i];
+  c2 *= -2.0;
+  double c1 = -8.0 * det3(s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7], s[8]);
+  double c0 = 0;
+  for (int j = 0; j < 4; ++j)
+    c0 += k[0][j] * cofactor4(k, 0, j);
+
+  double lambda = e0;
+  for (int i = 0; i < 50; ++i) {
+    double x2 = lambda * lambda;
+    double b = (x2 + c2) * lambda;
+    double a = b + c1;
+    double delta = (a * lambda + c0) / (2.0 * x2 * lambda + b + a);
+    lambda -= delta;
+    if (std::fabs(delta) < std::fabs(1e-14 * lambda))
+      break;
   }
-  if (dist_in <= 0 || dist_out <= 0)
+  return lambda;
+}
+
+}  // anonymous namespace
+
+double get_qcp_rmsd(const double* s, double g_a, double g_b, int n)
+{
+  if (n <= 0)
+    return 0.0;
+  double k[4][4];
+  set_key_matrix(s, k);
+  double e0 = (g_a + g_b) / 2.0;
+  double d = 2.0 * (e0 - get_max_eigenvalue(s, k, e0)) / n;
+  return d > 0 ? sqrt(d) : 0.0;
+}
+
+int get_qcp_transform(const double* s, double g_obj, double g_ref, int n,
+                      const Vec3d& ctr_obj, const Vec3d& ctr_ref, Transform& t, double& rmsd)
+{
+  if (n == 0 || g_obj <= 0 || g_ref <= 0)
     return 1;  // 1 means failure of superimposition;
-  double scale = dist_out/dist_in;
-  for (int i = 0; i < m1; ++i) {
-    g2.get_coordinate(i) /= scale;
+
+  double k[4][4];
+  set_key_matrix(s, k);
+  double e0 = (g_obj + g_ref) / 2.0;
+  double lambda = get_max_eigenvalue(s, k, e0);
+
+  // Eigenvector: the longest column of adj(K - lambda I).
+  for (int i = 0; i < 4; ++i)
+    k[i][i] -= lambda;
+  double q[4] = {0}, q_norm = 0;
+  for (int c = 0; c < 4; ++c) {
+    double v[4], v_norm = 0;
+    for (int r = 0; r < 4; ++r) {
+      v[r] = cofactor4(k, c, r);
+      v_norm += v[r] * v[r];
+    }
+    if (v_norm > q_norm) {
+      q_norm = v_norm;
+      for (int r = 0; r < 4; ++r)
+        q[r] = v[r];
+    }
   }
-  Vec3d pctr1 = g1.get_centroid();
-  Vec3d pctr2 = g2.get_centroid();
-  Eigen::Vector3d in_ctr(pctr1[0], pctr1[1], pctr1[2]);
-  Eigen::Vector3d out_ctr(pctr2[0], pctr2[1], pctr2[2]);
-
-  // Find the centroids then shift to the origin
-  for (int i = 0; i < m1; ++i) {
-    g1.get_coordinate(i) -= pctr1;
-    g2.get_coordinate(i) -= pctr2;
+  double e0_3 = e0 * e0 * e0;
+  if (q_norm < 1e-8 * e0_3 * e0_3) {
+    // (Nearly) degenerate largest eigenvalue, e.g. symmetric or linear
+    // structures, where neither lambda nor the adjugate is accurate.
+    Eigen::Matrix4d km;
+    for (int i = 0; i < 4; ++i)
+      for (int j = 0; j < 4; ++j)
+        km(i, j) = k[i][j] + (i == j ? lambda : 0.0);
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix4d> es(km);
+    for (int r = 0; r < 4; ++r)
+      q[r] = es.eigenvectors()(r, 3);
+    lambda = es.eigenvalues()(3);
   }
+  double d = 2.0 * (e0 - lambda) / n;
+  rmsd = d > 0 ? sqrt(d) : 0.0;
+
+  // ==================== SAVE to TRANSFORM VECTOR ====================
+  t.set_rotation(Quaternion(q[0], q[1], q[2], q[3]));
+  Transform r(t.rotation(), Vec3d(0.0, 0.0, 0.0));
+  t.set_translation(ctr_ref - r.apply(ctr_obj));
 
-  // pinang::Group ---> Eigen::Matrix
-  int col = 0;
-  int row = 0;
-  Eigen::Matrix3Xd in(3, m1);
-  Eigen::Matrix3Xd out(3, m1);
-  for (col = 0; col < m1; ++col) {
-    Vec3d coor_tmp1 = g1.get_coordinate(col);
-    Vec3d coor_tmp2 = g2.get_coordinate(col);
-    in(0, col) = coor_tmp1[0];
-    in(1, col) = coor_tmp1[1];
-    in(2, col) = coor_tmp1[2];
-    out(0, col) = coor_tmp2[0];
-    out(1, col) = coor_tmp2[1];
-    out(2, col) = coor_tmp2[2];
+  return 0;
+}
+
+template <typename T>
+int find_transform(const CoordinateView<T>& obj, const CoordinateView<T>& ref,
+                   Transform& t, double& rmsd)
+{
+  int n = obj.get_size();
+  if (n != ref.get_size()) {
+    std::cout << " ~             PINANG :: group_rmsd.cpp     ~ " << "\n";
+    std::cerr << " ERROR: inconsistent number of atoms in superimposition! " << "\n";
+    exit(EXIT_SUCCESS);
   }
 
-  // ==================== KEY!!! ====================
-  // SVD
-  Eigen::MatrixXd Cov = in * out.transpose();
-  Eigen::JacobiSVD<Eigen::MatrixXd> svd(Cov, Eigen::ComputeThinU | Eigen::ComputeThinV);
-
-  // Find the rotation
-  double d = (svd.matrixV() * svd.matrixU().transpose()).determinant();
-  if (d > 0)
-    d = 1.0;
-  else
-    d = -1.0;
-  Eigen::Matrix3d I = Eigen::Matrix3d::Identity(3, 3);
-  I(2, 2) = d;
-  Eigen::Matrix3d R = svd.matrixV() * I * svd.matrixU().transpose();
-
-  // prepare for the transformation vector
-  Eigen::Quaterniond eigen_q(R);  // rotation part!
-  Eigen::Vector3d eigen_t;
-  eigen_t = out_ctr * scale - R * in_ctr;  // translation part!
+  double s[9], g[2];
+  Vec3d ctr_obj, ctr_ref;
+  get_inner_product(obj, ref, s, g, ctr_obj, ctr_ref);
+  return get_qcp_transform(s, g[0], g[1], n, ctr_obj, ctr_ref, t, rmsd);
+}
 
-  // ==================== SAVE to TRANSFORM VECTOR ====================
-  Quaternion transform_linear_q(eigen_q.w(), eigen_q.x(), eigen_q.y(), eigen_q.z());
-  Vec3d transform_translation(eigen_t(0), eigen_t(1), eigen_t(2));
-  t.set_rotation(transform_linear_q);
-  t.set_translation(transform_translation);
+int find_transform(const Group& grp1, const Group& grp2, Transform& t, double& rmsd)
+{
+  return find_transform(grp1.get_view(), grp2.get_view(), t, rmsd);
+}
 
-  return 1;
+int find_transform(const Group& grp1, const Group& grp2, Transform& t)
+{
+  double rmsd = 0;
+  return find_transform(grp1.get_view(), grp2.get_view(), t, rmsd);
 }
 
+template int find_transform(const CoordinateView<float>&, const CoordinateView<float>&,
+                            Transform&, double&);
+template int find_transform(const CoordinateView<double>&, const CoordinateView<double>&,
+                            Transform&, double&);
+
 double get_rmsd(const Group& grp1, const Group& grp2)
 {
   double rmsd = 0;
-  double d = 0;
-  Vec3d vtmp;
 
   // Simple check...
   int m1 = grp1.n_atom_;
@@ -117,13 +193,7 @@ double get_rmsd(const Group& grp1, const Group& grp2)
     exit(EXIT_SUCCESS);
   }
 
-  // rmsd calculation loop
-  for (int i = 0; i < m1; ++i) {
-    vtmp = grp1.coordinates_[i] - grp2.coordinates_[i];
-    d += vtmp.squared_norm();
-  }
-
-  rmsd = sqrt(d / m1);
+  rmsd = get_rmsd(grp1.get_view(), grp2.get_view());
   return rmsd;
 }
 
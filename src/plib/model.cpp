@@ -15,6 +15,11 @@
 namespace pinang {
 
 Chain& Model::get_chain(unsigned int n)
+{
+  return const_cast<Chain&>(static_cast<const Model&>(*this).get_chain(n));
+}
+
+const Chain& Model::get_chain(unsigned int n) const
 {
   if (v_chains_.empty())
   {
@@ -40,6 +45,13 @@ void Model::add_chain(Chain& c)
   ++n_chain_;
 }
 
+void Model::add_chain(Chain&& c)
+{
+  c.self_check();
+  v_chains_.push_back(std::move(c));
+  ++n_chain_;
+}
+
 
 void Model::output_sequence(int n) const
 {
@@ -297,22 +309,17 @@ void Model::output_ffparm_dihedral(std::ostream& o)
   o << "\n" << std::endl;
 }
 
-void Model::output_ffparm_nonbonded(std::ostream& o)
+int Model::get_cg_groups(std::vector<Atom>& cg_pro_group, std::vector<Residue>& residue_pro_group,
+                         std::vector<Atom>& cg_dna_group, std::vector<Residue>& residue_dna_group)
 {
-  int i, j, k;
-  Atom atmp1, atmp2, atmp3, atmp4;
-  Residue rtmp1, rtmp2;
-  ChainType ct_tmp;
-  int pg_size, dg_size;
-  double cg_dist = 0;
-  double aa_dist_min = 0;
-  std::string groove_info;
-
-  std::vector<Atom> tmp_cg_pro_group;
-  std::vector<Atom> tmp_cg_dna_group;
-  std::vector<Residue> tmp_residue_pro_group;
-  std::vector<Residue> tmp_residue_dna_group;
+  cg_pro_group.clear();
+  residue_pro_group.clear();
+  cg_dna_group.clear();
+  residue_dna_group.clear();
 
+  int i, j;
+  Atom atmp1;
+  ChainType ct_tmp;
   int tmp_resid_serial = 0;
   int tmp_chain_serial = -1;
   for (i = 0; i < n_chain_; ++i) {
@@ -323,41 +330,41 @@ void Model::output_ffparm_nonbonded(std::ostream& o)
     int m_chain_size = v_chains_[i].get_size();
     if (ct_tmp == protein) {
       for (j = 0; j < m_chain_size; ++j) {
-        rtmp1 = v_chains_[i].get_residue(j);
-        atmp1 = rtmp1.get_cg_C_alpha();
+        Residue& r = v_chains_[i].get_residue(j);
+        atmp1 = r.get_cg_C_alpha();
         ++tmp_resid_serial;
         atmp1.set_residue_serial(tmp_resid_serial);
         atmp1.set_chain_ID(tmp_chain_serial + 97);
-        tmp_cg_pro_group.push_back(atmp1);
-        tmp_residue_pro_group.push_back(rtmp1);
+        cg_pro_group.push_back(atmp1);
+        residue_pro_group.push_back(r);
       }
     } else if (ct_tmp == DNA) {
       Residue rtmp_P, rtmp_S, rtmp_B, rtmp_P_1;
       for (j = 0; j < m_chain_size; ++j) {
         // Add CG Phosphate;
-        rtmp1 = v_chains_[i].get_residue(j);
+        Residue& rtmp1 = v_chains_[i].get_residue(j);
         if (j != 0) {
           atmp1 = rtmp1.get_cg_P();
           ++tmp_resid_serial;
           atmp1.set_residue_serial(tmp_resid_serial);
           atmp1.set_chain_ID(tmp_chain_serial + 97);
-          tmp_cg_dna_group.push_back(atmp1);
+          cg_dna_group.push_back(atmp1);
         }
         // Add CG Sugar;
         atmp1 = rtmp1.get_cg_S();
         ++tmp_resid_serial;
         atmp1.set_residue_serial(tmp_resid_serial);
         atmp1.set_chain_ID(tmp_chain_serial + 97);
-        tmp_cg_dna_group.push_back(atmp1);
+        cg_dna_group.push_back(atmp1);
 
         // Add CG Base;
         atmp1 = rtmp1.get_cg_B();
         ++tmp_resid_serial;
         atmp1.set_residue_serial(tmp_resid_serial);
         atmp1.set_chain_ID(tmp_chain_serial + 97);
-        tmp_cg_dna_group.push_back(atmp1);
+        cg_dna_group.push_back(atmp1);
 
-        rtmp_P = rtmp_P_1;
+        rtmp_P = std::move(rtmp_P_1);
         rtmp_P_1.reset();
         rtmp_P.set_residue_serial(rtmp1.get_residue_serial());
         rtmp_P_1.set_residue_serial(rtmp1.get_residue_serial());
@@ -368,28 +375,28 @@ void Model::output_ffparm_nonbonded(std::ostream& o)
         rtmp_S.set_chain_ID(rtmp1.get_chain_ID());
         rtmp_B.set_chain_ID(rtmp1.get_chain_ID());
 
-        for (k = 0; k < rtmp1.get_size(); ++k) {
-          atmp1 = rtmp1.get_atom(k);
-          std::string aname = atmp1.get_atom_name();
-          if (aname == "O3' ") {
-            rtmp_P_1.add_atom(atmp1);
-          } else if (aname == "P   " || aname == "OP1 " || aname == "OP2 " ||
-                     aname == "O5' " || aname == "O1P " || aname == "O2P ") {
-            rtmp_P.add_atom(atmp1);
-          } else {
-            std::string::size_type np;
-            np = aname.find("'");
-            if (np == std::string::npos) {
-              rtmp_B.add_atom(atmp1);
-            } else {
-              rtmp_S.add_atom(atmp1);
-            }
+        for (const Atom& atmp1 : rtmp1) {
+          AtomName aname = atmp1.get_atom_name();
+          switch (aname.code()) {
+            case atom_code("O3' "):
+              rtmp_P_1.add_atom(atmp1);
+              break;
+            case atom_code("P   "): case atom_code("OP1 "): case atom_code("OP2 "):
+            case atom_code("O5' "): case atom_code("O1P "): case atom_code("O2P "):
+              rtmp_P.add_atom(atmp1);
+              break;
+            default:
+              if (!aname.contains('\'')) {
+                rtmp_B.add_atom(atmp1);
+              } else {
+                rtmp_S.add_atom(atmp1);
+              }
           }
         }
         if (j != 0)
-          tmp_residue_dna_group.push_back(rtmp_P);
-        tmp_residue_dna_group.push_back(rtmp_S);
-        tmp_residue_dna_group.push_back(rtmp_B);
+          residue_dna_group.push_back(std::move(rtmp_P));
+        residue_dna_group.push_back(std::move(rtmp_S));
+        residue_dna_group.push_back(std::move(rtmp_B));
         rtmp_P.reset();
         rtmp_S.reset();
         rtmp_B.reset();
@@ -407,21 +414,48 @@ void Model::output_ffparm_nonbonded(std::ostream& o)
     }
   }
 
-  // Check vector sizes...
-  if (tmp_cg_pro_group.size() != tmp_residue_pro_group.size()) {
-    std::cout << " ~      PINANG::model_statistics.cpp     ~ \n";
-    std::cout << "ERROR in getting protein atom group and residue group. \n";
-    exit(EXIT_SUCCESS);
-  } else {
-    pg_size = int(tmp_cg_pro_group.size());
+  if (cg_pro_group.size() != residue_pro_group.size()
+      || cg_dna_group.size() != residue_dna_group.size())
+  {
+    std::cout << " ~             PINANG :: model.cpp              ~ " << "\n";
+    std::cerr << " ERROR: Wrong CG particle and residue groups! " << "\n";
+    return 1;
   }
-  if (tmp_cg_dna_group.size() != tmp_residue_dna_group.size()) {
-    std::cout << " ~      PINANG::model_statistics.cpp     ~ \n";
-    std::cout << "ERROR in getting DNA atom group and residue group. \n";
-    exit(EXIT_SUCCESS);
-  } else {
-    dg_size = int(tmp_cg_dna_group.size());
+  return 0;
+}
+
+std::vector<std::pair<int, int> > get_native_contacts(const std::vector<Atom>& cg_pro_group,
+                                                      const std::vector<Residue>& residue_pro_group)
+{
+  std::vector<std::pair<int, int> > contacts;
+  for (const std::pair<int, int>& p : get_residue_contacts(residue_pro_group, g_pro_pro_aa_cutoff, 1)) {
+    const Atom &atmp8 = cg_pro_group[p.first];
+    const Atom &atmp9 = cg_pro_group[p.second];
+    if (atmp9.get_residue_serial() <= atmp8.get_residue_serial() + 3 && atmp8.get_chain_ID() == atmp9.get_chain_ID())
+      continue;
+    contacts.push_back(p);
   }
+  return contacts;
+}
+
+void Model::output_ffparm_nonbonded(std::ostream& o)
+{
+  int i, j, k;
+  Atom atmp3, atmp4;
+  int pg_size, dg_size;
+  double cg_dist = 0;
+  double aa_dist_min = 0;
+  std::string groove_info;
+
+  std::vector<Atom> tmp_cg_pro_group;
+  std::vector<Atom> tmp_cg_dna_group;
+  std::vector<Residue> tmp_residue_pro_group;
+  std::vector<Residue> tmp_residue_dna_group;
+
+  if (get_cg_groups(tmp_cg_pro_group, tmp_residue_pro_group, tmp_cg_dna_group, tmp_residue_dna_group))
+    exit(EXIT_SUCCESS);
+  pg_size = int(tmp_cg_pro_group.size());
+  dg_size = int(tmp_cg_dna_group.size());
 
   // Computing protein-protein native contacts...
   std::vector<int> pro_contact_part_1_atom_serial;
@@ -429,24 +463,15 @@ void Model::output_ffparm_nonbonded(std::ostream& o)
   std::vector<int> pro_contact_part_1_chain_ID;
   std::vector<int> pro_contact_part_2_chain_ID;
   std::vector<double> pro_contact_cg_distance;
-  for (i = 0; i < pg_size - 1; ++i) {
-    Atom &atmp8 = tmp_cg_pro_group[i];
-    Residue &rtmp1 = tmp_residue_pro_group[i];
-    for (j = i + 1; j < pg_size; ++j) {
-      Atom &atmp9 = tmp_cg_pro_group[j];
-      Residue &rtmp2 = tmp_residue_pro_group[j];
-      if (atmp9.get_residue_serial() <= atmp8.get_residue_serial() + 3 && atmp8.get_chain_ID() == atmp9.get_chain_ID())
-        continue;
-      aa_dist_min = residue_min_distance(rtmp1, rtmp2);
-      if (aa_dist_min < g_pro_pro_aa_cutoff && aa_dist_min > 0) {
-        cg_dist = atom_distance(atmp8, atmp9);
-        pro_contact_part_1_atom_serial.push_back(atmp8.get_residue_serial());
-        pro_contact_part_2_atom_serial.push_back(atmp9.get_residue_serial());
-        pro_contact_part_1_chain_ID.push_back(atmp8.get_chain_ID());
-        pro_contact_part_2_chain_ID.push_back(atmp9.get_chain_ID());
-        pro_contact_cg_distance.push_back(cg_dist);
-      }
-    }
+  for (const std::pair<int, int>& p : get_native_contacts(tmp_cg_pro_group, tmp_residue_pro_group)) {
+    Atom &atmp8 = tmp_cg_pro_group[p.first];
+    Atom &atmp9 = tmp_cg_pro_group[p.second];
+    cg_dist = atom_distance(atmp8, atmp9);
+    pro_contact_part_1_atom_serial.push_back(atmp8.get_residue_serial());
+    pro_contact_part_2_atom_serial.push_back(atmp9.get_residue_serial());
+    pro_contact_part_1_chain_ID.push_back(atmp8.get_chain_ID());
+    pro_contact_part_2_chain_ID.push_back(atmp9.get_chain_ID());
+    pro_contact_cg_distance.push_back(cg_dist);
   }
   o << "[ native ]" << std::setw(8) << pro_contact_cg_distance.size() << "\n";
   o << "# " << std::setw(6) << "pi" << std::setw(9) << "pj"
@@ -493,6 +518,9 @@ void Model::output_ffparm_nonbonded(std::ostream& o)
   std::vector<double> pro_DNA_contact_cg_angle_53;
   std::vector<std::string> pro_DNA_contact_cg_groove_info;
   std::vector<std::string> pro_DNA_contact_DNA_atom_name;
+  std::vector<std::pair<int, int> > pro_DNA_contacts
+      = get_residue_contacts(tmp_residue_pro_group, tmp_residue_dna_group, g_pro_DNA_aa_cutoff);
+  std::vector<std::pair<int, int> >::const_iterator p_contact = pro_DNA_contacts.begin();
   for (i = 0; i < pg_size; ++i) {
     Atom &atmp8 = tmp_cg_pro_group[i];
     Residue &rtmp1 = tmp_residue_pro_group[i];
@@ -518,7 +546,8 @@ void Model::output_ffparm_nonbonded(std::ostream& o)
       exit(EXIT_SUCCESS);
     }
 
-    for (j = 0; j < dg_size; ++j) {
+    for (; p_contact != pro_DNA_contacts.end() && p_contact->first == i; ++p_contact) {
+      j = p_contact->second;
       Atom &atmp9 = tmp_cg_dna_group[j];
       Residue &rtmp2 = tmp_residue_dna_group[j];
       if (atmp9.get_atom_name() != "DB  ")
@@ -726,24 +755,19 @@ void Model::output_ffparm_nonbonded(std::ostream& o)
   std::vector<std::string>    pro_DNA_all_contact_DNA_atom_name;
   std::vector<double> pro_DNA_all_contact_cg_distance;
   int pro_DNA_all_contact_number = 0;
-  for (i = 0; i < pg_size - 1; ++i) {
-    Atom &atmp8 = tmp_cg_pro_group[i];
-    Residue &rtmp1 = tmp_residue_pro_group[i];
-    
-    for (j = 0; j < dg_size; ++j) {
-      Atom &atmp9 = tmp_cg_dna_group[j];
-      Residue &rtmp2 = tmp_residue_dna_group[j];
-      aa_dist_min = residue_min_distance(rtmp1, rtmp2);
-      if (aa_dist_min < g_pro_pro_aa_cutoff && aa_dist_min > 0) {
-        pro_DNA_all_contact_pro_atom_serial.push_back(atmp8.get_residue_serial());
-        pro_DNA_all_contact_DNA_atom_serial.push_back(atmp9.get_residue_serial());
-        pro_DNA_all_contact_pro_atom_name.push_back(atmp8.get_residue_name());
-        pro_DNA_all_contact_DNA_atom_name.push_back(atmp9.get_residue_name());
-        cg_dist = atom_distance(atmp8, atmp9);
-        pro_DNA_all_contact_cg_distance.push_back(cg_dist);
-        pro_DNA_all_contact_number ++;
-      }
-    }
+  for (const std::pair<int, int>& p : get_residue_contacts(tmp_residue_pro_group, tmp_residue_dna_group,
+                                                           g_pro_pro_aa_cutoff)) {
+    if (p.first >= pg_size - 1)
+      continue;
+    Atom &atmp8 = tmp_cg_pro_group[p.first];
+    Atom &atmp9 = tmp_cg_dna_group[p.second];
+    pro_DNA_all_contact_pro_atom_serial.push_back(atmp8.get_residue_serial());
+    pro_DNA_all_contact_DNA_atom_serial.push_back(atmp9.get_residue_serial());
+    pro_DNA_all_contact_pro_atom_name.push_back(atmp8.get_residue_name());
+    pro_DNA_all_contact_DNA_atom_name.push_back(atmp9.get_residue_name());
+    cg_dist = atom_distance(atmp8, atmp9);
+    pro_DNA_all_contact_cg_distance.push_back(cg_dist);
+    pro_DNA_all_contact_number ++;
   }
 
   o << "\n[ protein-DNA all contacts ]" << std::setw(8) << pro_DNA_all_contact_number << "\n";
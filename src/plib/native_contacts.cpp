@@ -0,0 +1,217 @@
+/*!
+  @file native_contacts.cpp
+  @brief Reading, deriving and counting native contacts.
+
+  The counting loop compares squared distances with squared thresholds, so no
+  square root is taken, and the formed contacts are summed without branches.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:32
+  @copyright GNU Public License V3.0
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include "native_contacts.hpp"
+#include "neighbor_search.hpp"
+
+namespace pinang {
+
+NativeContacts::NativeContacts()
+{
+  n_inter_ = 0;
+  tolerance_ = 1.2;
+}
+
+void NativeContacts::reset()
+{
+  i_.clear();
+  j_.clear();
+  r0_.clear();
+  r2_max_.clear();
+  inter_.clear();
+  n_inter_ = 0;
+}
+
+void NativeContacts::add_contact(int i, int j, double r0, bool inter)
+{
+  i_.push_back(i);
+  j_.push_back(j);
+  r0_.push_back(r0);
+  r2_max_.push_back(tolerance_ * tolerance_ * r0 * r0);
+  inter_.push_back(inter ? 1 : 0);
+  if (inter)
+    ++n_inter_;
+}
+
+void NativeContacts::set_tolerance(double f)
+{
+  tolerance_ = f;
+  for (int k = 0; k < get_size(); ++k)
+    r2_max_[k] = tolerance_ * tolerance_ * r0_[k] * r0_[k];
+}
+
+int NativeContacts::read_ffp(const std::string& ffp_name)
+{
+  std::ifstream ffp_file(ffp_name.c_str());
+  if (!ffp_file.is_open())
+  {
+    std::cout << " ~             PINANG :: native_contacts.cpp        ~ " << "\n";
+    std::cerr << " ERROR: Cannot open file: " << ffp_name << "\n";
+    return 1;
+  }
+  return read_ffp(ffp_file);
+}
+
+int NativeContacts::read_ffp(std::istream& ffp_file)
+{
+  reset();
+  std::string ffp_line;
+  while (std::getline(ffp_file, ffp_line)) {
+    std::string::size_type m = ffp_line.find("[ native ]");
+    if (m == std::string::npos)
+      continue;
+    int n_contact = 0;
+    std::istringstream tmp_sstr(ffp_line.substr(m + 10));
+    tmp_sstr >> n_contact;
+    for (int k = 0; k < n_contact && std::getline(ffp_file, ffp_line); ) {
+      if (ffp_line.empty() || ffp_line[0] == '#')
+        continue;
+      std::istringstream pair_sstr(ffp_line);
+      int pi = 0, pj = 0;
+      char ci = 0, cj = 0;
+      double r0 = 0;
+      pair_sstr >> pi >> pj >> ci >> cj >> r0;
+      if (pair_sstr.fail() || pi < 1 || pj < 1)
+      {
+        std::cout << " ~             PINANG :: native_contacts.cpp        ~ " << "\n";
+        std::cerr << " ERROR: Wrong line in [ native ] block: " << ffp_line << "\n";
+        return 1;
+      }
+      add_contact(pi - 1, pj - 1, r0, ci != cj);
+      ++k;
+    }
+    return 0;
+  }
+  std::cout << " ~             PINANG :: native_contacts.cpp        ~ " << "\n";
+  std::cerr << " ERROR: [ native ] block not found! " << "\n";
+  return 1;
+}
+
+int NativeContacts::set_contacts(Model& mdl)
+{
+  reset();
+  std::vector<Atom> cg_pro_group;
+  std::vector<Atom> cg_dna_group;
+  std::vector<Residue> residue_pro_group;
+  std::vector<Residue> residue_dna_group;
+  if (mdl.get_cg_groups(cg_pro_group, residue_pro_group, cg_dna_group, residue_dna_group))
+    return 1;
+  // same contacts as the [ native ] block written by pdb_cg_top -P;
+  for (const std::pair<int, int>& p : get_native_contacts(cg_pro_group, residue_pro_group)) {
+    const Atom& a1 = cg_pro_group[p.first];
+    const Atom& a2 = cg_pro_group[p.second];
+    add_contact(a1.get_residue_serial() - 1, a2.get_residue_serial() - 1, atom_distance(a1, a2),
+                a1.get_chain_ID() != a2.get_chain_ID());
+  }
+  return 0;
+}
+
+int NativeContacts::set_contacts(const Conformation& conf, Topology& top, double cutoff,
+                                 int min_sep)
+{
+  reset();
+  if (conf.get_size() != top.get_size())
+  {
+    std::cout << " ~             PINANG :: native_contacts.cpp        ~ " << "\n";
+    std::cerr << " ERROR: Particle number don't match in top and reference! " << "\n";
+    return 1;
+  }
+  CoordinateView<double> v = conf.get_view();
+  std::vector<Vec3d> coors(conf.get_size());
+  std::vector<char> chains(conf.get_size());
+  for (int i = 0; i < conf.get_size(); ++i) {
+    coors[i] = v.get_coordinate(i);
+    chains[i] = top.get_particle(i).get_chain_ID();
+  }
+  CellList cells;
+  if (cells.build(coors, cutoff))
+    return 1;
+  std::vector<std::pair<int, int> > pairs;
+  cells.for_each_pair([&](int i, int j, double d2) {
+      if (chains[i] == chains[j] && j - i < min_sep)
+        return;
+      if (std::sqrt(d2) < cutoff)
+        pairs.push_back(std::make_pair(i, j));
+    });
+  std::sort(pairs.begin(), pairs.end());
+  for (const std::pair<int, int>& p : pairs)
+    add_contact(p.first, p.second, vec_distance(coors[p.first], coors[p.second]),
+                chains[p.first] != chains[p.second]);
+  return 0;
+}
+
+std::vector<int> NativeContacts::get_atoms() const
+{
+  std::vector<int> atoms(i_);
+  atoms.insert(atoms.end(), j_.begin(), j_.end());
+  std::sort(atoms.begin(), atoms.end());
+  atoms.erase(std::unique(atoms.begin(), atoms.end()), atoms.end());
+  return atoms;
+}
+
+int NativeContacts::renumber(const Selection& from, const Selection& to)
+{
+  if (from.get_size() != to.get_size())
+    return 1;
+  std::vector<int> keys(from.get_size());
+  for (int k = 0; k < from.get_size(); ++k)
+    keys[k] = from.get_selection(k);
+  std::vector<int>* lists[2] = {&i_, &j_};
+  for (std::vector<int>* v : lists) {
+    for (int& a : *v) {
+      std::vector<int>::const_iterator it = std::lower_bound(keys.begin(), keys.end(), a);
+      if (it == keys.end() || *it != a)
+      {
+        std::cout << " ~             PINANG :: native_contacts.cpp        ~ " << "\n";
+        std::cerr << " ERROR: Particle " << a + 1 << " not found in selection. " << "\n";
+        return 1;
+      }
+      a = to.get_selection(it - keys.begin());
+    }
+  }
+  return 0;
+}
+
+int NativeContacts::compute_q(const Conformation& conf, double& q, double& q_intra,
+                              double& q_inter) const
+{
+  CoordinateView<double> v = conf.get_view();
+  const double* x = v.x();
+  const double* y = v.y();
+  const double* z = v.z();
+  const int s = v.get_stride();
+  const int n = get_size();
+
+  int n_formed = 0;
+  int n_formed_inter = 0;
+  for (int k = 0; k < n; ++k) {
+    double dx = x[i_[k] * s] - x[j_[k] * s];
+    double dy = y[i_[k] * s] - y[j_[k] * s];
+    double dz = z[i_[k] * s] - z[j_[k] * s];
+    int formed = (dx * dx + dy * dy + dz * dz) < r2_max_[k];
+    n_formed += formed;
+    n_formed_inter += formed & inter_[k];
+  }
+
+  int n_inter = get_inter_number();
+  int n_intra = get_intra_number();
+  q = n > 0 ? double(n_formed) / n : 0.0;
+  q_intra = n_intra > 0 ? double(n_formed - n_formed_inter) / n_intra : 0.0;
+  q_inter = n_inter > 0 ? double(n_formed_inter) / n_inter : 0.0;
+  return n_formed;
+}
+
+}  // pinang
@@ -0,0 +1,323 @@
+/*!
+  @file neighbor_search.cpp
+  @brief Building cell lists and Verlet lists, and searching pairs within a cutoff.
+
+  The grid covers the bounding box of the coordinates.  If the box is so large
+  (compared to the cutoff) that there would be many more cells than particles,
+  the cells are enlarged, keeping the memory usage linear.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:24
+  @copyright GNU Public License V3.0
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include "neighbor_search.hpp"
+
+namespace pinang {
+
+CellList::CellList()
+{
+  cutoff_ = 0.0;
+  cutoff_2_ = 0.0;
+  cell_size_ = 1.0;
+  for (int d = 0; d < 3; ++d) {
+    origin_[d] = 0.0;
+    n_cell_[d] = 1;
+  }
+  cell_start_.assign(2, 0);
+}
+
+int CellList::build(const std::vector<Vec3d>& coors, double cutoff)
+{
+  if (!(cutoff > 0))
+  {
+    std::cout << " ~             PINANG :: neighbor_search.cpp        ~ " << "\n";
+    std::cerr << " ERROR: Cutoff of cell list must be positive! " << "\n";
+    return 1;
+  }
+  cutoff_ = cutoff;
+  cutoff_2_ = cutoff * cutoff;
+
+  int n = coors.size();
+  double hi[3];
+  for (int d = 0; d < 3; ++d) {
+    origin_[d] = n > 0 ? coors[0][d] : 0.0;
+    hi[d] = origin_[d];
+  }
+  for (const Vec3d& v : coors) {
+    for (int d = 0; d < 3; ++d) {
+      origin_[d] = std::min(origin_[d], v[d]);
+      hi[d] = std::max(hi[d], v[d]);
+    }
+  }
+
+  // at most ~ 2n + 27 cells;
+  const double max_cells = 2.0 * n + 27;
+  cell_size_ = cutoff;
+  double n_total = 0;
+  do {
+    n_total = 1;
+    for (int d = 0; d < 3; ++d) {
+      n_cell_[d] = int(std::floor((hi[d] - origin_[d]) / cell_size_)) + 1;
+      n_total *= n_cell_[d];
+    }
+    if (n_total > max_cells)
+      cell_size_ *= std::cbrt(n_total / max_cells) * 1.01;
+  } while (n_total > max_cells);
+
+  // counting sort of coordinates by cell;
+  int n_cells = n_cell_[0] * n_cell_[1] * n_cell_[2];
+  std::vector<int> cell_of(n);
+  cell_start_.assign(n_cells + 1, 0);
+  for (int i = 0; i < n; ++i) {
+    int c[3];
+    for (int d = 0; d < 3; ++d)
+      c[d] = std::max(0, std::min(get_cell_index(coors[i][d], d), n_cell_[d] - 1));
+    cell_of[i] = get_cell(c[0], c[1], c[2]);
+    ++cell_start_[cell_of[i] + 1];
+  }
+  for (int c = 0; c < n_cells; ++c)
+    cell_start_[c + 1] += cell_start_[c];
+
+  std::vector<int> pos(cell_start_.begin(), cell_start_.end() - 1);
+  x_.resize(n);
+  y_.resize(n);
+  z_.resize(n);
+  index_.resize(n);
+  for (int i = 0; i < n; ++i) {
+    int m = pos[cell_of[i]]++;
+    x_[m] = coors[i].x();
+    y_[m] = coors[i].y();
+    z_[m] = coors[i].z();
+    index_[m] = i;
+  }
+  return 0;
+}
+
+bool CellList::has_neighbor(const Vec3d& p) const
+{
+  if (index_.empty())
+    return false;
+  int lo[3], hi[3];
+  for (int d = 0; d < 3; ++d) {
+    int c = get_cell_index(p[d], d);
+    lo[d] = c > 0 ? c - 1 : 0;
+    hi[d] = c < n_cell_[d] - 1 ? c + 1 : n_cell_[d] - 1;
+    if (lo[d] > hi[d])
+      return false;
+  }
+  const double px = p.x(), py = p.y(), pz = p.z();
+  for (int i = lo[0]; i <= hi[0]; ++i) {
+    for (int j = lo[1]; j <= hi[1]; ++j) {
+      int m_end = cell_start_[get_cell(i, j, hi[2]) + 1];
+      for (int m = cell_start_[get_cell(i, j, lo[2])]; m < m_end; ++m) {
+        double dx = x_[m] - px;
+        double dy = y_[m] - py;
+        double dz = z_[m] - pz;
+        if (dx * dx + dy * dy + dz * dz <= cutoff_2_)
+          return true;
+      }
+    }
+  }
+  return false;
+}
+
+int CellList::find_nearest(const Vec3d& p, double& d2_min) const
+{
+  d2_min = -1;
+  if (index_.empty())
+    return -1;
+  // unclamped cell of the point, and the shells needed to reach / cover the grid;
+  long c[3];
+  long r_first = 0, r_last = 0;
+  for (int d = 0; d < 3; ++d) {
+    c[d] = long(std::floor((p[d] - origin_[d]) / cell_size_));
+    r_first = std::max(r_first, std::max(-c[d], c[d] - (n_cell_[d] - 1)));
+    r_last = std::max(r_last, std::max(c[d], (n_cell_[d] - 1) - c[d]));
+  }
+
+  const double px = p.x(), py = p.y(), pz = p.z();
+  int i_min = -1;
+  auto scan = [&](long i, long j, long k_lo, long k_hi) {
+    int m_end = cell_start_[get_cell(i, j, k_hi) + 1];
+    for (int m = cell_start_[get_cell(i, j, k_lo)]; m < m_end; ++m) {
+      double dx = x_[m] - px;
+      double dy = y_[m] - py;
+      double dz = z_[m] - pz;
+      double d2 = dx * dx + dy * dy + dz * dz;
+      if (i_min < 0 || d2 < d2_min || (d2 == d2_min && index_[m] < i_min)) {
+        d2_min = d2;
+        i_min = index_[m];
+      }
+    }
+  };
+  for (long r = r_first; r <= r_last; ++r) {
+    // all the cells of shell r + 1 are at least r * cell_size_ away;
+    long lo[3], hi[3];
+    for (int d = 0; d < 3; ++d) {
+      lo[d] = std::max(c[d] - r, 0L);
+      hi[d] = std::min(c[d] + r, long(n_cell_[d] - 1));
+    }
+    for (long i = lo[0]; i <= hi[0]; ++i) {
+      for (long j = lo[1]; j <= hi[1]; ++j) {
+        if (std::abs(i - c[0]) == r || std::abs(j - c[1]) == r) {
+          scan(i, j, lo[2], hi[2]);
+        } else {
+          if (c[2] - r >= 0)
+            scan(i, j, c[2] - r, c[2] - r);
+          if (r > 0 && c[2] + r <= n_cell_[2] - 1)
+            scan(i, j, c[2] + r, c[2] + r);
+        }
+      }
+    }
+    double d_shell = r * cell_size_;
+    if (i_min >= 0 && d2_min < d_shell * d_shell)
+      break;
+  }
+  return i_min;
+}
+
+VerletList::VerletList()
+{
+  cutoff_ = 0.0;
+  skin_ = 0.0;
+  self_ = false;
+  min_sep_ = 0;
+  start_.assign(1, 0);
+  n_build_ = 0;
+}
+
+VerletList::VerletList(double cutoff, double skin)
+{
+  self_ = false;
+  min_sep_ = 0;
+  start_.assign(1, 0);
+  n_build_ = 0;
+  set_cutoff(cutoff, skin);
+}
+
+void VerletList::set_cutoff(double cutoff, double skin)
+{
+  cutoff_ = cutoff;
+  skin_ = skin > 0 ? skin : 0.0;
+  ref_a_.clear();
+  ref_b_.clear();
+  start_.assign(1, 0);
+  list_.clear();
+}
+
+bool VerletList::is_valid(const std::vector<Vec3d>& a, const std::vector<Vec3d>& b) const
+{
+  if (n_build_ == 0 || a.size() != ref_a_.size() || get_size() != int(a.size())
+      || (!self_ && b.size() != ref_b_.size()))
+    return false;
+  // pairs out of the list are farther than cutoff + skin at the last build;
+  // if no particle moved more than skin / 2, they are still beyond cutoff;
+  const double max_2 = 0.25 * skin_ * skin_;
+  for (std::size_t i = 0; i < a.size(); ++i)
+    if ((a[i] - ref_a_[i]).squared_norm() > max_2)
+      return false;
+  if (!self_) {
+    for (std::size_t j = 0; j < b.size(); ++j)
+      if ((b[j] - ref_b_[j]).squared_norm() > max_2)
+        return false;
+  }
+  return true;
+}
+
+void VerletList::set_list(std::vector<std::vector<int> >& nb)
+{
+  start_.resize(nb.size() + 1);
+  start_[0] = 0;
+  list_.clear();
+  for (std::size_t i = 0; i < nb.size(); ++i) {
+    std::sort(nb[i].begin(), nb[i].end());
+    list_.insert(list_.end(), nb[i].begin(), nb[i].end());
+    start_[i + 1] = list_.size();
+  }
+  ++n_build_;
+}
+
+int VerletList::update(const std::vector<Vec3d>& a, const std::vector<Vec3d>& b)
+{
+  if (!self_ && is_valid(a, b))
+    return 0;
+  if (cells_.build(b, cutoff_ + skin_))
+    return 1;
+  std::vector<std::vector<int> > nb(a.size());
+  for (int i = 0; i < int(a.size()); ++i)
+    cells_.for_each_neighbor(a[i], [&](int j, double) { nb[i].push_back(j); });
+  self_ = false;
+  ref_a_ = a;
+  ref_b_ = b;
+  set_list(nb);
+  return 0;
+}
+
+int VerletList::update(const std::vector<Vec3d>& x, const std::vector<int>& seq, int min_sep)
+{
+  if (self_ && min_sep == min_sep_ && seq == seq_ && is_valid(x, x))
+    return 0;
+  if (!seq.empty() && seq.size() != x.size())
+  {
+    std::cout << " ~             PINANG :: neighbor_search.cpp        ~ " << "\n";
+    std::cerr << " ERROR: Wrong size of sequence list in Verlet list! " << "\n";
+    return 1;
+  }
+  if (cells_.build(x, cutoff_ + skin_))
+    return 1;
+  std::vector<std::vector<int> > nb(x.size());
+  cells_.for_each_pair([&](int i, int j, double) {
+      if (seq.empty() || std::abs(seq[i] - seq[j]) >= min_sep)
+        nb[i].push_back(j);
+    });
+  self_ = true;
+  min_sep_ = min_sep;
+  seq_ = seq;
+  ref_a_ = x;
+  ref_b_.clear();
+  set_list(nb);
+  return 0;
+}
+
+int find_pairs(const std::vector<Vec3d>& a, const std::vector<Vec3d>& b, double cutoff,
+               std::vector<std::pair<int, int> >& pairs)
+{
+  pairs.clear();
+  CellList cells;
+  if (cells.build(b, cutoff))
+    return 1;
+  for (int i = 0; i < int(a.size()); ++i) {
+    std::size_t first = pairs.size();
+    cells.for_each_neighbor(a[i], [&](int j, double) { pairs.push_back(std::make_pair(i, j)); });
+    std::sort(pairs.begin() + first, pairs.end());
+  }
+  return 0;
+}
+
+int find_pairs(const std::vector<Vec3d>& x, double cutoff, const std::vector<int>& seq,
+               int min_sep, std::vector<std::pair<int, int> >& pairs)
+{
+  pairs.clear();
+  if (!seq.empty() && seq.size() != x.size())
+  {
+    std::cout << " ~             PINANG :: neighbor_search.cpp        ~ " << "\n";
+    std::cerr << " ERROR: Wrong size of sequence list in pair search! " << "\n";
+    return 1;
+  }
+  CellList cells;
+  if (cells.build(x, cutoff))
+    return 1;
+  cells.for_each_pair([&](int i, int j, double) {
+      if (!seq.empty() && std::abs(seq[i] - seq[j]) < min_sep)
+        return;
+      pairs.push_back(std::make_pair(i, j));
+    });
+  std::sort(pairs.begin(), pairs.end());
+  return 0;
+}
+
+}  // pinang
@@ -0,0 +1,122 @@
+/*!
+  @file parallel_frames.cpp
+  @brief Define frame-parallel driver functions.
+
+  Definitions of parallel_for() with a simple work-stealing scheduler and of
+  parallel_for_frames(), which reads frames through a DcdPrefetcher when it
+  runs on a single thread.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 12:51
+  @copyright GNU Public License V3.0
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "parallel_frames.hpp"
+#include "dcd_prefetcher.hpp"
+
+namespace pinang {
+
+int get_thread_number(int n)
+{
+  if (n > 0)
+    return n;
+  n = std::thread::hardware_concurrency();
+  return n > 0 ? n : 1;
+}
+
+int parallel_for(int n, int n_thread, const std::function<void(int, int)>& f)
+{
+  n_thread = get_thread_number(n_thread);
+  if (n_thread > n)
+    n_thread = n > 0 ? n : 1;
+  if (n_thread == 1) {
+    for (int i = 0; i < n; ++i)
+      f(0, i);
+    return 0;
+  }
+
+  // About 8 chunks per thread, so that stealing can balance the load.
+  int chunk = n / (8 * n_thread);
+  if (chunk < 1)
+    chunk = 1;
+  std::vector<std::deque<std::pair<int, int> > > queues(n_thread);
+  std::vector<std::mutex> locks(n_thread);
+  for (int t = 0; t < n_thread; ++t) {
+    int begin = (long long)n * t / n_thread;
+    int end = (long long)n * (t + 1) / n_thread;
+    for (int i = begin; i < end; i += chunk)
+      queues[t].push_back(std::make_pair(i, std::min(i + chunk, end)));
+  }
+
+  auto worker = [&](int t) {
+    while (true) {
+      std::pair<int, int> task(0, 0);
+      bool found = false;
+      {
+        std::lock_guard<std::mutex> lock(locks[t]);
+        if (!queues[t].empty()) {
+          task = queues[t].front();
+          queues[t].pop_front();
+          found = true;
+        }
+      }
+      // No new tasks are created, so if all queues are empty we are done.
+      for (int v = 1; v < n_thread && !found; ++v) {
+        int victim = (t + v) % n_thread;
+        std::lock_guard<std::mutex> lock(locks[victim]);
+        if (!queues[victim].empty()) {
+          task = queues[victim].back();
+          queues[victim].pop_back();
+          found = true;
+        }
+      }
+      if (!found)
+        return;
+      for (int i = task.first; i < task.second; ++i)
+        f(t, i);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 1; t < n_thread; ++t)
+    threads.push_back(std::thread(worker, t));
+  worker(0);
+  for (std::thread& th : threads)
+    th.join();
+  return 0;
+}
+
+int parallel_for_frames(const DcdMappedReader& dcd, int n_thread,
+                        const std::function<void(int, int, Conformation&)>& f)
+{
+  const int n = dcd.get_range_size();
+  n_thread = get_thread_number(n_thread);
+  if (n_thread == 1) {
+    // Serial: the next frames are decoded on a background thread meanwhile.
+    DcdPrefetcher prefetcher(dcd);
+    Conformation conf;
+    int k = 0;
+    for (; k < n && prefetcher.next_frame(conf) == 0; ++k)
+      f(0, k, conf);
+    return k < n ? 1 : 0;
+  }
+
+  std::vector<Conformation> confs(n_thread);
+  std::atomic<int> status(0);
+
+  parallel_for(n, n_thread, [&](int t, int k) {
+      if (dcd.read_frame(dcd.get_range_frame(k), confs[t])) {
+        status = 1;
+        return;
+      }
+      f(t, k, confs[t]);
+    });
+  return status;
+}
+
+}  // pinang
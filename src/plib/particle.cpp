@@ -14,28 +14,6 @@
 
 namespace pinang {
 
-void Particle::set_atom_name(const std::string& s)
-{
-  size_t sz = 4;
-  atom_name_ = s;
-
-  if (atom_name_.size() < sz)
-  {
-    atom_name_.resize(sz, ' ');
-  }
-}
-
-void Particle::set_residue_name(const std::string& s)
-{
-  size_t sz = 3;
-  residue_name_ = s;
-
-  if (residue_name_.size() < sz)
-  {
-    residue_name_.resize(sz, ' ');
-  }
-}
-
 // Particle::Particle ==============================================================
 Particle::Particle()
 {
@@ -78,10 +56,26 @@ std::istream& operator>>(std::istream& i, Particle& p)
   p.residue_serial_ = tmp_i;
 
   tmp_sstr >> tmp_s;
-  p.set_residue_name(tmp_s);
+  if (int(tmp_s.size()) > PsfResidueName::max_size())
+  {
+    std::cout << " ~             PINANG :: particle.cpp           ~ " << "\n";
+    std::cerr << " ERROR: Residue name longer than " << PsfResidueName::max_size()
+              << " characters: " << tmp_s << "\n";
+    i.setstate(std::ios::failbit);
+    return i;
+  }
+  p.set_residue_name(PsfResidueName(tmp_s));
 
   tmp_sstr >> tmp_s;
-  p.set_atom_name(tmp_s);
+  if (int(tmp_s.size()) > AtomName::max_size())
+  {
+    std::cout << " ~             PINANG :: particle.cpp           ~ " << "\n";
+    std::cerr << " ERROR: Atom name longer than " << AtomName::max_size()
+              << " characters: " << tmp_s << "\n";
+    i.setstate(std::ios::failbit);
+    return i;
+  }
+  p.set_atom_name(AtomName(tmp_s));
 
   tmp_sstr >> tmp_s;
 
@@ -0,0 +1,419 @@
+/*!
+  @file pdb_cache.cpp
+  @brief Define functions of class PDBCache.
+
+  Definitions of the record layout of ".pdbcache" files, and of reading (by
+  mmap) and writing them.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 14:12
+  @copyright GNU Public License V3.0
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "pdb_cache.hpp"
+
+namespace pinang {
+
+namespace {
+const char k_pdbcache_magic[8] = {'P', 'N', 'P', 'D', 'B', 'B', 'I', 'N'};
+const std::int32_t k_pdbcache_version = 2;
+const int k_n_cg_bead = 5;       // C_alpha, C_beta, P, S, B;
+
+typedef FixedName<8> CachedName;  // Residue name and short name;
+
+// All the records have sizes of multiples of 8 bytes, so that every section of
+// a mapped cache file is aligned.
+struct CacheHeader
+{
+  char magic[8];
+  std::int32_t version;
+  std::int32_t record_size;     // sizeof(AtomRecord), as a layout check;
+  std::int64_t source_size;
+  std::int64_t source_mtime;    // in nanoseconds;
+  std::int64_t n_model;
+  std::int64_t n_chain;
+  std::int64_t n_residue;
+  std::int64_t n_atom;
+  std::uint64_t checksum;
+};
+
+struct ModelRecord
+{
+  std::int32_t model_serial;
+  std::int32_t n_chain;
+};
+
+struct ChainRecord
+{
+  std::int32_t chain_type;
+  std::int32_t n_residue;
+  char chain_ID;
+  char pad[7];
+};
+
+struct ResidueRecord
+{
+  std::uint64_t residue_name;
+  std::uint64_t short_name;
+  double charge;
+  double mass;
+  double sasa;
+  std::int32_t residue_serial;
+  std::int32_t n_atom;
+  std::int32_t terminus_flag;
+  std::int32_t chain_type;
+  char chain_ID;
+  char pad[7];
+};
+
+struct AtomRecord
+{
+  double x;
+  double y;
+  double z;
+  double occupancy;
+  double temperature_factor;
+  std::uint64_t record_name;
+  std::int32_t atom_serial;
+  std::int32_t residue_serial;
+  std::uint32_t atom_name;
+  std::uint32_t residue_name;
+  std::uint32_t seg_ID;
+  std::uint16_t element;
+  std::uint16_t charge;
+  char alt_loc;
+  char chain_ID;
+  char insert_code;
+  char pad[5];
+};
+
+static_assert(sizeof(CacheHeader) % 8 == 0 && sizeof(ModelRecord) % 8 == 0
+              && sizeof(ChainRecord) % 8 == 0 && sizeof(ResidueRecord) % 8 == 0
+              && sizeof(AtomRecord) % 8 == 0,
+              "PDBCache: records must be made of 64-bit words.");
+
+// 64-bit FNV-1a hash, taking 8 bytes per step (all the records are made of
+// whole 64-bit words), so that checking a large cache costs little.
+const std::uint64_t k_fnv_offset = 14695981039346656037ULL;
+const std::uint64_t k_fnv_prime = 1099511628211ULL;
+
+std::uint64_t fnv1a(const void* data, std::size_t n, std::uint64_t h)
+{
+  const char* p = static_cast<const char*>(data);
+  for (std::size_t i = 0; i + 8 <= n; i += 8) {
+    std::uint64_t w;
+    std::memcpy(&w, p + i, 8);
+    h ^= w;
+    h *= k_fnv_prime;
+  }
+  return h;
+}
+
+std::uint64_t header_checksum(const CacheHeader& h)
+{
+  std::uint64_t c = k_fnv_offset;
+  c = fnv1a(&h.source_size, sizeof(h.source_size), c);
+  c = fnv1a(&h.source_mtime, sizeof(h.source_mtime), c);
+  c = fnv1a(&h.n_model, sizeof(h.n_model), c);
+  c = fnv1a(&h.n_chain, sizeof(h.n_chain), c);
+  c = fnv1a(&h.n_residue, sizeof(h.n_residue), c);
+  c = fnv1a(&h.n_atom, sizeof(h.n_atom), c);
+  return c;
+}
+
+std::int64_t cache_size(const CacheHeader& h)
+{
+  return sizeof(CacheHeader) + h.n_model * sizeof(ModelRecord)
+      + h.n_chain * sizeof(ChainRecord) + h.n_residue * sizeof(ResidueRecord)
+      + (h.n_atom + k_n_cg_bead * h.n_residue) * sizeof(AtomRecord);
+}
+}
+
+std::string PDBCache::get_sidecar_name(const std::string& pdb_name)
+{
+  std::size_t n = pdb_name.size();
+  if (n >= 4 && pdb_name.compare(n - 4, 4, ".pdb") == 0)
+    return pdb_name + "cache";
+  return pdb_name + ".pdbcache";
+}
+
+int PDBCache::get_stamp(const std::string& s, std::int64_t& size, std::int64_t& mtime)
+{
+  struct stat st;
+  if (stat(s.c_str(), &st) != 0)
+    return 1;
+  size = st.st_size;
+  // seconds alone would miss a PDB file rewritten within the same second;
+  mtime = std::int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+  return 0;
+}
+
+int PDBCache::write(const std::string& pdb_name, const PDB& pdb, std::int64_t source_size,
+                    std::int64_t source_mtime)
+{
+  CacheHeader h;
+  std::memset(&h, 0, sizeof(h));
+  std::memcpy(h.magic, k_pdbcache_magic, 8);
+  h.version = k_pdbcache_version;
+  h.record_size = sizeof(AtomRecord);
+  h.source_size = source_size;
+  h.source_mtime = source_mtime;
+
+  std::vector<ModelRecord> models;
+  std::vector<ChainRecord> chains;
+  std::vector<ResidueRecord> residues;
+  std::vector<AtomRecord> atoms;
+  std::vector<AtomRecord> beads;
+
+  auto put_atom = [](const Atom& a, std::vector<AtomRecord>& v) {
+    AtomRecord r;
+    std::memset(&r, 0, sizeof(r));
+    r.x = a.coordinate_.x();
+    r.y = a.coordinate_.y();
+    r.z = a.coordinate_.z();
+    r.occupancy = a.occupancy_;
+    r.temperature_factor = a.temperature_factor_;
+    r.record_name = a.record_name_.code();
+    r.atom_serial = a.atom_serial_;
+    r.residue_serial = a.residue_serial_;
+    r.atom_name = a.atom_name_.code();
+    r.residue_name = a.residue_name_.code();
+    r.seg_ID = a.seg_ID_.code();
+    r.element = a.element_.code();
+    r.charge = a.charge_.code();
+    r.alt_loc = a.alt_loc_;
+    r.chain_ID = a.chain_ID_;
+    r.insert_code = a.insert_code_;
+    v.push_back(r);
+  };
+
+  for (const Model& m : pdb.v_models_) {
+    ModelRecord mr = {m.model_serial_, m.n_chain_};
+    models.push_back(mr);
+    for (const Chain& c : m.v_chains_) {
+      ChainRecord cr;
+      std::memset(&cr, 0, sizeof(cr));
+      cr.chain_type = c.chain_type_;
+      cr.n_residue = c.n_residue_;
+      cr.chain_ID = c.chain_ID_;
+      chains.push_back(cr);
+      for (const Residue& r : c.v_residues_) {
+        // longer names cannot be packed; such a PDB is simply not cached.
+        if (r.residue_name_.size() > 8 || r.short_name_.size() > 8)
+          return 1;
+        ResidueRecord rr;
+        std::memset(&rr, 0, sizeof(rr));
+        rr.residue_name = CachedName(r.residue_name_).code();
+        rr.short_name = CachedName(r.short_name_).code();
+        rr.charge = r.charge_;
+        rr.mass = r.mass_;
+        rr.sasa = r.sasa_;
+        rr.residue_serial = r.residue_serial_;
+        rr.n_atom = r.n_atom_;
+        rr.terminus_flag = r.terminus_flag_;
+        rr.chain_type = r.chain_type_;
+        rr.chain_ID = r.chain_ID_;
+        residues.push_back(rr);
+        for (const Atom& a : r.v_atoms_)
+          put_atom(a, atoms);
+        put_atom(r.cg_C_alpha_, beads);
+        put_atom(r.cg_C_beta_, beads);
+        put_atom(r.cg_P_, beads);
+        put_atom(r.cg_S_, beads);
+        put_atom(r.cg_B_, beads);
+      }
+    }
+  }
+  h.n_model = models.size();
+  h.n_chain = chains.size();
+  h.n_residue = residues.size();
+  h.n_atom = atoms.size();
+
+  std::uint64_t c = header_checksum(h);
+  c = fnv1a(models.data(), models.size() * sizeof(ModelRecord), c);
+  c = fnv1a(chains.data(), chains.size() * sizeof(ChainRecord), c);
+  c = fnv1a(residues.data(), residues.size() * sizeof(ResidueRecord), c);
+  c = fnv1a(atoms.data(), atoms.size() * sizeof(AtomRecord), c);
+  c = fnv1a(beads.data(), beads.size() * sizeof(AtomRecord), c);
+  h.checksum = c;
+
+  // Write to a temporary file of unique name first, so that other processes
+  // never map a partially written cache, and jobs writing the cache of the
+  // same PDB at the same time do not write into the same file.
+  std::string cache_name = get_sidecar_name(pdb_name);
+  std::vector<char> tmp_buf(cache_name.begin(), cache_name.end());
+  const char tmp_suffix[] = ".XXXXXX";
+  tmp_buf.insert(tmp_buf.end(), tmp_suffix, tmp_suffix + sizeof(tmp_suffix));
+  int fd = mkstemp(tmp_buf.data());
+  if (fd < 0)
+    return 1;
+  fchmod(fd, 0644);
+  ::close(fd);
+  std::string tmp_name(tmp_buf.data());
+  std::ofstream cache_file(tmp_name.c_str(), std::ofstream::binary);
+  if (!cache_file.is_open())
+  {
+    std::remove(tmp_name.c_str());
+    return 1;
+  }
+  cache_file.write((const char*)&h, sizeof(h));
+  cache_file.write((const char*)models.data(), models.size() * sizeof(ModelRecord));
+  cache_file.write((const char*)chains.data(), chains.size() * sizeof(ChainRecord));
+  cache_file.write((const char*)residues.data(), residues.size() * sizeof(ResidueRecord));
+  cache_file.write((const char*)atoms.data(), atoms.size() * sizeof(AtomRecord));
+  cache_file.write((const char*)beads.data(), beads.size() * sizeof(AtomRecord));
+  cache_file.close();
+  if (!cache_file || std::rename(tmp_name.c_str(), cache_name.c_str()) != 0)
+  {
+    std::remove(tmp_name.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+int PDBCache::read(const std::string& pdb_name, PDB& pdb)
+{
+  std::int64_t size = 0;
+  std::int64_t mtime = 0;
+  if (get_stamp(pdb_name, size, mtime))
+    return 1;
+
+  std::string cache_name = get_sidecar_name(pdb_name);
+  int fd = ::open(cache_name.c_str(), O_RDONLY);
+  if (fd < 0)
+    return 1;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < std::int64_t(sizeof(CacheHeader)))
+  {
+    ::close(fd);
+    return 1;
+  }
+  void* addr = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED)
+    return 1;
+  const std::size_t map_size = st.st_size;
+  const char* p = static_cast<const char*>(addr);
+
+  const CacheHeader& h = *reinterpret_cast<const CacheHeader*>(p);
+  if (std::memcmp(h.magic, k_pdbcache_magic, 8) != 0
+      || h.version != k_pdbcache_version
+      || h.record_size != std::int32_t(sizeof(AtomRecord))
+      || h.source_size != size || h.source_mtime != mtime
+      || h.n_model < 0 || h.n_chain < 0 || h.n_residue < 0 || h.n_atom < 0
+      || h.n_model > std::int64_t(map_size) || h.n_chain > std::int64_t(map_size)
+      || h.n_residue > std::int64_t(map_size) || h.n_atom > std::int64_t(map_size)
+      || cache_size(h) != std::int64_t(map_size))
+  {
+    munmap(addr, map_size);
+    return 1;
+  }
+  const char* payload = p + sizeof(CacheHeader);
+  std::uint64_t c = fnv1a(payload, map_size - sizeof(CacheHeader), header_checksum(h));
+  if (c != h.checksum)
+  {
+    munmap(addr, map_size);
+    return 1;
+  }
+
+  const ModelRecord* models = reinterpret_cast<const ModelRecord*>(payload);
+  const ChainRecord* chains = reinterpret_cast<const ChainRecord*>(models + h.n_model);
+  const ResidueRecord* residues = reinterpret_cast<const ResidueRecord*>(chains + h.n_chain);
+  const AtomRecord* atoms = reinterpret_cast<const AtomRecord*>(residues + h.n_residue);
+  const AtomRecord* beads = atoms + h.n_atom;
+
+  // Check that the counts in the records add up, before building any object.
+  bool consistent = true;
+  std::int64_t n_chain = 0, n_residue = 0, n_atom = 0;
+  for (std::int64_t i = 0; i < h.n_model; ++i) {
+    consistent = consistent && models[i].n_chain >= 0;
+    n_chain += models[i].n_chain;
+  }
+  for (std::int64_t i = 0; i < h.n_chain; ++i) {
+    consistent = consistent && chains[i].n_residue >= 0;
+    n_residue += chains[i].n_residue;
+  }
+  for (std::int64_t i = 0; i < h.n_residue; ++i) {
+    consistent = consistent && residues[i].n_atom >= 0;
+    n_atom += residues[i].n_atom;
+  }
+  if (!consistent || n_chain != h.n_chain || n_residue != h.n_residue || n_atom != h.n_atom)
+  {
+    munmap(addr, map_size);
+    return 1;
+  }
+
+  auto get_atom = [](const AtomRecord& r, Atom& a) {
+    a.coordinate_ = Vec3d(r.x, r.y, r.z);
+    a.occupancy_ = r.occupancy;
+    a.temperature_factor_ = r.temperature_factor;
+    a.record_name_ = RecordName::from_code(r.record_name);
+    a.atom_serial_ = r.atom_serial;
+    a.residue_serial_ = r.residue_serial;
+    a.atom_name_ = AtomName::from_code(r.atom_name);
+    a.residue_name_ = ResidueName::from_code(r.residue_name);
+    a.seg_ID_ = SegmentName::from_code(r.seg_ID);
+    a.element_ = ElementName::from_code(r.element);
+    a.charge_ = ChargeName::from_code(r.charge);
+    a.alt_loc_ = r.alt_loc;
+    a.chain_ID_ = r.chain_ID;
+    a.insert_code_ = r.insert_code;
+  };
+
+  // Objects are filled in place (after reserve()), so nothing is copied.
+  pdb.PDB_file_name_ = pdb_name;
+  pdb.v_models_.clear();
+  pdb.v_models_.reserve(h.n_model);
+  pdb.n_model_ = h.n_model;
+  for (std::int64_t i = 0; i < h.n_model; ++i) {
+    const ModelRecord& mr = models[i];
+    pdb.v_models_.emplace_back();
+    Model& m = pdb.v_models_.back();
+    m.model_serial_ = mr.model_serial;
+    m.n_chain_ = mr.n_chain;
+    m.v_chains_.reserve(mr.n_chain);
+    for (int j = 0; j < mr.n_chain; ++j, ++chains) {
+      m.v_chains_.emplace_back();
+      Chain& ch = m.v_chains_.back();
+      ch.chain_ID_ = chains->chain_ID;
+      ch.chain_type_ = ChainType(chains->chain_type);
+      ch.n_residue_ = chains->n_residue;
+      ch.v_residues_.reserve(chains->n_residue);
+      for (int k = 0; k < chains->n_residue; ++k, ++residues, beads += k_n_cg_bead) {
+        ch.v_residues_.emplace_back();
+        Residue& r = ch.v_residues_.back();
+        r.residue_name_ = CachedName::from_code(residues->residue_name).str();
+        r.short_name_ = CachedName::from_code(residues->short_name).str();
+        r.chain_ID_ = residues->chain_ID;
+        r.residue_serial_ = residues->residue_serial;
+        r.n_atom_ = residues->n_atom;
+        r.charge_ = residues->charge;
+        r.mass_ = residues->mass;
+        r.sasa_ = residues->sasa;
+        r.chain_type_ = ChainType(residues->chain_type);
+        r.terminus_flag_ = residues->terminus_flag;
+        r.v_atoms_.resize(residues->n_atom);
+        for (Atom& a : r.v_atoms_)
+          get_atom(*atoms++, a);
+        get_atom(beads[0], r.cg_C_alpha_);
+        get_atom(beads[1], r.cg_C_beta_);
+        get_atom(beads[2], r.cg_P_);
+        get_atom(beads[3], r.cg_S_);
+        get_atom(beads[4], r.cg_B_);
+      }
+    }
+  }
+  munmap(addr, map_size);
+  return 0;
+}
+
+}  // pinang
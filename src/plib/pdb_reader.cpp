@@ -0,0 +1,223 @@
+/*!
+  @file pdb_reader.cpp
+  @brief Define functions of class PDBReader and PDB field decoders.
+
+  The decoders follow the rules of formatted stream input, which was used to
+  read PDB fields before: leading white spaces are skipped, a field without
+  digits reads as 0, and string fields keep their first word only.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:46
+  @copyright GNU Public License V3.0
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "pdb_reader.hpp"
+
+namespace pinang {
+
+namespace {
+
+const std::size_t k_block_size = 1 << 20;  //!< Size of blocks read from file.
+
+//! @brief White space as in the "C" locale.
+inline bool is_space(char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+//! @brief Get the first word of a field.
+template <int N>
+inline FixedName<N> get_word(const char* s, int n)
+{
+  int i = 0;
+  while (i < n && is_space(s[i]))
+    ++i;
+  int j = i;
+  while (j < n && !is_space(s[j]))
+    ++j;
+  return FixedName<N>(s + i, j - i);
+}
+
+//! @brief Powers of ten which are exact in double.
+const double k_pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                          1e12, 1e13, 1e14, 1e15};
+
+}  // namespace
+
+int decode_pdb_int(const char* s, int n)
+{
+  int i = 0;
+  while (i < n && is_space(s[i]))
+    ++i;
+  bool neg = false;
+  if (i < n && (s[i] == '-' || s[i] == '+'))
+    neg = s[i++] == '-';
+  long long v = 0;
+  int n_digit = 0;
+  for (; i < n && is_digit(s[i]); ++i, ++n_digit)
+    v = v * 10 + (s[i] - '0');
+  if (n_digit == 0)
+    return 0;
+  return int(neg ? -v : v);
+}
+
+double decode_pdb_real(const char* s, int n)
+{
+  int i = 0;
+  while (i < n && is_space(s[i]))
+    ++i;
+  const int first = i;
+  bool neg = false;
+  if (i < n && (s[i] == '-' || s[i] == '+'))
+    neg = s[i++] == '-';
+  unsigned long long m = 0;
+  int n_digit = 0;
+  int n_frac = 0;
+  for (; i < n && is_digit(s[i]); ++i, ++n_digit)
+    m = m * 10 + (s[i] - '0');
+  if (i < n && s[i] == '.') {
+    for (++i; i < n && is_digit(s[i]); ++i, ++n_digit, ++n_frac)
+      m = m * 10 + (s[i] - '0');
+  }
+  bool has_exponent = i < n && (s[i] == 'e' || s[i] == 'E');
+  if (!has_exponent && n_digit <= 15) {
+    if (n_digit == 0)
+      return 0.0;
+    // both m and 10^n_frac are exact, so the quotient is correctly rounded;
+    double v = double(m) / k_pow10[n_frac];
+    return neg ? -v : v;
+  }
+
+  // exponents and long mantissas: the characters a number may contain are
+  // collected and have to be converted completely;
+  if (has_exponent) {
+    ++i;
+    if (i < n && (s[i] == '-' || s[i] == '+'))
+      ++i;
+    while (i < n && is_digit(s[i]))
+      ++i;
+  }
+  std::string t(s + first, i - first);
+  char* t_end = 0;
+  double v = std::strtod(t.c_str(), &t_end);
+  if (t_end == t.c_str() || *t_end != '\0')
+    return 0.0;
+  return v;
+}
+
+PDBRecord parse_pdb_line(const char* line, int len, Atom& a)
+{
+  char rec[80];
+  if (len > 80)
+    len = 80;
+  std::memcpy(rec, line, len);
+  std::memset(rec + len, ' ', 80 - len);
+
+  PDBRecord r = pdb_other;
+  if (std::memcmp(rec, "ATOM  ", 6) == 0)
+    r = pdb_atom;
+  else if (std::memcmp(rec, "HETATM", 6) == 0)
+    r = pdb_hetatm;
+  else if (std::memcmp(rec, "MODEL ", 6) == 0)
+    r = pdb_model;
+  else if (std::memcmp(rec, "TER   ", 6) == 0)
+    r = pdb_ter;
+  else if (std::memcmp(rec, "ENDMDL", 6) == 0)
+    r = pdb_endmdl;
+  else if (std::memcmp(rec, "END   ", 6) == 0)
+    r = pdb_end;
+  a.set_record_name(RecordName(rec, 6));
+
+  if (r == pdb_atom || r == pdb_hetatm) {
+    a.set_atom_serial(decode_pdb_int(rec + 6, 5));
+    a.set_atom_name(get_word<4>(rec + 12, 4));
+    a.set_alt_loc(rec[16]);
+    a.set_residue_name(get_word<3>(rec + 17, 3));
+    // a blank chain ID keeps the alt_loc character, as with stream input;
+    a.set_chain_ID(is_space(rec[21]) ? rec[16] : rec[21]);
+    a.set_residue_serial(decode_pdb_int(rec + 22, 4));
+    a.set_icode(rec[26]);
+    a.set_coordinate(decode_pdb_real(rec + 30, 8), decode_pdb_real(rec + 38, 8),
+                     decode_pdb_real(rec + 46, 8));
+    a.set_occupancy(decode_pdb_real(rec + 54, 6));
+    a.set_temperature_factor(decode_pdb_real(rec + 60, 6));
+    a.set_segment_ID(get_word<4>(rec + 72, 4));
+    a.set_element(get_word<2>(rec + 76, 2));
+    a.set_charge(get_word<2>(rec + 78, 2));
+  } else if (r == pdb_model) {
+    a.set_atom_serial(decode_pdb_int(rec + 10, 4));  // Actually this is the model index (serial);
+  }
+  return r;
+}
+
+PDBReader::PDBReader()
+{
+  begin_ = 0;
+  end_ = 0;
+  eof_ = false;
+}
+
+int PDBReader::open(const std::string& s)
+{
+  file_.open(s.c_str(), std::ios::binary);
+  if (!file_.is_open())
+  {
+    std::cout << " ~             PINANG :: pdb_reader.cpp        ~ " << "\n";
+    std::cerr << " ERROR: Cannot read file: " << s << "\n";
+    return 1;
+  }
+  buffer_.resize(k_block_size);
+  begin_ = 0;
+  end_ = 0;
+  eof_ = false;
+  return 0;
+}
+
+bool PDBReader::next_line(const char*& line, int& len)
+{
+  for (;;) {
+    const char* b = buffer_.data() + begin_;
+    const char* nl = static_cast<const char*>(std::memchr(b, '\n', end_ - begin_));
+    if (nl) {
+      line = b;
+      len = nl - b;
+      begin_ += len + 1;
+      return true;
+    }
+    if (eof_) {
+      if (begin_ == end_)
+        return false;
+      line = b;
+      len = end_ - begin_;
+      begin_ = end_;
+      return true;
+    }
+    // keep the incomplete line and read the next block;
+    std::size_t rest = end_ - begin_;
+    std::memmove(buffer_.data(), b, rest);
+    begin_ = 0;
+    end_ = rest;
+    if (end_ == buffer_.size())
+      buffer_.resize(2 * buffer_.size());
+    file_.read(buffer_.data() + end_, buffer_.size() - end_);
+    end_ += file_.gcount();
+    if (!file_)
+      eof_ = true;
+  }
+}
+
+bool PDBReader::read(Atom& a, PDBRecord& r)
+{
+  const char* line = 0;
+  int len = 0;
+  if (!is_open() || !next_line(line, len))
+    return false;
+  r = parse_pdb_line(line, len, a);
+  return true;
+}
+
+}  // pinang
@@ -9,8 +9,10 @@
   @copyright GNU Public License V3.0
 */
 
-
+#include <algorithm>
+#include <cmath>
 #include "residue.hpp"
+#include "neighbor_search.hpp"
 
 namespace pinang {
 
@@ -31,20 +33,33 @@ void Residue::set_residue_by_name(const std::string& s)
     exit(EXIT_SUCCESS);
   }
 
-  PhysicalProperty p;
   size_t sz = 3;
   residue_name_ = s;
   if (residue_name_.size() < sz)
   {
     residue_name_.resize(sz, ' ');
   }
-  short_name_ = p.get_short_name(s);
-  chain_type_ = p.get_chain_type(s);
-  mass_ = p.get_mass(s);
-  charge_ = p.get_charge(s);
+  const ResidueProperty* p = get_residue_property(s);
+  if (p) {
+    short_name_ = std::string(p->short_name, 2);
+    chain_type_ = p->chain_type;
+    mass_ = p->mass;
+    charge_ = p->charge;
+  } else {
+    // unknown residue: the PhysicalProperty getters print the warnings;
+    short_name_ = PhysicalProperty::get_short_name(s);
+    chain_type_ = PhysicalProperty::get_chain_type(s);
+    mass_ = PhysicalProperty::get_mass(s);
+    charge_ = PhysicalProperty::get_charge(s);
+  }
 }
 
 Atom& Residue::get_atom(int n)
+{
+  return const_cast<Atom&>(static_cast<const Residue&>(*this).get_atom(n));
+}
+
+const Atom& Residue::get_atom(int n) const
 {
   if (v_atoms_.empty())
   {
@@ -64,7 +79,7 @@ Atom& Residue::get_atom(int n)
 }
 
 
-int Residue::add_atom(const Atom& a)
+int Residue::add_atom(Atom&& a)
 {
   if (a.get_residue_serial() != residue_serial_ || a.get_chain_ID() != chain_ID_)
   {
@@ -74,33 +89,29 @@ int Residue::add_atom(const Atom& a)
     if (a.get_atom_name() == b.get_atom_name())
       return 0;
   }  // in case of NMR uncertain multi atoms
-  v_atoms_.push_back(a);
 
-  std::string an = a.get_atom_name();
-  if (an == "CA  ")
-  {
-    cg_C_alpha_ = a;
-  }
-  if (an == "CB  ")
-  {
-    cg_C_beta_ = a;
-  }
-  if (an == "C3' " || an == "S   " || an == "DS  ")
-  {
-    cg_S_ = a;
-  }
-  if (an == "P   " || an == "DP  ")
-  {
-    cg_P_ = a;
-  }
-  if (an == "N1  " || an == "B   " || an == "DB  ")
-  {
-    cg_B_ = a;
+  switch (a.get_atom_name().code()) {
+    case atom_code("CA  "):
+      cg_C_alpha_ = a;
+      break;
+    case atom_code("CB  "):
+      cg_C_beta_ = a;
+      break;
+    case atom_code("C3' "): case atom_code("S   "): case atom_code("DS  "):
+      cg_S_ = a;
+      break;
+    case atom_code("P   "): case atom_code("DP  "):
+      cg_P_ = a;
+      break;
+    case atom_code("N1  "): case atom_code("B   "): case atom_code("DB  "):
+      cg_B_ = a;
+      break;
   }
   if (a.get_record_name() == "HETATM" && a.get_element() != "H")
   {
     cg_C_alpha_ = a;
   }
+  v_atoms_.push_back(std::move(a));
   ++n_atom_;
   return 0;
 }
@@ -194,7 +205,7 @@ void Residue::self_check() const
 {
   for (const Atom& a : v_atoms_) {
     if (a.get_chain_ID() != chain_ID_ || a.get_residue_serial() != residue_serial_
-        || a.get_residue_name() != residue_name_)
+        || a.get_residue_name().str() != residue_name_)
     {
       std::cout << " ~               PINANG :: residues.hpp self_check()         ~ " << "\n";
       std::cerr << "ERROR: Inconsistent chain ID or residue index or residue type in Residue "
@@ -220,6 +231,7 @@ Residue::Residue()
   n_atom_ = 0;
   charge_ = 0.0;
   mass_ = 100.0;
+  sasa_ = 0.0;
   terminus_flag_ = 0;
 
   cg_C_alpha_.reset();
@@ -240,6 +252,7 @@ void Residue::reset()
   n_atom_ = 0;
   charge_ = 0.0;
   mass_ = 100.0;
+  sasa_ = 0.0;
   terminus_flag_ = 0;
 
   chain_type_ = none;
@@ -251,7 +264,7 @@ void Residue::reset()
 }
 
 
-std::ostream& operator<<(std::ostream& o, Residue& r)
+std::ostream& operator<<(std::ostream& o, const Residue& r)
 {
   int i = 0;
   int s = r.n_atom_;
@@ -311,4 +324,121 @@ double residue_ca_distance(const Residue& r1, const Residue& r2)
   return d;
 }
 
+namespace {
+// A little margin, so that pairs with residue_min_distance() just below the
+// cutoff are never lost by rounding.
+const double k_neighbor_cutoff_scale = 1.0 + 1e-9;
+}
+
+bool is_residue_contact(const Residue& r1, const Residue& r2, double c)
+{
+  if (r1.v_atoms_.empty() || r2.v_atoms_.empty())
+    return false;
+  // squared distances are compared first; sqrt is only taken near the cutoff,
+  // so that the result is the same as comparing atom_distance() with c;
+  const double c2 = c * c * k_neighbor_cutoff_scale;
+  // residue_min_distance() starts from the distance of the first atoms;
+  double f2 = (r1.v_atoms_[0].get_coordinate() - r2.v_atoms_[0].get_coordinate()).squared_norm();
+  if (f2 == 0)
+    return false;
+  if (f2 < c2 && std::sqrt(f2) < c)
+    return true;
+  for (const Atom& a1 : r1.v_atoms_) {
+    if (a1.get_element() == "H")
+      continue;
+    const Vec3d& v1 = a1.get_coordinate();
+    for (const Atom& a2 : r2.v_atoms_) {
+      if (a2.get_element() == "H")
+        continue;
+      f2 = (v1 - a2.get_coordinate()).squared_norm();
+      if (f2 < c2 && std::sqrt(f2) < c)
+        return f2 > 0;
+    }
+  }
+  return false;
+}
+
+void get_bounding_spheres(const std::vector<Residue>& r, std::vector<Vec3d>& centers,
+                          std::vector<double>& radii)
+{
+  centers.assign(r.size(), Vec3d());
+  radii.assign(r.size(), -1.0);
+  for (std::size_t i = 0; i < r.size(); ++i) {
+    if (r[i].v_atoms_.empty())
+      continue;
+    Vec3d ctr;
+    for (const Atom& a : r[i].v_atoms_)
+      ctr = ctr + a.get_coordinate();
+    ctr = ctr / double(r[i].v_atoms_.size());
+    double r2 = 0;
+    for (const Atom& a : r[i].v_atoms_)
+      r2 = std::max(r2, (a.get_coordinate() - ctr).squared_norm());
+    centers[i] = ctr;
+    radii[i] = std::sqrt(r2);
+  }
+}
+
+std::vector<std::pair<int, int> > get_residue_contacts(const std::vector<Residue>& r, double c,
+                                                      int min_sep)
+{
+  std::vector<std::pair<int, int> > contacts;
+  std::vector<Vec3d> centers;
+  std::vector<double> radii;
+  get_bounding_spheres(r, centers, radii);
+  double r_max = 0;
+  for (double a : radii)
+    r_max = std::max(r_max, a);
+
+  // two spheres overlap within c only if their centers are within c + 2 r_max;
+  CellList cells;
+  if (cells.build(centers, (c + 2 * r_max) * k_neighbor_cutoff_scale))
+    return contacts;
+  cells.for_each_pair([&](int i, int j, double d2) {
+      if (j - i < min_sep || radii[i] < 0 || radii[j] < 0)
+        return;
+      double d_max = (c + radii[i] + radii[j]) * k_neighbor_cutoff_scale;
+      if (d2 > d_max * d_max)
+        return;
+      if (is_residue_contact(r[i], r[j], c))
+        contacts.push_back(std::make_pair(i, j));
+    });
+  std::sort(contacts.begin(), contacts.end());
+  return contacts;
+}
+
+std::vector<std::pair<int, int> > get_residue_contacts(const std::vector<Residue>& r1,
+                                                      const std::vector<Residue>& r2, double c)
+{
+  std::vector<std::pair<int, int> > contacts;
+  std::vector<Vec3d> centers_1, centers_2;
+  std::vector<double> radii_1, radii_2;
+  get_bounding_spheres(r1, centers_1, radii_1);
+  get_bounding_spheres(r2, centers_2, radii_2);
+  double r_max_1 = 0, r_max_2 = 0;
+  for (double a : radii_1)
+    r_max_1 = std::max(r_max_1, a);
+  for (double a : radii_2)
+    r_max_2 = std::max(r_max_2, a);
+
+  CellList cells;
+  if (cells.build(centers_2, (c + r_max_1 + r_max_2) * k_neighbor_cutoff_scale))
+    return contacts;
+  for (int i = 0; i < int(r1.size()); ++i) {
+    if (radii_1[i] < 0)
+      continue;
+    std::size_t first = contacts.size();
+    cells.for_each_neighbor(centers_1[i], [&](int j, double d2) {
+        if (radii_2[j] < 0)
+          return;
+        double d_max = (c + radii_1[i] + radii_2[j]) * k_neighbor_cutoff_scale;
+        if (d2 > d_max * d_max)
+          return;
+        if (is_residue_contact(r1[i], r2[j], c))
+          contacts.push_back(std::make_pair(i, j));
+      });
+    std::sort(contacts.begin() + first, contacts.end());
+  }
+  return contacts;
+}
+
 }  // pinang
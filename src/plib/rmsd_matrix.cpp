@@ -0,0 +1,412 @@
+/*!
+  @file rmsd_matrix.cpp
+  @brief Define functions of class RmsdMatrix and the RMSD matrix computation.
+
+  Definitions of member functions of class RmsdMatrix, conversion between single
+  and half precision, and the tiled, multi-threaded computation of pairwise RMSD
+  between dcd frames.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:08
+  @copyright GNU Public License V3.0
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "rmsd_matrix.hpp"
+#include "geometry.hpp"
+#include "parallel_frames.hpp"
+
+namespace pinang {
+
+namespace {
+
+const char k_rmsdmat_magic[8] = {'P', 'N', 'R', 'M', 'S', 'D', 'M', 'X'};
+const std::int32_t k_rmsdmat_version = 1;
+const std::int64_t k_rmsdmat_header_size = 32;
+
+// IEEE 754 single -> half precision, rounding to nearest even.
+std::uint16_t float_to_half(float f)
+{
+  std::uint32_t x;
+  std::memcpy(&x, &f, 4);
+  std::uint32_t sign = (x >> 16) & 0x8000;
+  std::uint32_t exp_f = (x >> 23) & 0xff;
+  std::uint32_t mant = x & 0x7fffff;
+  int exp = (int)exp_f - 127 + 15;
+  if (exp_f == 0xff)
+    return sign | 0x7c00 | (mant ? 0x200 : 0);  // inf or nan;
+  if (exp >= 31)
+    return sign | 0x7c00;  // overflow;
+  if (exp <= 0) {  // subnormal;
+    if (exp < -10)
+      return sign;
+    mant |= 0x800000;
+    int shift = 14 - exp;
+    std::uint32_t h = mant >> shift;
+    std::uint32_t rem = mant & ((1u << shift) - 1);
+    std::uint32_t half = 1u << (shift - 1);
+    if (rem > half || (rem == half && (h & 1)))
+      ++h;
+    return sign | h;
+  }
+  std::uint32_t h = ((std::uint32_t)exp << 10) | (mant >> 13);
+  std::uint32_t rem = mant & 0x1fff;
+  if (rem > 0x1000 || (rem == 0x1000 && (h & 1)))
+    ++h;
+  return sign | h;
+}
+
+// IEEE 754 half -> single precision.
+float half_to_float(std::uint16_t h)
+{
+  std::uint32_t sign = (std::uint32_t)(h & 0x8000) << 16;
+  std::uint32_t exp = (h >> 10) & 0x1f;
+  std::uint32_t mant = h & 0x3ff;
+  std::uint32_t x;
+  if (exp == 0) {
+    if (mant == 0) {
+      x = sign;
+    } else {  // subnormal;
+      exp = 127 - 15 + 1;
+      while (!(mant & 0x400)) {
+        mant <<= 1;
+        --exp;
+      }
+      x = sign | (exp << 23) | ((mant & 0x3ff) << 13);
+    }
+  } else if (exp == 31) {
+    x = sign | 0x7f800000 | (mant << 13);
+  } else {
+    x = sign | ((exp - 15 + 127) << 23) | (mant << 13);
+  }
+  float f;
+  std::memcpy(&f, &x, 4);
+  return f;
+}
+
+}  // anonymous namespace
+
+RmsdMatrix::RmsdMatrix()
+{
+  n_ = 0;
+  value_size_ = 4;
+  frame_first_ = 0;
+  frame_stride_ = 1;
+  data_ = 0;
+  values_ = 0;
+  map_size_ = 0;
+  read_only_ = false;
+}
+
+std::int64_t RmsdMatrix::get_file_size() const
+{
+  return k_rmsdmat_header_size + (std::int64_t)n_ * (n_ - 1) / 2 * value_size_;
+}
+
+void RmsdMatrix::write_header()
+{
+  std::int64_t n = n_;
+  std::int32_t vs = value_size_;
+  std::int32_t ff = frame_first_;
+  std::int32_t fs = frame_stride_;
+  std::memcpy(data_, k_rmsdmat_magic, 8);
+  std::memcpy(data_ + 8, &k_rmsdmat_version, 4);
+  std::memcpy(data_ + 12, &vs, 4);
+  std::memcpy(data_ + 16, &n, 8);
+  std::memcpy(data_ + 24, &ff, 4);
+  std::memcpy(data_ + 28, &fs, 4);
+}
+
+int RmsdMatrix::create(int n, int value_size)
+{
+  close();
+  if (n < 0 || (value_size != 2 && value_size != 4))
+  {
+    std::cout << " ~             PINANG :: RMSD matrix        ~ " << "\n";
+    std::cerr << " ERROR: Wrong size of RMSD matrix! " << "\n";
+    return 1;
+  }
+  n_ = n;
+  value_size_ = value_size;
+  buffer_.assign(get_file_size(), 0);
+  data_ = &buffer_[0];
+  values_ = data_ + k_rmsdmat_header_size;
+  write_header();
+  return 0;
+}
+
+int RmsdMatrix::create(const std::string& s, int n, int value_size)
+{
+  close();
+  if (n < 0 || (value_size != 2 && value_size != 4))
+  {
+    std::cout << " ~             PINANG :: RMSD matrix        ~ " << "\n";
+    std::cerr << " ERROR: Wrong size of RMSD matrix! " << "\n";
+    return 1;
+  }
+  n_ = n;
+  value_size_ = value_size;
+  std::int64_t file_size = get_file_size();
+
+  int fd = ::open(s.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0 || ftruncate(fd, file_size) != 0)
+  {
+    std::cout << " ~             PINANG :: RMSD matrix        ~ " << "\n";
+    std::cerr << " ERROR: Cannot create RMSD matrix file: " << s << "\n";
+    if (fd >= 0)
+      ::close(fd);
+    n_ = 0;
+    return 1;
+  }
+  void* addr = mmap(0, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED)
+  {
+    std::cout << " ~             PINANG :: RMSD matrix        ~ " << "\n";
+    std::cerr << " ERROR: Cannot map RMSD matrix file: " << s << "\n";
+    n_ = 0;
+    return 1;
+  }
+  data_ = static_cast<char*>(addr);
+  values_ = data_ + k_rmsdmat_header_size;
+  map_size_ = file_size;
+  write_header();
+  return 0;
+}
+
+int RmsdMatrix::open(const std::string& s)
+{
+  close();
+  int fd = ::open(s.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    std::cout << " ~             PINANG :: RMSD matrix        ~ " << "\n";
+    std::cerr << " ERROR: Cannot read RMSD matrix file: " << s << "\n";
+    return 1;
+  }
+  char header[32];
+  std::int32_t version = 0, vs = 0, ff = 0, fs = 0;
+  std::int64_t n = -1;
+  if (pread(fd, header, 32, 0) == 32) {
+    std::memcpy(&version, header + 8, 4);
+    std::memcpy(&vs, header + 12, 4);
+    std::memcpy(&n, header + 16, 8);
+    std::memcpy(&ff, header + 24, 4);
+    std::memcpy(&fs, header + 28, 4);
+  }
+  n_ = n;
+  value_size_ = vs;
+  std::int64_t file_size = get_file_size();
+  if (std::memcmp(header, k_rmsdmat_magic, 8) != 0 || version != k_rmsdmat_version
+      || (vs != 2 && vs != 4) || n < 0 || lseek(fd, 0, SEEK_END) != file_size)
+  {
+    std::cout << " ~             PINANG :: RMSD matrix        ~ " << "\n";
+    std::cerr << " ERROR: Wrong RMSD matrix file: " << s << "\n";
+    ::close(fd);
+    close();
+    return 1;
+  }
+  void* addr = mmap(0, file_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED)
+  {
+    std::cout << " ~             PINANG :: RMSD matrix        ~ " << "\n";
+    std::cerr << " ERROR: Cannot map RMSD matrix file: " << s << "\n";
+    close();
+    return 1;
+  }
+  data_ = static_cast<char*>(addr);
+  values_ = data_ + k_rmsdmat_header_size;
+  map_size_ = file_size;
+  frame_first_ = ff;
+  frame_stride_ = fs;
+  read_only_ = true;
+  return 0;
+}
+
+int RmsdMatrix::write(const std::string& s) const
+{
+  std::ofstream out_file(s.c_str(), std::ofstream::binary);
+  if (!out_file.is_open() || data_ == 0)
+  {
+    std::cout << " ~             PINANG :: RMSD matrix        ~ " << "\n";
+    std::cerr << " ERROR: Cannot write RMSD matrix file: " << s << "\n";
+    return 1;
+  }
+  out_file.write(data_, get_file_size());
+  return out_file.good() ? 0 : 1;
+}
+
+void RmsdMatrix::close()
+{
+  if (map_size_ != 0)
+    munmap(data_, map_size_);
+  std::vector<char>().swap(buffer_);
+  n_ = 0;
+  value_size_ = 4;
+  frame_first_ = 0;
+  frame_stride_ = 1;
+  data_ = 0;
+  values_ = 0;
+  map_size_ = 0;
+  read_only_ = false;
+}
+
+void RmsdMatrix::set_frame_info(int first, int stride)
+{
+  frame_first_ = first;
+  frame_stride_ = stride;
+  if (data_ != 0 && !read_only_)
+    write_header();
+}
+
+double RmsdMatrix::get(int i, int j) const
+{
+  if (i == j)
+    return 0.0;
+  std::int64_t k = i < j ? get_index(i, j) : get_index(j, i);
+  if (value_size_ == 2) {
+    std::uint16_t h;
+    std::memcpy(&h, values_ + 2 * k, 2);
+    return half_to_float(h);
+  }
+  float f;
+  std::memcpy(&f, values_ + 4 * k, 4);
+  return f;
+}
+
+void RmsdMatrix::set(int i, int j, double d)
+{
+  if (i == j || read_only_)
+    return;
+  std::int64_t k = i < j ? get_index(i, j) : get_index(j, i);
+  float f = d;
+  if (value_size_ == 2) {
+    std::uint16_t h = float_to_half(f);
+    std::memcpy(values_ + 2 * k, &h, 2);
+  } else {
+    std::memcpy(values_ + 4 * k, &f, 4);
+  }
+}
+
+int CenteredFrames::load(const DcdMappedReader& dcd, const Selection& sel,
+                         int n_thread, int tile)
+{
+  const int n = dcd.get_range_size();
+  const int m = sel.get_size();
+  if (m == 0 || tile <= 0)
+  {
+    std::cout << " ~             PINANG :: RMSD matrix        ~ " << "\n";
+    std::cerr << " ERROR: Empty selection or wrong tile size! " << "\n";
+    return 1;
+  }
+  for (int i = 0; i < m; ++i)
+    if (sel.get_selection(i) >= dcd.get_subset_size())
+    {
+      std::cout << " ~             PINANG :: RMSD matrix        ~ " << "\n";
+      std::cerr << " ERROR: Atom index out of range in selection! " << "\n";
+      return 1;
+    }
+
+  n_frame_ = n;
+  n_atom_ = m;
+  tile_ = tile;
+  const int n_tile = (n + tile - 1) / tile;
+  tiles_.assign(n_tile, CoordinateArray<float>());
+  for (int b = 0; b < n_tile; ++b)
+    tiles_[b].resize(std::min(tile, n - b * tile) * m);
+  g_.assign(n, 0.0);
+  return parallel_for_frames(dcd, n_thread, [&](int, int k, Conformation& conf) {
+      CoordinateView<double> v = conf.get_view();
+      const int s = v.get_stride();
+      double cx = 0, cy = 0, cz = 0;
+      for (int i = 0; i < m; ++i) {
+        int a = sel.get_selection(i) * s;
+        cx += v.x()[a];
+        cy += v.y()[a];
+        cz += v.z()[a];
+      }
+      cx /= m;
+      cy /= m;
+      cz /= m;
+      CoordinateArray<float>& f = tiles_[k / tile];
+      const int offset = (k % tile) * m;
+      double gk = 0;
+      for (int i = 0; i < m; ++i) {
+        int a = sel.get_selection(i) * s;
+        float x = v.x()[a] - cx;
+        float y = v.y()[a] - cy;
+        float z = v.z()[a] - cz;
+        f.x()[offset + i] = x;
+        f.y()[offset + i] = y;
+        f.z()[offset + i] = z;
+        gk += (double)x * x + (double)y * y + (double)z * z;
+      }
+      g_[k] = gk;
+    });
+}
+
+double CenteredFrames::get_rmsd(int i, int j) const
+{
+  if (i == j)
+    return 0.0;
+  double s[9];
+  get_inner_product(get_frame(i), get_frame(j), s);
+  return get_qcp_rmsd(s, g_[i], g_[j], n_atom_);
+}
+
+int compute_rmsd_matrix(const CenteredFrames& frames, int n_thread, RmsdMatrix& mat)
+{
+  const int n = frames.get_size();
+  const int tile = frames.get_tile_size();
+  if (mat.get_size() != n)
+  {
+    std::cout << " ~             PINANG :: RMSD matrix        ~ " << "\n";
+    std::cerr << " ERROR: Inconsistent size of RMSD matrix! " << "\n";
+    return 1;
+  }
+  const int n_tile = (n + tile - 1) / tile;
+  for (int bi = 0; bi < n_tile; ++bi) {
+    // Tiles of one row are written to neighbouring rows of the matrix.
+    parallel_for(n_tile - bi, n_thread, [&](int, int t) {
+        const int bj = bi + t;
+        const int i_end = std::min(n, (bi + 1) * tile);
+        const int j_end = std::min(n, (bj + 1) * tile);
+        for (int i = bi * tile; i < i_end; ++i)
+          for (int j = (bi == bj ? i + 1 : bj * tile); j < j_end; ++j)
+            mat.set(i, j, frames.get_rmsd(i, j));
+      });
+  }
+  return 0;
+}
+
+int compute_rmsd_matrix(const DcdMappedReader& dcd, const Selection& sel,
+                        int n_thread, RmsdMatrix& mat, int tile)
+{
+  const int n = dcd.get_range_size();
+  if (n == 0)
+  {
+    std::cout << " ~             PINANG :: RMSD matrix        ~ " << "\n";
+    std::cerr << " ERROR: No frames in the frame range! " << "\n";
+    return 1;
+  }
+  if (mat.get_size() != n)
+  {
+    std::cout << " ~             PINANG :: RMSD matrix        ~ " << "\n";
+    std::cerr << " ERROR: Inconsistent size of RMSD matrix! " << "\n";
+    return 1;
+  }
+  mat.set_frame_info(dcd.get_range_frame(0),
+                     n > 1 ? dcd.get_range_frame(1) - dcd.get_range_frame(0) : 1);
+  CenteredFrames frames;
+  if (frames.load(dcd, sel, n_thread, tile))
+    return 1;
+  return compute_rmsd_matrix(frames, n_thread, mat);
+}
+
+}  // pinang
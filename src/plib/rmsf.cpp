@@ -0,0 +1,170 @@
+/*!
+  @file rmsf.cpp
+  @brief Define functions of class PositionAccumulator and RMSF calculation.
+
+  Definitions of member functions of class PositionAccumulator, and the
+  iterative alignment of trajectory frames to their average structure.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:14
+  @copyright GNU Public License V3.0
+*/
+
+#include <algorithm>
+#include <cmath>
+#include "rmsf.hpp"
+#include "geometry.hpp"
+#include "parallel_frames.hpp"
+
+namespace pinang {
+
+void PositionAccumulator::reset(int n)
+{
+  n_frame_ = 0;
+  n_atom_ = n;
+  mean_.assign(3 * n, 0.0);
+  m2_.assign(n, 0.0);
+}
+
+void PositionAccumulator::add(const CoordinateView<double>& v)
+{
+  ++n_frame_;
+  const double r = 1.0 / n_frame_;
+  const int s = v.get_stride();
+  for (int i = 0; i < n_atom_; ++i) {
+    double* m = &mean_[3 * i];
+    double dx = v.x()[i * s] - m[0];
+    double dy = v.y()[i * s] - m[1];
+    double dz = v.z()[i * s] - m[2];
+    m[0] += dx * r;
+    m[1] += dy * r;
+    m[2] += dz * r;
+    m2_[i] += dx * (v.x()[i * s] - m[0]) + dy * (v.y()[i * s] - m[1])
+        + dz * (v.z()[i * s] - m[2]);
+  }
+}
+
+void PositionAccumulator::merge(const PositionAccumulator& o)
+{
+  if (o.n_frame_ == 0)
+    return;
+  if (n_frame_ == 0) {
+    *this = o;
+    return;
+  }
+  const double na = n_frame_;
+  const double nb = o.n_frame_;
+  const double n = na + nb;
+  for (int i = 0; i < n_atom_; ++i) {
+    double d2 = 0;
+    for (int c = 0; c < 3; ++c) {
+      double d = o.mean_[3 * i + c] - mean_[3 * i + c];
+      mean_[3 * i + c] += d * nb / n;
+      d2 += d * d;
+    }
+    m2_[i] += o.m2_[i] + d2 * na * nb / n;
+  }
+  n_frame_ += o.n_frame_;
+}
+
+CoordinateArray<double> PositionAccumulator::get_mean() const
+{
+  CoordinateArray<double> a(n_atom_);
+  for (int i = 0; i < n_atom_; ++i)
+    a.set_coordinate(i, get_mean(i));
+  return a;
+}
+
+double PositionAccumulator::get_rmsf(int i) const
+{
+  return n_frame_ > 0 ? sqrt(m2_[i] / n_frame_) : 0.0;
+}
+
+int compute_rmsf(const DcdMappedReader& dcd, const Selection& sel_fit,
+                 const Selection& sel_rmsf, int n_thread, PositionAccumulator& result,
+                 int max_iter, double tol)
+{
+  const int n = dcd.get_range_size();
+  const int n_fit = sel_fit.get_size();
+  const int n_rmsf = sel_rmsf.get_size();
+  if (n == 0 || n_fit < 3 || n_rmsf == 0)
+  {
+    std::cout << " ~             PINANG :: RMSF               ~ " << "\n";
+    std::cerr << " ERROR: No frames, or too few atoms for fitting! " << "\n";
+    return -1;
+  }
+  if (max_iter < 1)
+  {
+    std::cout << " ~             PINANG :: RMSF               ~ " << "\n";
+    std::cerr << " ERROR: Maximum number of iterations must be at least 1! " << "\n";
+    return -1;
+  }
+
+  Conformation conf;
+  if (dcd.read_frame(dcd.get_range_frame(0), conf))
+    return -1;
+  CoordinateArray<double> ref;
+  ref.assign(conf.get_view(), sel_fit);
+
+  n_thread = get_thread_number(n_thread);
+  const int n_chunk = std::min(n, 4 * n_thread);
+  std::vector<PositionAccumulator> acc_fit(n_chunk);
+  std::vector<PositionAccumulator> acc_rmsf(n_chunk);
+  std::vector<int> status(n_chunk);
+
+  int iter = 0;
+  bool converged = false;
+  while (iter < max_iter) {
+    ++iter;
+    parallel_for(n_chunk, n_thread, [&](int, int c) {
+        Conformation frame;
+        CoordinateArray<double> fit, rmsf;
+        Transform t;
+        double d;
+        acc_fit[c].reset(n_fit);
+        acc_rmsf[c].reset(n_rmsf);
+        status[c] = 0;
+        const int k_end = (long long)n * (c + 1) / n_chunk;
+        for (int k = (long long)n * c / n_chunk; k < k_end; ++k) {
+          if (dcd.read_frame(dcd.get_range_frame(k), frame)) {
+            status[c] = 1;
+            return;
+          }
+          fit.assign(frame.get_view(), sel_fit);
+          rmsf.assign(frame.get_view(), sel_rmsf);
+          if (find_transform(fit.get_view(), ref.get_view(), t, d) == 0) {
+            apply_transform(fit, t);
+            apply_transform(rmsf, t);
+          }
+          acc_fit[c].add(fit.get_view());
+          acc_rmsf[c].add(rmsf.get_view());
+        }
+      });
+    for (int c = 0; c < n_chunk; ++c)
+      if (status[c])
+        return -1;
+    for (int c = 1; c < n_chunk; ++c) {
+      acc_fit[0].merge(acc_fit[c]);
+      acc_rmsf[0].merge(acc_rmsf[c]);
+    }
+
+    CoordinateArray<double> new_ref = acc_fit[0].get_mean();
+    double shift = get_rmsd(ref.get_view(), new_ref.get_view());
+    ref = new_ref;
+    if (shift < tol)
+    {
+      converged = true;
+      break;
+    }
+  }
+  if (!converged)
+  {
+    std::cout << " ~             PINANG :: RMSF               ~ " << "\n";
+    std::cout << " Warning: Average structure not converged after "
+              << max_iter << " iterations. " << "\n";
+  }
+  result = acc_rmsf[0];
+  return iter;
+}
+
+}  // pinang
@@ -0,0 +1,262 @@
+/*!
+  @file sasa.cpp
+  @brief Define functions of class ShrakeRupley and radii tables.
+
+  Neighbours of an atom are sorted by distance and copied into padded arrays,
+  so that the occlusion test of a sphere point runs over blocks of four
+  neighbours without branches, which the compiler can vectorize.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:42
+  @copyright GNU Public License V3.0
+*/
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <iostream>
+#include "sasa.hpp"
+#include "model.hpp"
+#include "neighbor_search.hpp"
+#include "parallel_frames.hpp"
+
+namespace pinang {
+
+namespace {
+
+//! @brief Remove spaces from both ends of a string.
+std::string trim(const std::string& s)
+{
+  std::string::size_type b = s.find_first_not_of(' ');
+  if (b == std::string::npos)
+    return "";
+  return s.substr(b, s.find_last_not_of(' ') - b + 1);
+}
+
+//! @brief Get element of an atom, guessed from the atom name if not given.
+std::string get_atom_element(const Atom& a)
+{
+  std::string e = trim(a.get_element());
+  if (e.empty()) {
+    // first letter of the atom name, skipping digits (e.g. "1HB");
+    for (char c : a.get_atom_name().str())
+      if (std::isalpha(c)) {
+        e = std::string(1, c);
+        break;
+      }
+  }
+  for (char& c : e)
+    c = std::toupper(c);
+  return e;
+}
+
+//! @brief Neighbours of one atom, padded to a multiple of 4.
+struct SasaScratch
+{
+  std::vector<std::pair<double, int> > nb;
+  std::vector<double> x, y, z, r2;
+};
+
+}  // namespace
+
+double get_vdw_radius(const std::string& element)
+{
+  std::string e = trim(element);
+  for (char& c : e)
+    c = std::toupper(c);
+  if (e == "H") return 1.20;
+  if (e == "C") return 1.70;
+  if (e == "N") return 1.55;
+  if (e == "O") return 1.52;
+  if (e == "S") return 1.80;
+  if (e == "P") return 1.80;
+  if (e == "F") return 1.47;
+  if (e == "CL") return 1.75;
+  if (e == "BR") return 1.85;
+  if (e == "I") return 1.98;
+  if (e == "SE") return 1.90;
+  if (e == "NA") return 2.27;
+  if (e == "K") return 2.75;
+  if (e == "MG") return 1.73;
+  return 1.80;
+}
+
+double get_atom_radius(const Atom& a)
+{
+  return get_vdw_radius(get_atom_element(a));
+}
+
+double get_cg_radius(const std::string& name)
+{
+  std::string n = trim(name);
+  if (n == "CA") return 3.0;
+  if (n == "DP" || n == "P") return 2.1;
+  if (n == "DS" || n == "S") return 2.9;
+  if (n == "DB" || n == "B") return 3.0;
+  return 3.0;
+}
+
+ShrakeRupley::ShrakeRupley()
+{
+  probe_ = 1.4;
+  set_point_number(960);
+}
+
+ShrakeRupley::ShrakeRupley(int n_points, double probe)
+{
+  probe_ = probe;
+  set_point_number(n_points);
+}
+
+void ShrakeRupley::set_point_number(int n)
+{
+  if (n < 1)
+    n = 1;
+  ux_.resize(n);
+  uy_.resize(n);
+  uz_.resize(n);
+  // golden spiral: equal-area bands in z, golden angle in azimuth;
+  const double golden_angle = k_pi * (3.0 - std::sqrt(5.0));
+  for (int k = 0; k < n; ++k) {
+    double z = 1.0 - (2.0 * k + 1.0) / n;
+    double r = std::sqrt(1.0 - z * z);
+    double phi = golden_angle * k;
+    ux_[k] = r * std::cos(phi);
+    uy_[k] = r * std::sin(phi);
+    uz_[k] = z;
+  }
+}
+
+int ShrakeRupley::compute(const std::vector<Vec3d>& coors, const std::vector<double>& radii,
+                          std::vector<double>& area, int n_thread) const
+{
+  const int n = coors.size();
+  if (int(radii.size()) != n)
+  {
+    std::cout << " ~             PINANG :: sasa.cpp        ~ " << "\n";
+    std::cerr << " ERROR: Numbers of coordinates and radii don't match! " << "\n";
+    return 1;
+  }
+  area.assign(n, 0.0);
+  if (n == 0)
+    return 0;
+
+  double r_max = 0;
+  for (double r : radii)
+    r_max = std::max(r_max, r + probe_);
+  CellList cells;
+  if (cells.build(coors, 2 * r_max))
+    return 1;
+
+  const int n_points = get_point_number();
+  std::vector<SasaScratch> scratch(get_thread_number(n_thread));
+  parallel_for(n, n_thread, [&](int t, int i) {
+      const double r_i = radii[i] + probe_;
+      SasaScratch& s = scratch[t];
+      s.nb.clear();
+      cells.for_each_neighbor(coors[i], [&](int j, double d2) {
+          double r_ij = r_i + radii[j] + probe_;
+          if (j != i && d2 < r_ij * r_ij)
+            s.nb.push_back(std::make_pair(d2, j));
+        });
+      // close neighbours bury more points;
+      std::sort(s.nb.begin(), s.nb.end());
+      const int n_nb = s.nb.size();
+      const int n_pad = (n_nb + 3) / 4 * 4;
+      s.x.assign(n_pad, 1e100);
+      s.y.assign(n_pad, 1e100);
+      s.z.assign(n_pad, 1e100);
+      s.r2.assign(n_pad, 0.0);
+      for (int m = 0; m < n_nb; ++m) {
+        int j = s.nb[m].second;
+        double r_j = radii[j] + probe_;
+        s.x[m] = coors[j].x();
+        s.y[m] = coors[j].y();
+        s.z[m] = coors[j].z();
+        s.r2[m] = r_j * r_j;
+      }
+
+      const double cx = coors[i].x(), cy = coors[i].y(), cz = coors[i].z();
+      int n_exposed = 0;
+      int m_last = 0;
+      for (int k = 0; k < n_points; ++k) {
+        const double px = cx + r_i * ux_[k];
+        const double py = cy + r_i * uy_[k];
+        const double pz = cz + r_i * uz_[k];
+        if (n_nb > 0) {
+          double dx = s.x[m_last] - px;
+          double dy = s.y[m_last] - py;
+          double dz = s.z[m_last] - pz;
+          if (dx * dx + dy * dy + dz * dz < s.r2[m_last])
+            continue;
+        }
+        int buried = 0;
+        for (int m = 0; m < n_pad; m += 4) {
+          int mask = 0;
+          for (int l = 0; l < 4; ++l) {
+            double dx = s.x[m + l] - px;
+            double dy = s.y[m + l] - py;
+            double dz = s.z[m + l] - pz;
+            mask |= int(dx * dx + dy * dy + dz * dz < s.r2[m + l]) << l;
+          }
+          if (mask) {
+            m_last = m + __builtin_ctz(mask);
+            buried = 1;
+            break;
+          }
+        }
+        n_exposed += 1 - buried;
+      }
+      area[i] = 4.0 * k_pi * r_i * r_i * n_exposed / n_points;
+    });
+  return 0;
+}
+
+int Model::compute_sasa(const ShrakeRupley& sr, std::vector<double>& atom_area, int cg_flag,
+                        int n_thread)
+{
+  // atoms of water and hydrogens (all-atom models) are not included;
+  std::vector<Vec3d> coors;
+  std::vector<double> radii;
+  std::vector<int> index;
+  int n_atom = 0;
+  for (int i = 0; i < n_chain_; ++i) {
+    Chain& c = v_chains_[i];
+    bool is_water = c.get_chain_type() == water;
+    for (int j = 0; j < c.get_size(); ++j) {
+      Residue& r = c.get_residue(j);
+      for (int k = 0; k < r.get_size(); ++k, ++n_atom) {
+        const Atom& a = r.get_atom(k);
+        if (is_water)
+          continue;
+        if (!cg_flag && get_atom_element(a) == "H")
+          continue;
+        coors.push_back(a.get_coordinate());
+        radii.push_back(cg_flag ? get_cg_radius(a.get_atom_name()) : get_atom_radius(a));
+        index.push_back(n_atom);
+      }
+    }
+  }
+
+  std::vector<double> area;
+  if (sr.compute(coors, radii, area, n_thread))
+    return 1;
+  atom_area.assign(n_atom, 0.0);
+  for (std::size_t m = 0; m < index.size(); ++m)
+    atom_area[index[m]] = area[m];
+
+  n_atom = 0;
+  for (int i = 0; i < n_chain_; ++i) {
+    Chain& c = v_chains_[i];
+    for (int j = 0; j < c.get_size(); ++j) {
+      Residue& r = c.get_residue(j);
+      double sasa = 0;
+      for (int k = 0; k < r.get_size(); ++k)
+        sasa += atom_area[n_atom++];
+      r.set_sasa(sasa);
+    }
+  }
+  return 0;
+}
+
+}  // pinang
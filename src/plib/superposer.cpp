@@ -0,0 +1,50 @@
+/*!
+  @file superposer.cpp
+  @brief Define functions of class Superposer.
+
+  Definitions of member functions of class Superposer, superimposing frames onto
+  a cached reference with the QCP method.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:20
+  @copyright GNU Public License V3.0
+*/
+
+#include "geometry.hpp"
+
+namespace pinang {
+
+void Superposer::set_reference(const CoordinateView<double>& v)
+{
+  ref_.assign(v);
+  ctr_ = get_centroid(v);
+  translate(ref_, -ctr_);
+  g_ = 0;
+  for (int i = 0; i < ref_.get_size(); ++i)
+    g_ += ref_.get_coordinate(i).squared_norm();
+}
+
+template <typename T>
+int Superposer::superimpose(const CoordinateView<T>& v, Transform& t, double& rmsd) const
+{
+  double s[9], g;
+  Vec3d ctr;
+  get_inner_product(v, ref_.get_view(), s, g, ctr);
+  return get_qcp_transform(s, g, g_, v.get_size(), ctr, ctr_, t, rmsd);
+}
+
+template <typename T>
+int Superposer::superimpose(int n, const CoordinateView<T>* v, Transform* t, double* rmsd) const
+{
+  int n_fail = 0;
+  for (int i = 0; i < n; ++i)
+    n_fail += superimpose(v[i], t[i], rmsd[i]);
+  return n_fail;
+}
+
+template int Superposer::superimpose(const CoordinateView<float>&, Transform&, double&) const;
+template int Superposer::superimpose(const CoordinateView<double>&, Transform&, double&) const;
+template int Superposer::superimpose(int, const CoordinateView<float>*, Transform*, double*) const;
+template int Superposer::superimpose(int, const CoordinateView<double>*, Transform*, double*) const;
+
+}  // pinang
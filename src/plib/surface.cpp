@@ -0,0 +1,212 @@
+/*!
+  @file surface.cpp
+  @brief Define functions of class SurfaceGrid.
+
+  Solvent points are found with a cell list of the atoms (cutoff = tip size),
+  so that every grid point checks at most 27 cells and stops at the first atom
+  within the tip size.  The distance transform is the separable algorithm of
+  Felzenszwalb and Huttenlocher, run along z, y and x, carrying the index of
+  the nearest non-solvent point.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:39
+  @copyright GNU Public License V3.0
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include "surface.hpp"
+#include "parallel_frames.hpp"
+
+namespace pinang {
+
+namespace {
+
+//! @brief 1D squared distance transform of f (positions with f < 0 are empty).
+//!
+//! d[q] = min_p (q - p)^2 + f[p], arg[q] = argmin p (-1 if the line is empty).
+void distance_transform_1d(const std::vector<double>& f, int n, std::vector<double>& d,
+                           std::vector<int>& arg, std::vector<int>& v, std::vector<double>& z)
+{
+  const double inf = std::numeric_limits<double>::infinity();
+  int k = -1;
+  for (int q = 0; q < n; ++q) {
+    if (f[q] < 0)
+      continue;
+    double s = -inf;
+    while (k >= 0) {
+      int p = v[k];
+      s = ((f[q] + double(q) * q) - (f[p] + double(p) * p)) / (2.0 * (q - p));
+      if (s > z[k])
+        break;
+      --k;
+    }
+    ++k;
+    v[k] = q;
+    z[k] = k == 0 ? -inf : s;
+  }
+  if (k < 0) {
+    for (int q = 0; q < n; ++q) {
+      d[q] = -1;
+      arg[q] = -1;
+    }
+    return;
+  }
+  z[k + 1] = inf;
+  for (int q = 0, m = 0; q < n; ++q) {
+    while (z[m + 1] < q)
+      ++m;
+    arg[q] = v[m];
+    d[q] = double(q - v[m]) * (q - v[m]) + f[v[m]];
+  }
+}
+
+}  // namespace
+
+SurfaceGrid::SurfaceGrid()
+{
+  grid_size_ = 2.0;
+  tip_size_ = 4.0;
+  padding_ = 8.0;
+  use_edt_ = false;
+}
+
+SurfaceGrid::SurfaceGrid(double grid_size, double tip_size, double padding)
+{
+  grid_size_ = grid_size;
+  tip_size_ = tip_size;
+  padding_ = padding;
+  use_edt_ = false;
+}
+
+int SurfaceGrid::get_solvent_number() const
+{
+  return int(std::count(solvent_.begin(), solvent_.end(), 1));
+}
+
+Vec3d SurfaceGrid::get_point_coordinate(int m) const
+{
+  int iz = m % get_grid_number(2);
+  int iy = (m / get_grid_number(2)) % get_grid_number(1);
+  int ix = m / (get_grid_number(2) * get_grid_number(1));
+  return Vec3d(grid_real_[0][ix], grid_real_[1][iy], grid_real_[2][iz]);
+}
+
+int SurfaceGrid::compute(const std::vector<Vec3d>& coors, int n_thread)
+{
+  if (coors.empty() || !(grid_size_ > 0) || !(tip_size_ > 0))
+  {
+    std::cout << " ~             PINANG :: surface.cpp        ~ " << "\n";
+    std::cerr << " ERROR: No atoms or non-positive grid / tip size! " << "\n";
+    return 1;
+  }
+
+  // grid planes, from (min - padding) to (max + padding);
+  double lo[3], hi[3];
+  for (int d = 0; d < 3; ++d)
+    lo[d] = hi[d] = coors[0][d];
+  for (const Vec3d& v : coors) {
+    for (int d = 0; d < 3; ++d) {
+      lo[d] = std::min(lo[d], v[d]);
+      hi[d] = std::max(hi[d], v[d]);
+    }
+  }
+  for (int d = 0; d < 3; ++d) {
+    grid_real_[d].clear();
+    double x_max = hi[d] + padding_;
+    for (double x = lo[d] - padding_; x <= x_max; x += grid_size_)
+      grid_real_[d].push_back(x);
+  }
+  const int n_x = get_grid_number(0);
+  const int n_yz = get_grid_number(1) * get_grid_number(2);
+
+  if (cells_.build(coors, tip_size_))
+    return 1;
+
+  // solvent points: no atom within the tip size;
+  solvent_.assign(n_x * n_yz, 0);
+  parallel_for(n_x, n_thread, [&](int, int ix) {
+      for (int m = ix * n_yz; m < (ix + 1) * n_yz; ++m)
+        solvent_[m] = cells_.has_neighbor(get_point_coordinate(m)) ? 0 : 1;
+    });
+
+  // atom assigned to each solvent point;
+  std::vector<int> nearest(solvent_.size(), -1);
+  if (use_edt_) {
+    std::vector<int> feature;
+    distance_transform(n_thread, feature);
+    // nearest atom of every non-solvent point used as a feature;
+    std::vector<int> used;
+    std::vector<int> atom_of(solvent_.size(), -1);
+    for (std::size_t m = 0; m < solvent_.size(); ++m)
+      if (solvent_[m] && feature[m] >= 0 && atom_of[feature[m]] == -1) {
+        atom_of[feature[m]] = -2;
+        used.push_back(feature[m]);
+      }
+    parallel_for(used.size(), n_thread, [&](int, int k) {
+        double d2_k = 0;
+        atom_of[used[k]] = cells_.find_nearest(get_point_coordinate(used[k]), d2_k);
+      });
+    for (std::size_t m = 0; m < solvent_.size(); ++m)
+      if (solvent_[m] && feature[m] >= 0)
+        nearest[m] = atom_of[feature[m]];
+  } else {
+    parallel_for(n_x, n_thread, [&](int, int ix) {
+        double d2_m = 0;
+        for (int m = ix * n_yz; m < (ix + 1) * n_yz; ++m)
+          if (solvent_[m])
+            nearest[m] = cells_.find_nearest(get_point_coordinate(m), d2_m);
+      });
+  }
+
+  surface_flag_.assign(coors.size(), 0);
+  for (std::size_t m = 0; m < solvent_.size(); ++m)
+    if (nearest[m] >= 0)
+      surface_flag_[nearest[m]] = 1;
+  return 0;
+}
+
+void SurfaceGrid::distance_transform(int n_thread, std::vector<int>& feature) const
+{
+  const int n[3] = {get_grid_number(0), get_grid_number(1), get_grid_number(2)};
+  const int stride[3] = {n[1] * n[2], n[2], 1};
+  const int n_max = std::max(n[0], std::max(n[1], n[2]));
+
+  // squared distance (in grid units) to the nearest non-solvent point so far;
+  // -1 means no such point found yet;
+  std::vector<double> dist(solvent_.size());
+  feature.resize(solvent_.size());
+  for (std::size_t m = 0; m < solvent_.size(); ++m) {
+    dist[m] = solvent_[m] ? -1 : 0;
+    feature[m] = solvent_[m] ? -1 : int(m);
+  }
+
+  int n_thread_used = get_thread_number(n_thread);
+  std::vector<std::vector<double> > f(n_thread_used, std::vector<double>(n_max));
+  std::vector<std::vector<double> > d(n_thread_used, std::vector<double>(n_max));
+  std::vector<std::vector<double> > z(n_thread_used, std::vector<double>(n_max + 1));
+  std::vector<std::vector<int> > arg(n_thread_used, std::vector<int>(n_max));
+  std::vector<std::vector<int> > v(n_thread_used, std::vector<int>(n_max));
+  std::vector<std::vector<int> > feat(n_thread_used, std::vector<int>(n_max));
+
+  // passes along z, y, x; each line is independent;
+  for (int dim = 2; dim >= 0; --dim) {
+    const int a = dim == 0 ? 1 : 0;
+    const int b = dim == 2 ? 1 : 2;
+    parallel_for(n[a] * n[b], n_thread_used, [&](int t, int line) {
+        int first = (line / n[b]) * stride[a] + (line % n[b]) * stride[b];
+        for (int q = 0; q < n[dim]; ++q) {
+          f[t][q] = dist[first + q * stride[dim]];
+          feat[t][q] = feature[first + q * stride[dim]];
+        }
+        distance_transform_1d(f[t], n[dim], d[t], arg[t], v[t], z[t]);
+        for (int q = 0; q < n[dim]; ++q) {
+          dist[first + q * stride[dim]] = d[t][q];
+          feature[first + q * stride[dim]] = arg[t][q] < 0 ? -1 : feat[t][arg[t][q]];
+        }
+      });
+  }
+}
+
+}  // pinang
@@ -0,0 +1,396 @@
+/*!
+  @file system.cpp
+  @brief Conversion between System and Model, and reading System from PDB.
+
+  A Model is flattened chain by chain, residue by residue; going back, the
+  Residue and Chain objects are filled in the same order as the PDB reader
+  does, so that CG beads and terminus flags are set up by the same code.
+  read_pdb() groups the records of a PDB file as PDB::PDB() does, but writes
+  the atoms straight into the columns.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 13:55
+  @copyright GNU Public License V3.0
+*/
+
+#include "system.hpp"
+#include "pdb_reader.hpp"
+
+namespace pinang {
+
+int NameTable::intern(const std::string& s)
+{
+  std::unordered_map<std::string, int>::const_iterator it = ids_.find(s);
+  if (it != ids_.end())
+    return it->second;
+  int i = names_.size();
+  names_.push_back(s);
+  ids_.insert(std::make_pair(s, i));
+  return i;
+}
+
+Atom AtomView::to_atom() const
+{
+  Atom a;
+  a.set_record_name(get_record_name());
+  a.set_atom_serial(get_atom_serial());
+  a.set_atom_name(get_atom_name());
+  a.set_alt_loc(get_alt_loc());
+  a.set_residue_name(get_residue_name());
+  a.set_chain_ID(get_chain_ID());
+  a.set_residue_serial(get_residue_serial());
+  a.set_icode(get_icode());
+  a.set_coordinate(get_coordinate());
+  a.set_occupancy(get_occupancy());
+  a.set_temperature_factor(get_temperature_factor());
+  a.set_segment_ID(get_segment_ID());
+  a.set_element(get_element());
+  a.set_charge(get_charge());
+  return a;
+}
+
+System::System()
+{
+  reset();
+}
+
+System::System(const Model& mdl)
+{
+  set_model(mdl);
+}
+
+void System::reset()
+{
+  names_.reset();
+  model_serial_ = 0;
+
+  x_.clear();
+  y_.clear();
+  z_.clear();
+  atom_serial_.clear();
+  atom_name_.clear();
+  record_name_.clear();
+  alt_loc_.clear();
+  icode_.clear();
+  occupancy_.clear();
+  b_factor_.clear();
+  seg_ID_.clear();
+  element_.clear();
+  atom_charge_.clear();
+  atom_residue_.clear();
+  atom_chain_.clear();
+
+  residue_start_.assign(1, 0);
+  residue_name_.clear();
+  short_name_.clear();
+  residue_serial_.clear();
+  residue_chain_.clear();
+  terminus_flag_.clear();
+  residue_mass_.clear();
+  residue_charge_.clear();
+  sasa_.clear();
+
+  chain_start_.assign(1, 0);
+  chain_ID_.clear();
+  chain_type_.clear();
+}
+
+void System::set_model(const Model& mdl)
+{
+  reset();
+  model_serial_ = mdl.get_model_serial();
+
+  // count first, so that every column is allocated once;
+  int n_residue = 0, n_atom = 0;
+  for (int c = 0; c < mdl.get_size(); ++c) {
+    const Chain& chain = mdl.get_chain(c);
+    n_residue += chain.get_size();
+    for (int r = 0; r < chain.get_size(); ++r)
+      n_atom += chain.get_residue(r).get_size();
+  }
+  x_.reserve(n_atom);
+  y_.reserve(n_atom);
+  z_.reserve(n_atom);
+  atom_serial_.reserve(n_atom);
+  atom_name_.reserve(n_atom);
+  record_name_.reserve(n_atom);
+  alt_loc_.reserve(n_atom);
+  icode_.reserve(n_atom);
+  occupancy_.reserve(n_atom);
+  b_factor_.reserve(n_atom);
+  seg_ID_.reserve(n_atom);
+  element_.reserve(n_atom);
+  atom_charge_.reserve(n_atom);
+  atom_residue_.reserve(n_atom);
+  atom_chain_.reserve(n_atom);
+  residue_start_.reserve(n_residue + 1);
+  residue_name_.reserve(n_residue);
+  short_name_.reserve(n_residue);
+  residue_serial_.reserve(n_residue);
+  residue_chain_.reserve(n_residue);
+  terminus_flag_.reserve(n_residue);
+  residue_mass_.reserve(n_residue);
+  residue_charge_.reserve(n_residue);
+  sasa_.reserve(n_residue);
+
+  for (int c = 0; c < mdl.get_size(); ++c) {
+    const Chain& chain = mdl.get_chain(c);
+    for (int r = 0; r < chain.get_size(); ++r) {
+      const Residue& resid = chain.get_residue(r);
+      int i_residue = residue_name_.size();
+      for (int k = 0; k < resid.get_size(); ++k) {
+        const Atom& a = resid.get_atom(k);
+        const Vec3d& v = a.get_coordinate();
+        x_.push_back(v.x());
+        y_.push_back(v.y());
+        z_.push_back(v.z());
+        atom_serial_.push_back(a.get_atom_serial());
+        atom_name_.push_back(a.get_atom_name());
+        record_name_.push_back(a.get_record_name());
+        alt_loc_.push_back(a.get_alt_loc());
+        icode_.push_back(a.get_icode());
+        occupancy_.push_back(a.get_occupancy());
+        b_factor_.push_back(a.get_temperature_factor());
+        seg_ID_.push_back(a.get_segment_ID());
+        element_.push_back(a.get_element());
+        atom_charge_.push_back(a.get_charge());
+        atom_residue_.push_back(i_residue);
+        atom_chain_.push_back(c);
+      }
+      residue_start_.push_back(x_.size());
+      residue_name_.push_back(names_.intern(resid.get_residue_name()));
+      short_name_.push_back(names_.intern(resid.get_short_name()));
+      residue_serial_.push_back(resid.get_residue_serial());
+      residue_chain_.push_back(c);
+      terminus_flag_.push_back(resid.get_terminus_flag());
+      residue_mass_.push_back(resid.get_residue_mass());
+      residue_charge_.push_back(resid.get_residue_charge());
+      sasa_.push_back(resid.get_sasa());
+    }
+    chain_start_.push_back(residue_name_.size());
+    chain_ID_.push_back(chain.get_chain_ID());
+    chain_type_.push_back(chain.get_chain_type());
+  }
+}
+
+int System::read_pdb(const std::string& s, int n)
+{
+  reset();
+  PDBReader reader;
+  if (reader.open(s))
+    return 1;
+
+  // The residue being read (properties only; its atoms are already in the
+  // columns from resid_start on), and chain ID and type of each residue of the
+  // chain being read.
+  Residue resid;
+  bool resid_open = false;
+  bool resid_hetatm = false;
+  int resid_start = 0;
+  std::vector<std::pair<char, ChainType> > chain_resids;
+  int i_model = 0;
+  bool failed = false;
+
+  auto close_residue = [&]() {
+    residue_start_.push_back(x_.size());
+    residue_name_.push_back(names_.intern(resid.get_residue_name()));
+    short_name_.push_back(names_.intern(resid.get_short_name()));
+    residue_serial_.push_back(resid.get_residue_serial());
+    residue_chain_.push_back(chain_ID_.size());
+    terminus_flag_.push_back(resid.get_terminus_flag());
+    residue_mass_.push_back(resid.get_residue_mass());
+    residue_charge_.push_back(resid.get_residue_charge());
+    sasa_.push_back(resid.get_sasa());
+    chain_resids.push_back(std::make_pair(resid.get_chain_ID(), resid.get_chain_type()));
+    resid_open = false;
+  };
+  // a chain takes ID and type of its last residue; see Chain::self_check();
+  auto close_chain = [&]() {
+    char chain_ID = -1;
+    ChainType chain_type = none;
+    if (!chain_resids.empty()) {
+      chain_ID = chain_resids.back().first;
+      chain_type = chain_resids.back().second;
+    }
+    for (const std::pair<char, ChainType>& r : chain_resids) {
+      if (r.first != chain_ID || r.second != chain_type) {
+        std::cout << " ~             PINANG :: system.cpp                 ~ " << "\n";
+        std::cerr << " ERROR: Inconsistent chain ID or type in Chain " << chain_ID << "\n";
+        failed = true;
+        break;
+      }
+    }
+    if (chain_type == ion && chain_resids.size() >= 2) {
+      std::cout << " ~             PINANG :: system.cpp                 ~ " << "\n";
+      std::cerr << " ERROR: more than one ion in Chain: " << chain_ID << "\n";
+      failed = true;
+    }
+    const int first = chain_start_.back();
+    const int last = int(residue_name_.size()) - 1;
+    if (chain_type == protein) {
+      terminus_flag_[first] = -1;
+      terminus_flag_[last] = 1;
+    }
+    if (chain_type == RNA || chain_type == na || chain_type == DNA) {
+      terminus_flag_[first] = 5;
+      terminus_flag_[last] = 3;
+    }
+    chain_start_.push_back(residue_name_.size());
+    chain_ID_.push_back(chain_ID);
+    chain_type_.push_back(chain_type);
+    chain_resids.clear();
+  };
+  auto open_residue = [&](const Atom& a, bool hetatm) {
+    resid.reset();
+    if (hetatm)
+      resid.set_residue_name(a.get_residue_name());
+    else
+      resid.set_residue_by_name(a.get_residue_name());
+    resid.set_chain_ID(a.get_chain_ID());
+    resid.set_residue_serial(a.get_residue_serial());
+    resid_open = true;
+    resid_hetatm = hetatm;
+    resid_start = x_.size();
+  };
+  // atoms with the name of an atom already in the residue are skipped; see
+  // Residue::add_atom();
+  auto add_atom = [&](const Atom& a) {
+    for (int i = resid_start; i < int(x_.size()); ++i)
+      if (atom_name_[i] == a.get_atom_name())
+        return;
+    const Vec3d& v = a.get_coordinate();
+    x_.push_back(v.x());
+    y_.push_back(v.y());
+    z_.push_back(v.z());
+    atom_serial_.push_back(a.get_atom_serial());
+    atom_name_.push_back(a.get_atom_name());
+    record_name_.push_back(a.get_record_name());
+    alt_loc_.push_back(a.get_alt_loc());
+    icode_.push_back(a.get_icode());
+    occupancy_.push_back(a.get_occupancy());
+    b_factor_.push_back(a.get_temperature_factor());
+    seg_ID_.push_back(a.get_segment_ID());
+    element_.push_back(a.get_element());
+    atom_charge_.push_back(a.get_charge());
+    atom_residue_.push_back(residue_name_.size());
+    atom_chain_.push_back(chain_ID_.size());
+  };
+
+  Atom atom;
+  PDBRecord record;
+  while (reader.read(atom, record)) {
+    const bool same_residue = resid_open && atom.get_residue_serial() == resid.get_residue_serial()
+                              && atom.get_chain_ID() == resid.get_chain_ID();
+    switch (record) {
+      case pdb_model:
+        reset();
+        model_serial_ = atom.get_atom_serial();
+        resid_open = false;
+        chain_resids.clear();
+        break;
+      case pdb_ter:
+        if (resid_open)
+          close_residue();
+        close_chain();
+        break;
+      case pdb_endmdl:
+      case pdb_end:
+        if (resid_open)
+          close_residue();
+        if (!chain_resids.empty())
+          close_chain();
+        if (record == pdb_endmdl || get_chain_number() != 0) {
+          if (!failed && i_model == n)
+            return 0;
+          ++i_model;
+        }
+        reset();
+        resid_open = false;
+        chain_resids.clear();
+        break;
+      case pdb_atom:
+        if (!same_residue) {
+          if (resid_open) {
+            bool hetatm = resid_hetatm;
+            close_residue();
+            if (hetatm)
+              close_chain();
+          }
+          open_residue(atom, false);
+        }
+        add_atom(atom);
+        break;
+      case pdb_hetatm:
+        if (!same_residue) {
+          if (resid_open) {
+            close_residue();
+            close_chain();
+          }
+          open_residue(atom, true);
+        }
+        add_atom(atom);
+        break;
+      default:
+        break;
+    }
+    if (failed)
+    {
+      reset();
+      return 1;
+    }
+  }
+
+  reset();
+  std::cout << " ~             PINANG :: system.cpp                 ~ " << "\n";
+  std::cerr << " ERROR: Model number out of range in PDB: " << s << "\n";
+  return 1;
+}
+
+Model System::get_model() const
+{
+  Model mdl;
+  Chain chain;
+  Residue resid;
+  mdl.set_model_serial(model_serial_);
+  for (int c = 0; c < get_chain_number(); ++c) {
+    chain.reset();
+    chain.set_chain_ID(chain_ID_[c]);
+    chain.set_chain_type(chain_type_[c]);
+    for (int r = chain_start_[c]; r < chain_start_[c + 1]; ++r) {
+      resid.reset();
+      resid.set_residue_name(names_.get_name(residue_name_[r]));
+      resid.set_short_name(names_.get_name(short_name_[r]));
+      resid.set_chain_ID(chain_ID_[c]);
+      resid.set_chain_type(chain_type_[c]);
+      resid.set_residue_serial(residue_serial_[r]);
+      resid.set_residue_mass(residue_mass_[r]);
+      resid.set_residue_charge(residue_charge_[r]);
+      resid.set_terminus_flag(terminus_flag_[r]);
+      resid.set_sasa(sasa_[r]);
+      for (int i = residue_start_[r]; i < residue_start_[r + 1]; ++i)
+        resid.add_atom(get_atom(i).to_atom());
+      chain.add_residue(std::move(resid));
+    }
+    mdl.add_chain(std::move(chain));
+  }
+  return mdl;
+}
+
+int System::set_coordinates(const CoordinateView<double>& v)
+{
+  if (v.get_size() != get_atom_number())
+  {
+    std::cout << " ~             PINANG :: system.cpp                 ~ " << "\n";
+    std::cerr << " ERROR: Wrong number of coordinates for System! " << "\n";
+    return 1;
+  }
+  for (int i = 0; i < v.get_size(); ++i) {
+    const int k = i * v.get_stride();
+    x_[i] = v.x()[k];
+    y_[i] = v.y()[k];
+    z_[i] = v.z()[k];
+  }
+  return 0;
+}
+
+}  // pinang
@@ -43,7 +43,12 @@ Topology::Topology(const std::string& s)
       tmp_sstr.str ( inp_line );
       tmp_sstr >> n_particle_;
       for (int i = 0; i < n_particle_ ; ++i) {
-        ifile >> p;
+        if (!(ifile >> p))
+        {
+          std::cout << " ~           PINANG :: TOPOLOGY          ~ " << "\n";
+          std::cerr << " ERROR: Wrong particle " << i + 1 << " in top file: " << s << "\n";
+          exit(EXIT_FAILURE);
+        }
         v_particles_.push_back(p);
       }
       std::cout << " Total particle number: " << n_particle_
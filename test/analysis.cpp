@@ -0,0 +1,430 @@
+/*!
+  @file analysis.cpp
+  @brief Test of the trajectory and structure analyses.
+
+  RmsdMatrix, clustering, compute_rmsf() and PositionAccumulator are checked
+  on a generated trajectory of three well separated states against direct
+  computations; NativeContacts::compute_q(), get_residue_contacts() and
+  ShrakeRupley on hand-made or brute-force results.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 15:52
+  @copyright GNU Public License V3.0
+*/
+
+#include <cstdio>
+#include <sstream>
+#include "clustering.hpp"
+#include "dcd_mapped_reader.hpp"
+#include "geometry.hpp"
+#include "native_contacts.hpp"
+#include "residue.hpp"
+#include "rmsd_matrix.hpp"
+#include "rmsf.hpp"
+#include "sasa.hpp"
+#include "test_util.hpp"
+
+using namespace std;
+using pinang_test::check;
+using pinang_test::check_near;
+
+namespace {
+
+typedef vector<vector<pinang::Vec3d> > Frames;
+
+const int k_state = 3;  //!< Number of states of the trajectory.
+
+// Frames of k_state states (frame k in state k % k_state), each frame rotated
+// and translated as a whole.
+Frames state_frames(int n_frame, int n_atom)
+{
+  mt19937 rng(7);
+  uniform_real_distribution<double> box(-10.0, 10.0);
+  normal_distribution<double> noise(0.0, 0.2);
+  normal_distribution<double> deform(0.0, 2.5);
+
+  vector<pinang::Vec3d> base(n_atom);
+  for (pinang::Vec3d& v : base)
+    v = pinang::Vec3d(box(rng), box(rng), box(rng));
+  vector<vector<pinang::Vec3d> > states(k_state, base);
+  for (vector<pinang::Vec3d>& s : states)
+    for (pinang::Vec3d& v : s)
+      v += pinang::Vec3d(deform(rng), deform(rng), deform(rng));
+
+  Frames frames(n_frame, vector<pinang::Vec3d>(n_atom));
+  for (int k = 0; k < n_frame; ++k) {
+    const double a = 0.37 * k;
+    const pinang::Vec3d shift(k * 0.5, -k * 0.25, 3.0);
+    for (int i = 0; i < n_atom; ++i) {
+      const pinang::Vec3d& v = states[k % k_state][i];
+      pinang::Vec3d w(v.x() + noise(rng), v.y() + noise(rng), v.z() + noise(rng));
+      frames[k][i] = pinang::Vec3d(cos(a) * w.x() - sin(a) * w.y(), sin(a) * w.x() + cos(a) * w.y(),
+                                   w.z()) + shift;
+    }
+  }
+  return frames;
+}
+
+vector<pinang::Vec3d> select(const vector<pinang::Vec3d>& v, const pinang::Selection& sel)
+{
+  vector<pinang::Vec3d> s(sel.get_size());
+  for (int i = 0; i < sel.get_size(); ++i)
+    s[i] = v[sel.get_selection(i)];
+  return s;
+}
+
+// RMSD after superimposition, by find_transform() of two Groups.
+double direct_rmsd(const vector<pinang::Vec3d>& a, const vector<pinang::Vec3d>& b)
+{
+  pinang::Group ga(a);
+  pinang::Group gb(b);
+  pinang::Transform t;
+  double rmsd = -1;
+  pinang::find_transform(ga, gb, t, rmsd);
+  return rmsd;
+}
+
+void test_rmsd_matrix(const string& name, const Frames& frames, const pinang::Selection& sel)
+{
+  pinang::DcdMappedReader dcd(name);
+  dcd.set_frame_range(1, 0, 2);
+  const int n = dcd.get_range_size();
+
+  // float and half precision, with tiles not dividing the number of frames;
+  const int value_size[] = {4, 2};
+  const double tol[] = {1e-4, 2e-3};
+  for (int v = 0; v < 2; ++v) {
+    ostringstream tag;
+    tag << " (value size " << value_size[v] << ")";
+    pinang::RmsdMatrix mat;
+    check(mat.create(n, value_size[v]) == 0, "RmsdMatrix create" + tag.str());
+    check(pinang::compute_rmsd_matrix(dcd, sel, 3, mat, 4) == 0, "compute_rmsd_matrix" + tag.str());
+    check(mat.get_frame(n - 1) == dcd.get_range_frame(n - 1), "RmsdMatrix frame info" + tag.str());
+    double dev = 0;
+    for (int i = 0; i < n; ++i) {
+      dev = max(dev, fabs(mat.get(i, i)));
+      for (int j = i + 1; j < n; ++j) {
+        const double r = direct_rmsd(select(frames[mat.get_frame(i)], sel),
+                                     select(frames[mat.get_frame(j)], sel));
+        dev = max(dev, fabs(mat.get(i, j) - r) / max(r, 1.0));
+        dev = max(dev, fabs(mat.get(j, i) - mat.get(i, j)));
+      }
+    }
+    check_near(dev, 0.0, tol[v], "RmsdMatrix values" + tag.str());
+  }
+
+  pinang::CenteredFrames centered;
+  check(centered.load(dcd, sel, 2, 5) == 0, "CenteredFrames load");
+  check(centered.get_size() == n && centered.get_atom_number() == sel.get_size(), "CenteredFrames size");
+  double dev = 0;
+  for (int i = 0; i < n; i += 3)
+    for (int j = 0; j < n; j += 2)
+      dev = max(dev, fabs(centered.get_rmsd(i, j) - direct_rmsd(select(frames[1 + 2 * i], sel),
+                                                               select(frames[1 + 2 * j], sel))));
+  check_near(dev, 0.0, 1e-4, "CenteredFrames get_rmsd");
+}
+
+// Clusters must be the states of the frames.
+void check_states(const pinang::ClusterResult& result, int n, const string& what)
+{
+  check(result.get_size() == n, what + " size");
+  check(result.get_cluster_number() == k_state, what + " number of clusters");
+  if (result.get_size() != n || result.get_cluster_number() != k_state)
+    return;
+  bool same = true;
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+      same = same && (result.get_label(i) == result.get_label(j)) == (i % k_state == j % k_state);
+  check(same, what + " labels");
+  bool medoids = true;
+  int total = 0;
+  for (int c = 0; c < k_state; ++c) {
+    medoids = medoids && result.get_label(result.get_medoid(c)) == c;
+    total += result.get_population(c);
+  }
+  check(medoids, what + " medoids");
+  check(total == n, what + " populations");
+}
+
+void test_clustering(const Frames& frames)
+{
+  const int n = frames.size();
+  pinang::RmsdMatrix mat;
+  mat.create(n, 4);
+  for (int i = 0; i < n; ++i)
+    for (int j = i + 1; j < n; ++j)
+      mat.set(i, j, direct_rmsd(frames[i], frames[j]));
+  auto dist = [&mat](int i, int j) { return mat.get(i, j); };
+
+  pinang::ClusterResult result;
+  check(pinang::cluster_gromos(n, dist, 1.5, 3, result) == 0, "cluster_gromos");
+  check_states(result, n, "cluster_gromos");
+  for (int c = 0; c < result.get_cluster_number(); ++c)
+    check(result.get_population(c) == n / k_state, "cluster_gromos population");
+
+  // a cutoff below all the distances gives one frame per cluster;
+  check(pinang::cluster_gromos(n, dist, 1e-3, 2, result) == 0, "cluster_gromos (small cutoff)");
+  check(result.get_cluster_number() == n, "cluster_gromos (small cutoff) number of clusters");
+
+  check(pinang::cluster_kmedoids(n, dist, k_state, 3, result) == 0, "cluster_kmedoids (PAM)");
+  check_states(result, n, "cluster_kmedoids (PAM)");
+  check(pinang::cluster_kmedoids(n, dist, k_state, 2, result, 15, 4, 11) == 0,
+        "cluster_kmedoids (CLARA)");
+  check_states(result, n, "cluster_kmedoids (CLARA)");
+}
+
+void test_rmsf(const string& name, const Frames& frames)
+{
+  const int n_frame = frames.size();
+  const int n_atom = frames[0].size();
+
+  // PositionAccumulator against direct sums, and merged in two parts;
+  pinang::PositionAccumulator acc;
+  pinang::PositionAccumulator acc_a;
+  pinang::PositionAccumulator acc_b;
+  acc.reset(n_atom);
+  acc_a.reset(n_atom);
+  acc_b.reset(n_atom);
+  for (int k = 0; k < n_frame; ++k) {
+    pinang::Conformation conf(frames[k]);
+    acc.add(conf.get_view());
+    (k < n_frame / 3 ? acc_a : acc_b).add(conf.get_view());
+  }
+  acc_a.merge(acc_b);
+  check(acc.get_frame_number() == n_frame && acc_a.get_frame_number() == n_frame,
+        "PositionAccumulator frame number");
+  double dev_mean = 0;
+  double dev_rmsf = 0;
+  double dev_merge = 0;
+  for (int i = 0; i < n_atom; ++i) {
+    pinang::Vec3d mean;
+    for (int k = 0; k < n_frame; ++k)
+      mean += frames[k][i];
+    mean = mean / n_frame;
+    double m2 = 0;
+    for (int k = 0; k < n_frame; ++k)
+      m2 += (frames[k][i] - mean).squared_norm();
+    dev_mean = max(dev_mean, (acc.get_mean(i) - mean).norm());
+    dev_rmsf = max(dev_rmsf, fabs(acc.get_rmsf(i) - sqrt(m2 / n_frame)));
+    dev_merge = max(dev_merge, fabs(acc_a.get_rmsf(i) - acc.get_rmsf(i))
+                    + (acc_a.get_mean(i) - acc.get_mean(i)).norm());
+  }
+  check_near(dev_mean, 0.0, 1e-9, "PositionAccumulator mean");
+  check_near(dev_rmsf, 0.0, 1e-9, "PositionAccumulator RMSF");
+  check_near(dev_merge, 0.0, 1e-9, "PositionAccumulator merge");
+
+  // compute_rmsf against the same iterative alignment done directly;
+  pinang::Selection sel_fit(vector<int>{0, 2, 4, 6, 8, 10, 12, 14, 16, 18});
+  pinang::Selection sel_rmsf(vector<int>{1, 2, 3, 5, 8, 13, 21});
+  const int max_iter = 50;
+  const double tol = 1e-6;
+  pinang::DcdMappedReader dcd(name);
+  for (int n_thread = 1; n_thread <= 4; n_thread += 3) {
+    ostringstream tag;
+    tag << " (" << n_thread << " threads)";
+    pinang::PositionAccumulator result;
+    const int iter = pinang::compute_rmsf(dcd, sel_fit, sel_rmsf, n_thread, result, max_iter, tol);
+    check(iter > 0 && iter < max_iter, "compute_rmsf converged" + tag.str());
+
+    vector<pinang::Vec3d> ref = select(frames[0], sel_fit);
+    vector<pinang::Vec3d> aligned_rmsf(n_frame * sel_rmsf.get_size());
+    int direct_iter = 0;
+    for (double shift = tol; shift >= tol && direct_iter < max_iter; ) {
+      ++direct_iter;
+      vector<pinang::Vec3d> mean(sel_fit.get_size());
+      for (int k = 0; k < n_frame; ++k) {
+        pinang::Group fit(select(frames[k], sel_fit));
+        pinang::Transform t;
+        double d;
+        pinang::find_transform(fit, pinang::Group(ref), t, d);
+        for (int i = 0; i < sel_fit.get_size(); ++i)
+          mean[i] += t.apply(frames[k][sel_fit.get_selection(i)]) / n_frame;
+        for (int i = 0; i < sel_rmsf.get_size(); ++i)
+          aligned_rmsf[k * sel_rmsf.get_size() + i] = t.apply(frames[k][sel_rmsf.get_selection(i)]);
+      }
+      shift = 0;
+      for (int i = 0; i < sel_fit.get_size(); ++i)
+        shift += (mean[i] - ref[i]).squared_norm();
+      shift = sqrt(shift / sel_fit.get_size());
+      ref = mean;
+    }
+    check(iter == direct_iter, "compute_rmsf iterations" + tag.str());
+
+    double dev = 0;
+    for (int i = 0; i < sel_rmsf.get_size(); ++i) {
+      pinang::Vec3d mean;
+      for (int k = 0; k < n_frame; ++k)
+        mean += aligned_rmsf[k * sel_rmsf.get_size() + i] / n_frame;
+      double m2 = 0;
+      for (int k = 0; k < n_frame; ++k)
+        m2 += (aligned_rmsf[k * sel_rmsf.get_size() + i] - mean).squared_norm();
+      dev = max(dev, fabs(result.get_rmsf(i) - sqrt(m2 / n_frame)) + (result.get_mean(i) - mean).norm());
+    }
+    check_near(dev, 0.0, 1e-6, "compute_rmsf RMSF" + tag.str());
+  }
+
+  pinang::PositionAccumulator result;
+  check(pinang::compute_rmsf(dcd, pinang::Selection(vector<int>{0, 1}), sel_rmsf, 1, result) == -1,
+        "compute_rmsf with too few fitting atoms");
+}
+
+void test_native_contacts()
+{
+  // particles on the x axis: 0 at 0, 1 at 4, 2 at 9, 3 at 20, 4 at 30;
+  vector<pinang::Vec3d> v = {pinang::Vec3d(0, 0, 0), pinang::Vec3d(4, 0, 0), pinang::Vec3d(9, 0, 0),
+                             pinang::Vec3d(20, 0, 0), pinang::Vec3d(30, 0, 0)};
+  pinang::Conformation conf(v);
+  pinang::NativeContacts nc;
+  nc.set_tolerance(1.2);
+  nc.add_contact(0, 1, 4.0, false);  // formed: 4 < 4.8;
+  nc.add_contact(1, 2, 4.0, false);  // formed: 5 < 4.8 is false;
+  nc.add_contact(0, 2, 8.0, true);   // formed: 9 < 9.6;
+  nc.add_contact(2, 3, 5.0, true);   // not formed: 11;
+  nc.add_contact(3, 4, 9.0, true);   // formed: 10 < 10.8;
+  check(nc.get_size() == 5 && nc.get_intra_number() == 2 && nc.get_inter_number() == 3,
+        "NativeContacts numbers");
+  check(nc.get_atoms() == vector<int>({0, 1, 2, 3, 4}), "NativeContacts atoms");
+
+  double q = -1;
+  double q_intra = -1;
+  double q_inter = -1;
+  check(nc.compute_q(conf, q, q_intra, q_inter) == 3, "compute_q formed contacts");
+  check_near(q, 3.0 / 5, 1e-12, "compute_q Q");
+  check_near(q_intra, 1.0 / 2, 1e-12, "compute_q Q intra");
+  check_near(q_inter, 2.0 / 3, 1e-12, "compute_q Q inter");
+
+  nc.set_tolerance(1.3);
+  check(nc.compute_q(conf, q, q_intra, q_inter) == 4, "compute_q with larger tolerance");
+
+  pinang::NativeContacts nc_intra;
+  nc_intra.add_contact(0, 1, 4.0, false);
+  nc_intra.set_tolerance(1.2);
+  nc_intra.compute_q(conf, q, q_intra, q_inter);
+  check(q == 1.0 && q_intra == 1.0 && q_inter == 0.0, "compute_q without inter-chain contacts");
+}
+
+void test_residue_contacts()
+{
+  mt19937 rng(5);
+  uniform_real_distribution<double> box(0.0, 30.0);
+  normal_distribution<double> spread(0.0, 1.5);
+  const char* names[] = {"N", "CA", "C", "H"};
+  const char* elements[] = {"N", "C", "C", "H"};
+
+  vector<pinang::Residue> residues(120);
+  for (int r = 0; r < int(residues.size()); ++r) {
+    pinang::Residue& res = residues[r];
+    res.set_residue_serial(r + 1);
+    res.set_chain_ID('A');
+    const pinang::Vec3d center(box(rng), box(rng), box(rng));
+    for (int i = 0; i < 4; ++i) {
+      pinang::Atom a;
+      a.set_atom_name(pinang::AtomName(names[i]));
+      a.set_element(pinang::ElementName(elements[i]));
+      a.set_residue_serial(r + 1);
+      a.set_chain_ID('A');
+      a.set_coordinate(center + pinang::Vec3d(spread(rng), spread(rng), spread(rng)));
+      res.add_atom(a);
+    }
+  }
+  // an empty residue has no contacts;
+  residues[7] = pinang::Residue();
+
+  const double cutoffs[] = {4.0, 6.5};
+  for (double cutoff : cutoffs) {
+    for (int min_sep = 1; min_sep <= 3; min_sep += 2) {
+      vector<pair<int, int> > expected;
+      for (int i = 0; i < int(residues.size()); ++i)
+        for (int j = i + min_sep; j < int(residues.size()); ++j)
+          if (pinang::is_residue_contact(residues[i], residues[j], cutoff))
+            expected.push_back(make_pair(i, j));
+      ostringstream tag;
+      tag << " (cutoff " << cutoff << ", separation " << min_sep << ")";
+      check(!expected.empty(), "residue contacts exist" + tag.str());
+      check(pinang::get_residue_contacts(residues, cutoff, min_sep) == expected,
+            "get_residue_contacts" + tag.str());
+    }
+
+    vector<pinang::Residue> list_a(residues.begin(), residues.begin() + 50);
+    vector<pinang::Residue> list_b(residues.begin() + 50, residues.end());
+    vector<pair<int, int> > expected;
+    for (int i = 0; i < int(list_a.size()); ++i)
+      for (int j = 0; j < int(list_b.size()); ++j)
+        if (pinang::is_residue_contact(list_a[i], list_b[j], cutoff))
+          expected.push_back(make_pair(i, j));
+    check(pinang::get_residue_contacts(list_a, list_b, cutoff) == expected,
+          "get_residue_contacts of two lists");
+  }
+}
+
+void test_sasa()
+{
+  const double pi = 3.14159265358979323846;
+  const double probe = 1.4;
+  pinang::ShrakeRupley sr(960, probe);
+  check(sr.get_point_number() == 960 && sr.get_probe() == probe, "ShrakeRupley parameters");
+
+  // isolated spheres: every point is accessible;
+  vector<pinang::Vec3d> coors = {pinang::Vec3d(0, 0, 0), pinang::Vec3d(50, 0, 0)};
+  vector<double> radii = {1.8, 3.0};
+  vector<double> area;
+  check(sr.compute(coors, radii, area, 1) == 0 && area.size() == 2, "ShrakeRupley compute");
+  for (int i = 0; i < int(area.size()); ++i)
+    check_near(area[i], 4 * pi * (radii[i] + probe) * (radii[i] + probe), 1e-9,
+               "ShrakeRupley isolated sphere");
+
+  // a small atom inside a large one is buried;
+  coors = {pinang::Vec3d(0, 0, 0), pinang::Vec3d(0.5, 0, 0)};
+  radii = {4.0, 1.0};
+  sr.compute(coors, radii, area, 1);
+  check(area.size() == 2 && area[1] == 0.0, "ShrakeRupley buried atom");
+
+  // two equal spheres: the cap inside the other sphere is lost (up to the
+  // discretization by the sphere points);
+  const double r = 1.7;
+  const double d = 3.0;
+  const double big = r + probe;
+  coors = {pinang::Vec3d(0, 0, 0), pinang::Vec3d(d, 0, 0)};
+  radii = {r, r};
+  sr.compute(coors, radii, area, 2);
+  const double exact = 4 * pi * big * big - 2 * pi * big * (big - d / 2);
+  check(area.size() == 2, "ShrakeRupley pair");
+  for (double a : area)
+    check_near(a, exact, 0.02 * exact, "ShrakeRupley overlapping pair");
+
+  // the result does not depend on the number of threads;
+  mt19937 rng(3);
+  uniform_real_distribution<double> box(0.0, 15.0);
+  coors.resize(200);
+  radii.assign(200, 1.6);
+  for (pinang::Vec3d& v : coors)
+    v = pinang::Vec3d(box(rng), box(rng), box(rng));
+  vector<double> area_1;
+  vector<double> area_4;
+  sr.compute(coors, radii, area_1, 1);
+  sr.compute(coors, radii, area_4, 4);
+  check(area_1 == area_4, "ShrakeRupley threads");
+
+  radii.pop_back();
+  check(sr.compute(coors, radii, area, 1) != 0, "ShrakeRupley with wrong number of radii");
+}
+
+}
+
+int main()
+{
+  const string name = "t_analysis_test.dcd";
+  Frames frames = state_frames(45, 24);
+  pinang_test::write_dcd(name, frames, 0);
+
+  test_rmsd_matrix(name, frames, pinang::Selection(vector<int>{0, 1, 2, 3, 5, 7, 11, 13, 17, 19, 23}));
+  test_clustering(frames);
+  test_rmsf(name, frames);
+  remove(name.c_str());
+
+  test_native_contacts();
+  test_residue_contacts();
+  test_sasa();
+
+  return pinang_test::report("analysis");
+}
@@ -0,0 +1,238 @@
+/*!
+  @file dcd.cpp
+  @brief Test of the dcd readers against read_cafemol_dcd().
+
+  DcdReader (frame ranges, atom subsets, frame index), DcdMappedReader,
+  DcdPrefetcher and parallel_for_frames() are compared with the coordinates
+  written to a generated dcd file and with read_cafemol_dcd(), with and
+  without a truncated last frame.  DcdIndex sidecar files are checked for
+  damaged and stale contents.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 15:52
+  @copyright GNU Public License V3.0
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include "dcd_prefetcher.hpp"
+#include "parallel_frames.hpp"
+#include "read_cafemol_dcd.hpp"
+#include "test_util.hpp"
+
+using namespace std;
+using pinang_test::check;
+
+namespace {
+
+typedef vector<vector<pinang::Vec3d> > Frames;
+
+// Maximum deviation of (a subset of) a decoded frame from the written one.
+double frame_deviation(pinang::Conformation& conf, const vector<pinang::Vec3d>& ref,
+                       const pinang::Selection& sel, const pinang::Selection& sel_conf)
+{
+  double d = 0;
+  if (sel.get_size() == 0) {
+    if (conf.get_size() != int(ref.size()))
+      return 1e10;
+    for (int i = 0; i < conf.get_size(); ++i)
+      d = max(d, (conf.get_coordinate(i) - ref[i]).norm());
+    return d;
+  }
+  for (int i = 0; i < sel.get_size(); ++i)
+    d = max(d, (conf.get_coordinate(sel_conf.get_selection(i)) - ref[sel.get_selection(i)]).norm());
+  return d;
+}
+
+void test_readers(const string& name, Frames& frames, int truncated_bytes)
+{
+  const string tag = truncated_bytes ? " (truncated)" : "";
+  const int n_frame = frames.size();
+  pinang_test::write_dcd(name, frames, truncated_bytes);
+  remove(pinang::DcdIndex::get_sidecar_name(name).c_str());
+
+  // read_cafemol_dcd;
+  ifstream dcd_file(name.c_str(), ifstream::binary);
+  vector<pinang::Conformation> confs;
+  check(pinang::read_cafemol_dcd(dcd_file, confs) == 0, "read_cafemol_dcd status" + tag);
+  check(int(confs.size()) == n_frame, "read_cafemol_dcd frame count" + tag);
+  double dev = 0;
+  for (int k = 0; k < n_frame && k < int(confs.size()); ++k)
+    dev = max(dev, frame_deviation(confs[k], frames[k], pinang::Selection(), pinang::Selection()));
+  check(dev == 0, "read_cafemol_dcd coordinates" + tag);
+
+  // DcdReader, all frames, with and without frame index;
+  for (int use_index = 0; use_index < 2; ++use_index) {
+    const string tag_i = tag + (use_index ? " (index)" : "");
+    pinang::DcdReader reader(name, use_index);
+    check(reader.frame_count() == n_frame, "DcdReader frame count" + tag_i);
+    int n = 0;
+    dev = 0;
+    for (pinang::Conformation& conf : reader) {
+      int k = reader.get_frame_index();
+      dev = max(dev, k == n ? frame_deviation(conf, frames[k], pinang::Selection(),
+                                              pinang::Selection()) : 1e10);
+      ++n;
+    }
+    check(n == n_frame, "DcdReader iterated frames" + tag_i);
+    check(dev == 0, "DcdReader coordinates" + tag_i);
+  }
+
+  // DcdReader, frame range and atom subset;
+  pinang::Selection sel(vector<int>{7, 3, 4, 5, 18, 19, 0});
+  pinang::DcdReader reader(name);
+  check(reader.set_frame_range(5, -3, 4) == 0, "DcdReader set_frame_range" + tag);
+  check(reader.set_atom_subset({sel}) == 0, "DcdReader set_atom_subset" + tag);
+  check(reader.get_subset_size() == sel.get_size(), "DcdReader subset size" + tag);
+  pinang::Selection sel_dcd = reader.get_subset_selection(sel);
+  pinang::Conformation conf;
+  vector<int> visited;
+  dev = 0;
+  while (reader.next_frame(conf) == 0) {
+    visited.push_back(reader.get_frame_index());
+    dev = max(dev, frame_deviation(conf, frames[visited.back()], sel, sel_dcd));
+  }
+  vector<int> expected;
+  for (int k = 5; k < n_frame - 3; k += 4)
+    expected.push_back(k);
+  check(visited == expected, "DcdReader frames in range" + tag);
+  check(int(expected.size()) == reader.get_range_size(), "DcdReader range size" + tag);
+  check(dev == 0, "DcdReader subset coordinates" + tag);
+
+  // DcdMappedReader;
+  pinang::DcdMappedReader mapped(name);
+  check(mapped.is_open() && mapped.frame_count() == n_frame, "DcdMappedReader frame count" + tag);
+  dev = 0;
+  for (int k = 0; k < mapped.frame_count(); ++k) {
+    check(mapped.read_frame(k, conf) == 0, "DcdMappedReader read_frame" + tag);
+    dev = max(dev, frame_deviation(conf, frames[k], pinang::Selection(), pinang::Selection()));
+  }
+  check(mapped.read_frame(n_frame, conf) != 0, "DcdMappedReader frame out of range" + tag);
+  check(mapped.set_frame_range(-10, 0, 3) == 0, "DcdMappedReader set_frame_range" + tag);
+  check(mapped.set_atom_subset({sel}) == 0, "DcdMappedReader set_atom_subset" + tag);
+  sel_dcd = mapped.get_subset_selection(sel);
+  for (int k = 0; k < mapped.get_range_size(); ++k) {
+    int i_frame = mapped.get_range_frame(k);
+    check(i_frame == n_frame - 10 + 3 * k, "DcdMappedReader range frame" + tag);
+    mapped.read_frame(i_frame, conf);
+    dev = max(dev, frame_deviation(conf, frames[i_frame], sel, sel_dcd));
+  }
+  check(dev == 0, "DcdMappedReader coordinates" + tag);
+
+  // DcdPrefetcher on both readers;
+  {
+    pinang::DcdReader r(name);
+    pinang::DcdPrefetcher prefetcher(r, 3);
+    int n = 0;
+    dev = 0;
+    while (prefetcher.next_frame(conf) == 0) {
+      dev = max(dev, prefetcher.get_frame_index() == n
+                ? frame_deviation(conf, frames[n], pinang::Selection(), pinang::Selection()) : 1e10);
+      ++n;
+    }
+    check(n == n_frame && dev == 0, "DcdPrefetcher(DcdReader)" + tag);
+  }
+  {
+    pinang::DcdPrefetcher prefetcher(mapped, 2);
+    int n = 0;
+    dev = 0;
+    while (prefetcher.next_frame(conf) == 0) {
+      int i_frame = prefetcher.get_frame_index();
+      dev = max(dev, i_frame == mapped.get_range_frame(n)
+                ? frame_deviation(conf, frames[i_frame], sel, sel_dcd) : 1e10);
+      ++n;
+    }
+    check(n == mapped.get_range_size() && dev == 0, "DcdPrefetcher(DcdMappedReader)" + tag);
+  }
+
+  // parallel_for_frames, serial (prefetched) and with threads;
+  mapped.clear_atom_subset();
+  mapped.set_frame_range(0, 0, 1);
+  for (int n_thread = 1; n_thread <= 3; n_thread += 2) {
+    vector<double> dev_frames(n_frame, 1e10);
+    int status = pinang::parallel_for_frames(mapped, n_thread, [&](int, int k, pinang::Conformation& c) {
+        dev_frames[k] = frame_deviation(c, frames[k], pinang::Selection(), pinang::Selection());
+      });
+    ostringstream tag_t;
+    tag_t << tag << " (" << n_thread << " threads)";
+    check(status == 0, "parallel_for_frames status" + tag_t.str());
+    check(*max_element(dev_frames.begin(), dev_frames.end()) == 0,
+          "parallel_for_frames coordinates" + tag_t.str());
+  }
+}
+
+// Overwrite 8 bytes of a file.
+void poke_int64(const string& name, long position, std::int64_t value)
+{
+  fstream f(name.c_str(), ios::in | ios::out | ios::binary);
+  f.seekp(position);
+  f.write((const char*)&value, sizeof(value));
+}
+
+void test_index(const string& name, Frames& frames)
+{
+  const string sidecar = pinang::DcdIndex::get_sidecar_name(name);
+  pinang_test::write_dcd(name, frames, 0);
+  remove(sidecar.c_str());
+
+  ifstream dcd_file(name.c_str(), ifstream::binary);
+  pinang::DcdHeader header;
+  check(header.read(dcd_file) == 0, "DcdHeader read");
+  pinang::DcdIndex index;
+  check(index.read(name, header) != 0, "DcdIndex read without sidecar");
+  check(index.load(name, dcd_file, header) == 0, "DcdIndex load (build)");
+  check(index.get_frame_count() == int(frames.size()), "DcdIndex frame count");
+  bool offsets_ok = true;
+  for (int k = 0; k < index.get_frame_count(); ++k)
+    offsets_ok = offsets_ok && index.get_frame_offset(k)
+                 == header.get_header_size() + k * header.get_frame_size();
+  check(offsets_ok, "DcdIndex offsets");
+
+  pinang::DcdIndex index_read;
+  check(index_read.read(name, header) == 0, "DcdIndex read sidecar");
+  check(index_read.get_frame_count() == index.get_frame_count(), "DcdIndex read frame count");
+  check(index_read.get_natom() == header.get_natom(), "DcdIndex read natom");
+
+  // damaged sidecar: layout is magic, version, size, mtime, natom, nsavc,
+  // delta, frame count (at byte 40), offsets (from byte 48);
+  poke_int64(sidecar, 40, 1000000);
+  check(index_read.read(name, header) != 0, "DcdIndex rejects frame count");
+  check(index_read.is_empty(), "DcdIndex reset after rejecting");
+  check(index.write(name) == 0, "DcdIndex write");
+  poke_int64(sidecar, 48 + 8 * 3, header.get_header_size() + frames.size() * header.get_frame_size());
+  check(index_read.read(name, header) != 0, "DcdIndex rejects offset");
+  check(index.write(name) == 0, "DcdIndex write");
+  poke_int64(sidecar, 48 + 8 * 2, 1);
+  check(index_read.read(name, header) != 0, "DcdIndex rejects offset inside header");
+
+  // a damaged sidecar is rebuilt by DcdReader;
+  {
+    pinang::DcdReader reader(name, true);
+    check(reader.frame_count() == int(frames.size()), "DcdReader rebuilds damaged index");
+  }
+  check(index_read.read(name, header) == 0, "DcdIndex rebuilt sidecar");
+
+  // stale sidecar: the dcd file has changed;
+  frames.pop_back();
+  pinang_test::write_dcd(name, frames, 0);
+  check(index_read.read(name, header) != 0, "DcdIndex rejects stale sidecar");
+  pinang::DcdReader reader(name, true);
+  check(reader.frame_count() == int(frames.size()), "DcdReader with stale index");
+
+  remove(sidecar.c_str());
+}
+
+}
+
+int main()
+{
+  const string name = "t_dcd_test.dcd";
+  Frames frames = pinang_test::random_frames(37, 23, 1);
+  test_readers(name, frames, 0);
+  test_readers(name, frames, 50);
+  test_index(name, frames);
+  remove(name.c_str());
+
+  return pinang_test::report("dcd");
+}
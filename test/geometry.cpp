@@ -0,0 +1,134 @@
+/*!
+  @file geometry.cpp
+  @brief Test of the QCP superimposition against the Kabsch algorithm.
+
+  find_transform(), get_qcp_transform(), get_qcp_rmsd() and Superposer are
+  compared with a Kabsch superimposition computed by the SVD of Eigen, on
+  exact and noisy rigid-body copies of random structures.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 15:52
+  @copyright GNU Public License V3.0
+*/
+
+#include <Eigen/Dense>
+#include <sstream>
+#include "geometry.hpp"
+#include "test_util.hpp"
+
+using namespace std;
+using pinang_test::check;
+using pinang_test::check_near;
+
+namespace {
+
+// Kabsch superimposition of a onto b; returns the minimal RMSD.
+double kabsch_rmsd(const vector<pinang::Vec3d>& a, const vector<pinang::Vec3d>& b,
+                   Eigen::Matrix3d& rotation)
+{
+  const int n = a.size();
+  Eigen::Matrix3Xd A(3, n);
+  Eigen::Matrix3Xd B(3, n);
+  for (int i = 0; i < n; ++i) {
+    A.col(i) << a[i].x(), a[i].y(), a[i].z();
+    B.col(i) << b[i].x(), b[i].y(), b[i].z();
+  }
+  Eigen::Vector3d ca = A.rowwise().mean();
+  Eigen::Vector3d cb = B.rowwise().mean();
+  A.colwise() -= ca;
+  B.colwise() -= cb;
+  Eigen::JacobiSVD<Eigen::Matrix3d> svd(A * B.transpose(), Eigen::ComputeFullU | Eigen::ComputeFullV);
+  Eigen::Matrix3d d = Eigen::Matrix3d::Identity();
+  d(2, 2) = (svd.matrixV() * svd.matrixU().transpose()).determinant() > 0 ? 1.0 : -1.0;
+  rotation = svd.matrixV() * d * svd.matrixU().transpose();
+  return sqrt((rotation * A - B).squaredNorm() / n);
+}
+
+}
+
+int main()
+{
+  mt19937 rng(2026);
+  normal_distribution<double> spread(0.0, 5.0);
+
+  for (int trial = 0; trial < 8; ++trial) {
+    const int n = 5 + 13 * trial;
+    const double noise = trial % 2 ? 0.5 : 0.0;
+    ostringstream tag;
+    tag << "n = " << n << ", noise = " << noise;
+
+    // b = R a + t (+ noise);
+    vector<pinang::Vec3d> a(n);
+    vector<pinang::Vec3d> b(n);
+    Eigen::Matrix3d R = Eigen::AngleAxisd(0.4 + trial, Eigen::Vector3d(1, 2, 3 - trial).normalized())
+                        .toRotationMatrix();
+    for (int i = 0; i < n; ++i) {
+      a[i] = pinang::Vec3d(spread(rng), spread(rng), spread(rng));
+      Eigen::Vector3d v = R * Eigen::Vector3d(a[i].x(), a[i].y(), a[i].z())
+                          + Eigen::Vector3d(3.0, -2.0, 7.0);
+      b[i] = pinang::Vec3d(v(0) + noise * spread(rng) / 5, v(1) + noise * spread(rng) / 5,
+                           v(2) + noise * spread(rng) / 5);
+    }
+    Eigen::Matrix3d rotation;
+    const double rmsd_kabsch = kabsch_rmsd(a, b, rotation);
+
+    // find_transform (Group);
+    pinang::Group ga;
+    pinang::Group gb;
+    ga.set_conformation(a);
+    gb.set_conformation(b);
+    pinang::Transform t;
+    double rmsd = -1;
+    check(pinang::find_transform(ga, gb, t, rmsd) == 0, "find_transform status, " + tag.str());
+    check_near(rmsd, rmsd_kabsch, 1e-5, "find_transform RMSD, " + tag.str());
+    check_near(pinang::get_rmsd(t.apply(ga), gb), rmsd_kabsch, 1e-6,
+               "RMSD after find_transform, " + tag.str());
+    double m[9];
+    t.get_rotation_matrix(m);
+    double dev = 0;
+    for (int i = 0; i < 3; ++i)
+      for (int j = 0; j < 3; ++j)
+        dev = max(dev, fabs(m[3 * i + j] - rotation(i, j)));
+    check_near(dev, 0.0, 1e-6, "find_transform rotation, " + tag.str());
+
+    // find_transform (CoordinateView, double and float);
+    pinang::Conformation ca(a);
+    pinang::Conformation cb(b);
+    pinang::Transform tv;
+    check(pinang::find_transform(ca.get_view(), cb.get_view(), tv, rmsd) == 0,
+          "find_transform(view) status, " + tag.str());
+    check_near(rmsd, rmsd_kabsch, 1e-5, "find_transform(view) RMSD, " + tag.str());
+    pinang::CoordinateArray<float> fa;
+    pinang::CoordinateArray<float> fb;
+    fa.assign(ca.get_view());
+    fb.assign(cb.get_view());
+    check(pinang::find_transform(fa.get_view(), fb.get_view(), tv, rmsd) == 0,
+          "find_transform(float view) status, " + tag.str());
+    check_near(rmsd, rmsd_kabsch, 1e-3, "find_transform(float view) RMSD, " + tag.str());
+
+    // get_qcp_transform / get_qcp_rmsd from the inner product matrix;
+    double M[9];
+    double G[2];
+    pinang::Vec3d ctr_a;
+    pinang::Vec3d ctr_b;
+    pinang::get_inner_product(ca.get_view(), cb.get_view(), M, G, ctr_a, ctr_b);
+    pinang::Transform tq;
+    check(pinang::get_qcp_transform(M, G[0], G[1], n, ctr_a, ctr_b, tq, rmsd) == 0,
+          "get_qcp_transform status, " + tag.str());
+    check_near(rmsd, rmsd_kabsch, 1e-5, "get_qcp_transform RMSD, " + tag.str());
+    check_near(pinang::get_rmsd(tq.apply(ga), gb), rmsd_kabsch, 1e-6,
+               "RMSD after get_qcp_transform, " + tag.str());
+    check_near(pinang::get_qcp_rmsd(M, G[0], G[1], n), rmsd_kabsch, 1e-5,
+               "get_qcp_rmsd, " + tag.str());
+
+    // Superposer (reference b);
+    pinang::Superposer superposer(gb);
+    pinang::Transform ts;
+    check(superposer.superimpose(ga, ts, rmsd) == 0, "Superposer status, " + tag.str());
+    check_near(rmsd, rmsd_kabsch, 1e-5, "Superposer RMSD, " + tag.str());
+    check_near(pinang::get_rmsd(ts.apply(ga), gb), rmsd_kabsch, 1e-6,
+               "RMSD after Superposer, " + tag.str());
+  }
+
+  return pinang_test::report("geometry");
+}
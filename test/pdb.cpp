@@ -0,0 +1,323 @@
+/*!
+  @file pdb.cpp
+  @brief Test of PDB reading, the PDB cache and System.
+
+  The fixed-column decoders and parse_pdb_line() are checked on hand-written
+  fields and lines.  A generated PDB file is read, written by operator<< and
+  read again; it is also loaded through PDBCache, whose stale and damaged
+  cache files must be rejected.  System built from a Model, by set_model() and
+  by read_pdb() must give back the same Model.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 15:52
+  @copyright GNU Public License V3.0
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include "pdb_cache.hpp"
+#include "pdb_reader.hpp"
+#include "system.hpp"
+#include "test_util.hpp"
+
+using namespace std;
+using pinang_test::check;
+
+namespace {
+
+void describe_atom(ostream& o, const pinang::Atom& a)
+{
+  o << a.get_record_name() << "|" << a.get_atom_serial() << "|" << a.get_atom_name() << "|"
+    << int(a.get_alt_loc()) << "|" << a.get_residue_name() << "|" << int(a.get_chain_ID()) << "|"
+    << a.get_residue_serial() << "|" << int(a.get_icode()) << "|"
+    << a.get_coordinate().x() << "|" << a.get_coordinate().y() << "|" << a.get_coordinate().z() << "|"
+    << a.get_occupancy() << "|" << a.get_temperature_factor() << "|" << a.get_segment_ID() << "|"
+    << a.get_element() << "|" << a.get_charge() << "\n";
+}
+
+// Full description of a model, in double precision.
+string describe(pinang::Model& m)
+{
+  ostringstream o;
+  o << setprecision(17) << "MODEL " << m.get_model_serial() << " " << m.get_size() << "\n";
+  for (int c = 0; c < m.get_size(); ++c) {
+    pinang::Chain& ch = m.get_chain(c);
+    o << "CHAIN " << ch.get_chain_ID() << " " << ch.get_chain_type() << " " << ch.get_size() << "\n";
+    for (int r = 0; r < ch.get_size(); ++r) {
+      pinang::Residue& re = ch.get_residue(r);
+      o << "RESIDUE " << re.get_residue_name() << "|" << re.get_residue_serial() << "|"
+        << re.get_chain_ID() << "|" << re.get_short_name() << "|" << re.get_residue_mass() << "|"
+        << re.get_residue_charge() << "|" << re.get_sasa() << "|" << re.get_terminus_flag() << "|"
+        << re.get_chain_type() << "|" << re.get_size() << "\n";
+      for (const pinang::Atom& a : re.get_atoms())
+        describe_atom(o, a);
+      // CG beads (the getters exit if a bead is not set);
+      if (re.get_chain_type() == pinang::protein) {
+        describe_atom(o, re.get_cg_C_alpha());
+        if (re.get_residue_name().compare(0, 3, "GLY") != 0)
+          describe_atom(o, re.get_cg_C_beta());
+      }
+    }
+  }
+  return o.str();
+}
+
+string describe(pinang::PDB& pdb)
+{
+  string s;
+  for (int k = 0; k < pdb.get_size(); ++k)
+    s += describe(pdb.get_model(k));
+  return s;
+}
+
+// Two models of two protein chains, with TER and ENDMDL records.
+void write_pdb(const string& name)
+{
+  const char* atoms[] = {" N  ", " CA ", " C  ", " O  ", " CB "};
+  const char* elements[] = {"N", "C", "C", "O", "C"};
+  const char* residues[] = {"ALA", "GLY", "SER", "LYS", "ALA", "GLY", "TRP"};
+  const int n_residue[] = {4, 3};
+  const char chain_ID[] = {'A', 'B'};
+
+  ofstream f(name.c_str());
+  f << "REMARK   generated for the pinang tests\n";
+  char line[96];
+  for (int m = 0; m < 2; ++m) {
+    snprintf(line, sizeof(line), "MODEL     %4d", m + 1);
+    f << line << "\n";
+    int serial = 1;
+    int i_residue = 0;
+    for (int c = 0; c < 2; ++c) {
+      for (int r = 0; r < n_residue[c]; ++r, ++i_residue) {
+        const char* res = residues[i_residue];
+        const int n_atom = strcmp(res, "GLY") == 0 ? 4 : 5;
+        for (int i = 0; i < n_atom; ++i, ++serial) {
+          const double x = 3.8 * i_residue + 0.9 * i + 0.125 * m;
+          const double y = -1.5 * i + 0.25 * c - 0.004 * serial;
+          const double z = 0.7 * (i % 2) - 10.0 * c + 0.001 * serial;
+          snprintf(line, sizeof(line),
+                   "ATOM  %5d %4s %3s %c%4d    %8.3f%8.3f%8.3f%6.2f%6.2f          %2s",
+                   serial, atoms[i], res, chain_ID[c], r + 1, x, y, z, 1.0, 0.01 * serial,
+                   elements[i]);
+          f << line << "\n";
+        }
+      }
+      f << "TER\n";
+    }
+    f << "ENDMDL\n";
+  }
+  f << "END\n";
+}
+
+void test_decoders()
+{
+  check(pinang::decode_pdb_int("  123", 5) == 123, "decode_pdb_int");
+  check(pinang::decode_pdb_int("  -42", 5) == -42, "decode_pdb_int negative");
+  check(pinang::decode_pdb_int("12345", 3) == 123, "decode_pdb_int width");
+  check(pinang::decode_pdb_int("     ", 5) == 0, "decode_pdb_int blank");
+  check(pinang::decode_pdb_int("   - ", 5) == 0, "decode_pdb_int sign only");
+
+  check(pinang::decode_pdb_real("  12.345", 8) == 12.345, "decode_pdb_real");
+  check(pinang::decode_pdb_real(" -0.001 ", 8) == -0.001, "decode_pdb_real negative");
+  check(pinang::decode_pdb_real("-123.456", 8) == -123.456, "decode_pdb_real full width");
+  check(pinang::decode_pdb_real("  12.3456789", 8) == 12.345, "decode_pdb_real width");
+  check(pinang::decode_pdb_real("     7  ", 8) == 7.0, "decode_pdb_real integer");
+  check(pinang::decode_pdb_real("      .5", 8) == 0.5, "decode_pdb_real no integer part");
+  check(pinang::decode_pdb_real("   -.   ", 8) == 0.0, "decode_pdb_real no digit");
+  check(pinang::decode_pdb_real("        ", 8) == 0.0, "decode_pdb_real blank");
+  check(pinang::decode_pdb_real("  1.5e+2", 8) == 150.0, "decode_pdb_real exponent");
+  check(pinang::decode_pdb_real("  -25E-1", 8) == -2.5, "decode_pdb_real negative exponent");
+  check(pinang::decode_pdb_real("0.12345678901234567", 19) == 0.12345678901234567,
+        "decode_pdb_real long mantissa");
+
+  // every 3-decimal number as written by operator<<;
+  bool exact = true;
+  char field[16];
+  for (int i = -99999; i <= 99999; i += 7) {
+    snprintf(field, sizeof(field), "%8.3f", i / 1000.0);
+    exact = exact && pinang::decode_pdb_real(field, 8) == strtod(field, 0);
+  }
+  check(exact, "decode_pdb_real agrees with strtod");
+}
+
+void test_parse_line()
+{
+  pinang::Atom a;
+  char buf[96];
+  snprintf(buf, sizeof(buf), "%-6s%5d %-4s%c%3s %c%4d%c   %8.3f%8.3f%8.3f%6.2f%6.2f      %-4s%2s%2s",
+           "HETATM", 1234, " CA", 'B', "GLY", 'C', 42, 'A', -1.25, 23.5, 100.125, 0.5, 12.34,
+           "SEG1", "C", "1+");
+  const string line = buf;
+  check(pinang::parse_pdb_line(line.c_str(), line.size(), a) == pinang::pdb_hetatm, "HETATM record");
+  check(a.get_record_name() == pinang::RecordName("HETATM"), "record name");
+  check(a.get_atom_serial() == 1234, "atom serial");
+  check(a.get_atom_name() == pinang::AtomName("CA").padded(), "atom name");
+  check(a.get_alt_loc() == 'B', "alt loc");
+  check(a.get_residue_name() == pinang::ResidueName("GLY"), "residue name");
+  check(a.get_chain_ID() == 'C', "chain ID");
+  check(a.get_residue_serial() == 42, "residue serial");
+  check(a.get_icode() == 'A', "insertion code");
+  check(a.get_coordinate().x() == -1.25 && a.get_coordinate().y() == 23.5
+        && a.get_coordinate().z() == 100.125, "coordinates");
+  check(a.get_occupancy() == 0.5 && a.get_temperature_factor() == 12.34, "occupancy, B factor");
+  check(a.get_segment_ID() == pinang::SegmentName("SEG1"), "segment ID");
+  check(a.get_element() == pinang::ElementName("C"), "element");
+  check(a.get_charge() == pinang::ChargeName("1+"), "charge");
+
+  // short line, padded with spaces;
+  const string short_line = "ATOM      7  N   ALA A   3       1.000   2.000   3.000";
+  check(pinang::parse_pdb_line(short_line.c_str(), short_line.size(), a) == pinang::pdb_atom,
+        "ATOM record");
+  check(a.get_coordinate().z() == 3.0 && a.get_occupancy() == 0.0, "short ATOM line");
+
+  const string model = "MODEL       12";
+  check(pinang::parse_pdb_line(model.c_str(), model.size(), a) == pinang::pdb_model, "MODEL record");
+  check(a.get_atom_serial() == 12, "model serial");
+  check(pinang::parse_pdb_line("TER", 3, a) == pinang::pdb_ter, "TER record");
+  check(pinang::parse_pdb_line("ENDMDL", 6, a) == pinang::pdb_endmdl, "ENDMDL record");
+  check(pinang::parse_pdb_line("END", 3, a) == pinang::pdb_end, "END record");
+  check(pinang::parse_pdb_line("ENDX", 4, a) == pinang::pdb_other, "unknown record");
+  check(pinang::parse_pdb_line("REMARK   1", 10, a) == pinang::pdb_other, "REMARK record");
+}
+
+void test_round_trip(const string& name)
+{
+  pinang::PDB pdb(name);
+  check(pdb.get_size() == 2, "number of models");
+  check(pdb.get_size() > 0 && pdb.get_model(0).get_size() == 2, "number of chains");
+  check(pdb.get_size() > 0 && pdb.get_model(0).get_chain(0).get_size() == 4, "number of residues");
+
+  const string name_out = "t_pdb_test_out.pdb";
+  {
+    ofstream out(name_out.c_str());
+    out << pdb;
+  }
+  pinang::PDB pdb_out(name_out);
+  check(describe(pdb) == describe(pdb_out), "PDB written and read again");
+  remove(name_out.c_str());
+}
+
+void test_cache(const string& name)
+{
+  const string cache = pinang::PDBCache::get_sidecar_name(name);
+  check(cache == "t_pdb_test.pdbcache", "cache file name");
+  check(pinang::PDBCache::get_sidecar_name("abc") == "abc.pdbcache", "cache file name without .pdb");
+  remove(cache.c_str());
+
+  pinang::PDB pdb(name);
+  const string ref = describe(pdb);
+  pinang::PDB pdb_loaded = pinang::PDB::load_cached(name);
+  check(describe(pdb_loaded) == ref, "load_cached without cache");
+  check(ifstream(cache.c_str()).good(), "load_cached writes cache");
+  pinang::PDB pdb_cached = pinang::PDB::load_cached(name);
+  check(describe(pdb_cached) == ref, "load_cached from cache");
+  check(pdb_cached.get_pdb_name() == name, "cached PDB name");
+
+  // PDBCache::write / read;
+  std::int64_t size = 0;
+  std::int64_t mtime = 0;
+  check(pinang::PDBCache::get_stamp(name, size, mtime) == 0, "get_stamp");
+  check(pinang::PDBCache::get_stamp("t_pdb_test_missing.pdb", size, mtime) != 0,
+        "get_stamp of missing file");
+  pinang::PDBCache::get_stamp(name, size, mtime);
+  check(pinang::PDBCache::write(name, pdb, size, mtime) == 0, "PDBCache write");
+  pinang::PDB pdb_read = pinang::PDB::load_cached(name);
+  check(pinang::PDBCache::read(name, pdb_read) == 0, "PDBCache read");
+  check(describe(pdb_read) == ref, "PDBCache round trip");
+
+  // cache of an older version of the PDB file;
+  check(pinang::PDBCache::write(name, pdb, size - 1, mtime) == 0, "PDBCache write (stale)");
+  check(pinang::PDBCache::read(name, pdb_read) != 0, "PDBCache rejects stale cache");
+
+  // damaged cache;
+  check(pinang::PDBCache::write(name, pdb, size, mtime) == 0, "PDBCache write");
+  {
+    fstream f(cache.c_str(), ios::in | ios::out | ios::binary);
+    f.seekg(0, ios::end);
+    const long n = f.tellg();
+    char c = 0;
+    f.seekg(n / 2);
+    f.read(&c, 1);
+    c ^= 0x20;
+    f.seekp(n / 2);
+    f.write(&c, 1);
+  }
+  check(pinang::PDBCache::read(name, pdb_read) != 0, "PDBCache rejects damaged cache");
+  pinang::PDB pdb_rebuilt = pinang::PDB::load_cached(name);
+  check(describe(pdb_rebuilt) == ref, "load_cached with damaged cache");
+  check(pinang::PDBCache::read(name, pdb_read) == 0, "load_cached rewrites damaged cache");
+
+  // changed PDB file;
+  {
+    ofstream f(name.c_str(), ios::app);
+    f << "REMARK   appended\n";
+  }
+  check(pinang::PDBCache::read(name, pdb_read) != 0, "PDBCache rejects cache of changed file");
+  remove(cache.c_str());
+}
+
+void test_system(const string& name)
+{
+  pinang::PDB pdb(name);
+  for (int k = 0; k < pdb.get_size(); ++k) {
+    pinang::Model& mdl = pdb.get_model(k);
+    const string ref = describe(mdl);
+    ostringstream tag;
+    tag << ", model " << k;
+
+    pinang::System sys(mdl);
+    check(sys.get_chain_number() == mdl.get_size(), "System chains" + tag.str());
+    int n_residue = 0;
+    int n_atom = 0;
+    for (int c = 0; c < mdl.get_size(); ++c) {
+      n_residue += mdl.get_chain(c).get_size();
+      for (int r = 0; r < mdl.get_chain(c).get_size(); ++r)
+        n_atom += mdl.get_chain(c).get_residue(r).get_size();
+    }
+    check(sys.get_residue_number() == n_residue, "System residues" + tag.str());
+    check(sys.get_atom_number() == n_atom, "System atoms" + tag.str());
+    bool views_ok = true;
+    for (int i = 0; i < sys.get_atom_number(); ++i) {
+      pinang::AtomView a = sys.get_atom(i);
+      pinang::ResidueView r = a.get_residue();
+      views_ok = views_ok && i >= r.get_atom_offset() && i < r.get_atom_offset() + r.get_size()
+                 && r.get_chain().get_index() == sys.get_atom_chain(i);
+    }
+    check(views_ok, "System views" + tag.str());
+
+    pinang::Model m = sys.get_model();
+    check(describe(m) == ref, "System(Model).get_model()" + tag.str());
+
+    pinang::System sys_set;
+    sys_set.set_model(pdb.get_model(1 - k));
+    sys_set.set_model(mdl);
+    m = sys_set.get_model();
+    check(describe(m) == ref, "System::set_model()" + tag.str());
+
+    pinang::System sys_read;
+    check(sys_read.read_pdb(name, k) == 0, "System::read_pdb()" + tag.str());
+    m = sys_read.get_model();
+    check(describe(m) == ref, "System::read_pdb().get_model()" + tag.str());
+  }
+  pinang::System sys;
+  check(sys.read_pdb(name, pdb.get_size()) != 0, "System::read_pdb() of missing model");
+}
+
+}
+
+int main()
+{
+  test_decoders();
+  test_parse_line();
+
+  const string name = "t_pdb_test.pdb";
+  write_pdb(name);
+  test_round_trip(name);
+  test_system(name);
+  test_cache(name);
+  remove(name.c_str());
+
+  return pinang_test::report("pdb");
+}
@@ -0,0 +1,164 @@
+/*!
+  @file test_util.hpp
+  @brief Helpers shared by the test programs.
+
+  Checks are counted instead of aborting, so that one run reports every failed
+  check; report() gives the exit status of the test program.  Random
+  trajectories are generated and written as dcd files by the tests
+  themselves, so no data files are needed.
+
+  @author Cheng Tan (noinil@gmail.com)
+  @date 2026-10-17 15:52
+  @copyright GNU Public License V3.0
+*/
+
+#ifndef PINANG_TEST_UTIL_H_
+#define PINANG_TEST_UTIL_H_
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "vec3d.hpp"
+
+namespace pinang_test {
+
+//! @brief Get number of failed checks.
+inline int& failures()
+{
+  static int n = 0;
+  return n;
+}
+
+//! @brief Check a condition.
+//! @param Condition.
+//! @param Description of the check.
+inline void check(bool ok, const std::string& what)
+{
+  if (!ok) {
+    std::cerr << " FAILED: " << what << "\n";
+    ++failures();
+  }
+}
+
+//! @brief Check that two numbers agree within a tolerance.
+//! @param Value.
+//! @param Expected value.
+//! @param Tolerance.
+//! @param Description of the check.
+inline void check_near(double a, double b, double tol, const std::string& what)
+{
+  if (!(std::fabs(a - b) <= tol)) {
+    std::cerr << " FAILED: " << what << ": " << a << " != " << b << "\n";
+    ++failures();
+  }
+}
+
+//! @brief Print the summary of a test program.
+//! @param Name of the test program.
+//! @return Exit status (0 if all checks passed).
+inline int report(const std::string& name)
+{
+  if (failures() == 0) {
+    std::cout << " " << name << ": OK" << "\n";
+    return 0;
+  }
+  std::cout << " " << name << ": " << failures() << " check(s) FAILED" << "\n";
+  return 1;
+}
+
+//! @brief Generate frames fluctuating around a random structure.
+//! @param Number of frames.
+//! @param Number of particles.
+//! @param Seed of random numbers.
+//! @return Coordinates of every frame.
+inline std::vector<std::vector<pinang::Vec3d> > random_frames(int n_frame, int n_atom,
+                                                              unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> box(-20.0, 20.0);
+  std::vector<pinang::Vec3d> base(n_atom);
+  for (pinang::Vec3d& v : base)
+    v = pinang::Vec3d(box(rng), box(rng), box(rng));
+
+  std::vector<std::vector<pinang::Vec3d> > frames(n_frame, base);
+  for (int k = 0; k < n_frame; ++k) {
+    std::normal_distribution<double> noise(0.0, 0.5 + 0.3 * (k % 5));
+    for (pinang::Vec3d& v : frames[k])
+      v += pinang::Vec3d(noise(rng), noise(rng), noise(rng));
+  }
+  return frames;
+}
+
+//! @brief Write frames as a dcd file (CafeMol / CHARMM layout, no unit cell).
+//!
+//! Coordinates are stored in single precision, so they are rounded to float
+//! in place.
+//! @param DCD file name.
+//! @param Coordinates of every frame (rounded to float on return).
+//! @param Number of bytes of an extra, truncated frame (0 for none).
+inline void write_dcd(const std::string& name, std::vector<std::vector<pinang::Vec3d> >& frames,
+                      int truncated_bytes)
+{
+  std::ofstream f(name.c_str(), std::ofstream::binary);
+  auto put_int = [&f](std::int32_t i) { f.write(reinterpret_cast<const char*>(&i), 4); };
+  auto put_float = [&f](float x) { f.write(reinterpret_cast<const char*>(&x), 4); };
+
+  const int n_frame = frames.size();
+  const int n_atom = n_frame ? frames[0].size() : 0;
+  // control block: NSET, ISTART, NSAVC, NSTEP, NUNIT, 3 empty, NFREAT, DELTA,
+  // unit cell flag, 8 empty, version;
+  put_int(84);
+  f.write("CORD", 4);
+  put_int(n_frame);
+  put_int(0);
+  put_int(10);
+  put_int(n_frame * 10);
+  for (int i = 0; i < 5; ++i)
+    put_int(0);
+  put_float(0.1f);
+  for (int i = 0; i < 9; ++i)
+    put_int(0);
+  put_int(24);
+  put_int(84);
+  // title block;
+  const std::string title(80, 'T');
+  put_int(4 + 80);
+  put_int(1);
+  f.write(title.data(), 80);
+  put_int(4 + 80);
+  // number of atoms;
+  put_int(4);
+  put_int(n_atom);
+  put_int(4);
+
+  std::vector<float> xyz[3];
+  for (std::vector<pinang::Vec3d>& frame : frames) {
+    for (int d = 0; d < 3; ++d)
+      xyz[d].resize(n_atom);
+    for (int i = 0; i < n_atom; ++i) {
+      xyz[0][i] = frame[i].x();
+      xyz[1][i] = frame[i].y();
+      xyz[2][i] = frame[i].z();
+      frame[i] = pinang::Vec3d(xyz[0][i], xyz[1][i], xyz[2][i]);
+    }
+    for (int d = 0; d < 3; ++d) {
+      put_int(4 * n_atom);
+      for (float x : xyz[d])
+        put_float(x);
+      put_int(4 * n_atom);
+    }
+  }
+  if (truncated_bytes > 0) {
+    put_int(4 * n_atom);
+    const std::string partial(truncated_bytes, '\0');
+    f.write(partial.data(), truncated_bytes);
+  }
+}
+
+}
+
+#endif